@@ -2,7 +2,7 @@
     !android: error("Building Charm with QMake is not supported, and used only for Qt/Android experiments. For everything else, please use the CMake build system.")
 }
 
-QT += core gui xml sql network widgets qml quick
+QT += core gui xml sql network widgets qml quick concurrent
 
 INCLUDEPATH += Core/
 INCLUDEPATH += Charm/
@@ -19,7 +19,6 @@ SOURCES += $$files(Core/*.cpp)
 SOURCES += \
     Charm/ApplicationCore.cpp \
     Charm/Data.cpp \
-    Charm/EventModelAdapter.cpp \
     Charm/EventModelFilter.cpp \
     Charm/GUIState.cpp \
     Charm/ModelConnector.cpp \
@@ -43,8 +42,13 @@ SOURCES += \
     Charm/HttpClient/GetProjectCodesJob.cpp \
     Charm/HttpClient/UploadTimesheetJob.cpp \
     Charm/Idle/IdleDetector.cpp \
+    Charm/Reports/HtmlReportWriter.cpp \
     Charm/Reports/MonthlyTimesheetXmlWriter.cpp \
+    Charm/Reports/ReportGenerator.cpp \
+    Charm/Reports/TaskPivot.cpp \
     Charm/Reports/TimesheetInfo.cpp \
+    Charm/Reports/TimesheetXml.cpp \
+    Charm/Reports/WeeklyTimesheetBatch.cpp \
     Charm/Reports/WeeklyTimesheetXmlWriter.cpp \
     Charm/Widgets/ActivityReport.cpp \
     Charm/Widgets/BillDialog.cpp \
@@ -63,6 +67,8 @@ SOURCES += \
     Charm/Widgets/MessageBox.cpp \
     Charm/Widgets/MonthlyTimesheet.cpp \
     Charm/Widgets/MonthlyTimesheetConfigurationDialog.cpp \
+    Charm/Widgets/PeriodTimesheet.cpp \
+    Charm/Widgets/PeriodTimesheetConfigurationDialog.cpp \
     Charm/Widgets/ReportConfigurationDialog.cpp \
     Charm/Widgets/ReportPreviewWindow.cpp \
     Charm/Widgets/SelectTaskDialog.cpp \
@@ -87,7 +93,6 @@ HEADERS += $$files(Core/*.h)
 
 HEADERS += \
     Charm/MakeTemporarilyVisible.h \
-    Charm/EventModelAdapter.h \
     Charm/EventModelFilter.h \
     Charm/Idle/IdleDetector.h \
     Charm/Uniquifier.h \
@@ -95,9 +100,14 @@ HEADERS += \
     Charm/GUIState.h \
     Charm/UndoCharmCommandWrapper.h \
     Charm/ViewFilter.h \
+    Charm/Reports/HtmlReportWriter.h \
     Charm/Reports/MonthlyTimesheetXmlWriter.h \
+    Charm/Reports/ReportGenerator.h \
+    Charm/Reports/TaskPivot.h \
     Charm/Reports/TimesheetInfo.h \
+    Charm/Reports/TimesheetXml.h \
     Charm/Reports/WeeklyTimesheetXmlWriter.h \
+    Charm/Reports/WeeklyTimesheetBatch.h \
     Charm/Widgets/TasksViewDelegate.h \
     Charm/Widgets/IdleCorrectionDialog.h \
     Charm/Widgets/Timesheet.h \
@@ -122,6 +132,8 @@ HEADERS += \
     Charm/Widgets/ExpandStatesHelper.h \
     Charm/Widgets/SelectTaskDialog.h \
     Charm/Widgets/MonthlyTimesheet.h \
+    Charm/Widgets/PeriodTimesheet.h \
+    Charm/Widgets/PeriodTimesheetConfigurationDialog.h \
     Charm/Widgets/EventView.h \
     Charm/Widgets/ConfigurationDialog.h \
     Charm/Widgets/HttpJobProgressDialog.h \
@@ -87,6 +87,8 @@ ApplicationCore::ApplicationCore(TaskId startupTask, QObject* parent )
     , m_actionActivityReport( this )
     , m_actionWeeklyTimesheetReport( this )
     , m_actionMonthlyTimesheetReport( this )
+    , m_actionQuarterlyTimesheetReport( this )
+    , m_actionYearlyTimesheetReport( this )
     , m_uiElements( { &m_timeTracker, &m_tasksView, &m_eventView } )
     , m_startupTask( startupTask )
 #ifdef Q_OS_WIN
@@ -260,6 +262,12 @@ ApplicationCore::ApplicationCore(TaskId startupTask, QObject* parent )
     m_actionMonthlyTimesheetReport.setShortcut( Qt::CTRL + Qt::Key_M );
     connect( &m_actionMonthlyTimesheetReport, SIGNAL(triggered()),
              &mainView(), SLOT(slotMonthlyTimesheetReport()) );
+    m_actionQuarterlyTimesheetReport.setText( tr( "Quarterly Timesheet...") );
+    connect( &m_actionQuarterlyTimesheetReport, SIGNAL(triggered()),
+             &mainView(), SLOT(slotQuarterlyTimesheetReport()) );
+    m_actionYearlyTimesheetReport.setText( tr( "Yearly Timesheet...") );
+    connect( &m_actionYearlyTimesheetReport, SIGNAL(triggered()),
+             &mainView(), SLOT(slotYearlyTimesheetReport()) );
 
     // set up idle detection
     m_idleDetector = IdleDetector::createIdleDetector( this );
@@ -346,6 +354,8 @@ void ApplicationCore::createWindowMenu( QMenuBar *menuBar )
     menu->addAction( &m_actionActivityReport );
     menu->addAction( &m_actionWeeklyTimesheetReport );
     menu->addAction( &m_actionMonthlyTimesheetReport );
+    menu->addAction( &m_actionQuarterlyTimesheetReport );
+    menu->addAction( &m_actionYearlyTimesheetReport );
 #ifndef Q_OS_OSX
     menu->addSeparator();
 #endif
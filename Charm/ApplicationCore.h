@@ -164,6 +164,8 @@ private:
     QAction m_actionActivityReport;
     QAction m_actionWeeklyTimesheetReport;
     QAction m_actionMonthlyTimesheetReport;
+    QAction m_actionQuarterlyTimesheetReport;
+    QAction m_actionYearlyTimesheetReport;
     EventView m_eventView;
     TasksView m_tasksView;
     QVector<UIStateInterface*> m_uiElements;
@@ -53,6 +53,7 @@ public: /* CharmDataModelAdapterInterface */
     void taskAboutToBeAdded( TaskId, int ) {};
     void taskAdded( TaskId );
     void taskModified( TaskId );
+    void taskParentAboutToChange( TaskId, TaskId, TaskId ) {};
     void taskParentChanged( TaskId, TaskId, TaskId ) {};
     void taskAboutToBeDeleted( TaskId ) {};
     void taskDeleted( TaskId ) {};
@@ -63,6 +64,9 @@ public: /* CharmDataModelAdapterInterface */
     void eventModified( EventId id, Event discardedEvent ) {};
     void eventAboutToBeDeleted( EventId id ) {};
     void eventDeleted( EventId id ) {};
+    void eventsAdded( const EventIdList& ids ) {};
+    void eventsModified( const EventIdList& ids ) {};
+    void eventsDeleted( const EventIdList& ids ) {};
 
     void eventActivated( EventId id );
     void eventDeactivated( EventId id );
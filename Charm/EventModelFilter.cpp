@@ -24,62 +24,81 @@
 
 #include "EventModelFilter.h"
 
+#include "Core/CharmCommand.h"
+#include "Core/CharmDataModel.h"
+
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+
 EventModelFilter::EventModelFilter( CharmDataModel* model, QObject* parent )
-    : QSortFilterProxyModel( parent )
-    , m_model( model )
+    : QAbstractListModel( parent )
+    , m_dataModel( model )
 {
-    setSourceModel( &m_model );
-    setDynamicSortFilter( true );
-    sort( 0, Qt::AscendingOrder );
-
-    connect( &m_model, SIGNAL(eventActivationNotice(EventId)),
-             SIGNAL(eventActivationNotice(EventId)) );
-    connect( &m_model, SIGNAL(eventDeactivationNotice(EventId)),
-             SIGNAL(eventDeactivationNotice(EventId)) );
+    m_dataModel->registerAdapter( this );
 }
 
 EventModelFilter::~EventModelFilter()
 {
+    if ( m_dataModel ) {
+        m_dataModel->unregisterAdapter( this );
+    }
 }
 
-void EventModelFilter::commitCommand( CharmCommand* command )
+int EventModelFilter::rowCount( const QModelIndex& parent ) const
 {
-    m_model.commitCommand( command );
+    if ( parent.isValid() )
+        return 0;
+    return m_rows.size();
 }
 
-bool EventModelFilter::lessThan( const QModelIndex& left, const QModelIndex& right ) const
+QVariant EventModelFilter::data( const QModelIndex& index, int role ) const
 {
-    if ( left.column() == 0 && right.column() == 0 ) {
-        const Event& leftEvent = m_model.eventForIndex( left );
-        const Event& rightEvent = m_model.eventForIndex( right );
-        // date comparison in UTC is much faster and just as correct
-        return leftEvent.startDateTime(Qt::UTC) < rightEvent.startDateTime(Qt::UTC);
-    } else {
-        return QSortFilterProxyModel::lessThan( left, right );
+    if ( !index.isValid() || index.row() < 0 || index.row() >= m_rows.size() )
+        return QVariant(); // beware of stale persistent indexes
+
+    switch ( role ) {
+    case Qt::DisplayRole:
+    {
+        const Event& event = m_dataModel->eventForId( m_rows[index.row()] );
+
+        QString text;
+        QTextStream stream( &text );
+        stream << event.taskId() << " - " << event.comment();
+
+        return text;
+    }
+    break;
+
+    default:
+        return QVariant();
     }
 }
 
+void EventModelFilter::commitCommand( CharmCommand* command )
+{
+    command->finalize();
+}
+
 const Event& EventModelFilter::eventForIndex( const QModelIndex& index ) const
 {
-    return m_model.eventForIndex( mapToSource( index ) );
+    if ( index.isValid() && index.row() >= 0 && index.row() < m_rows.size() ) {
+        return m_dataModel->eventForId( m_rows.at( index.row() ) );
+    } else {
+        static Event InvalidEvent;
+        return InvalidEvent;
+    }
 }
 
 QModelIndex EventModelFilter::indexForEvent( const Event& event ) const
 {
-    const QModelIndex& sourceIndex = m_model.indexForEvent( event );
-    const QModelIndex& proxyIndex( mapFromSource( sourceIndex ) );
-    // bool valid = proxyIndex.isValid();
-    return proxyIndex;
+    const int row = rowForEvent( event.id() );
+    return row >= 0 ? index( row ) : QModelIndex();
 }
 
-bool EventModelFilter::filterAcceptsRow( int srow, const QModelIndex& sparent ) const
+bool EventModelFilter::accepts( const Event& event ) const
 {
-    if ( QSortFilterProxyModel::filterAcceptsRow( srow, sparent ) == false ) {
-        return false;
-    }
-
-    const Event& event = m_model.eventForIndex( m_model.index( srow, 0, sparent ) );
-
     if ( m_filterId != TaskId() && event.taskId() != m_filterId ) {
         return false;
     }
@@ -102,18 +121,21 @@ bool EventModelFilter::filterAcceptsRow( int srow, const QModelIndex& sparent )
 
 void EventModelFilter::setFilterStartDate( const QDate& date )
 {
-    if ( m_start == date )
-        return;
-    m_start = date;
-    invalidateFilter();
+    setFilterDates( date, m_end );
 }
 
 void EventModelFilter::setFilterEndDate( const QDate& date )
 {
-    if ( m_end == date )
+    setFilterDates( m_start, date );
+}
+
+void EventModelFilter::setFilterDates( const QDate& start, const QDate& end )
+{
+    if ( m_start == start && m_end == end )
         return;
-    m_end = date;
-    invalidateFilter();
+    m_start = start;
+    m_end = end;
+    rebuild( false );
 }
 
 void EventModelFilter::setFilterTaskId( TaskId id )
@@ -121,33 +143,272 @@ void EventModelFilter::setFilterTaskId( TaskId id )
     if ( m_filterId == id )
         return;
     m_filterId = id;
-    invalidateFilter();
+    rebuild( false );
 }
 
 int EventModelFilter::totalDuration() const
 {
-    int total = 0;
-    for ( int i = 0; i < rowCount(); ++i )
-    {
-        QModelIndex current = index( i, 0, QModelIndex() );
-        const Event& event = eventForIndex( current );
-        total += event.duration();
-    }
-    return total;
+    return m_totalDuration;
 }
 
 QList<Event> EventModelFilter::events() const
 {
     QList<Event> events;
-    for ( int i = 0; i < rowCount(); ++i )
-    {
-        QModelIndex hit = index( i, 0, QModelIndex() );
-        const Event& event = eventForIndex( hit );
-        events << event;
-    }
+    events.reserve( m_rows.size() );
+    Q_FOREACH( EventId id, m_rows )
+        events << m_dataModel->eventForId( id );
     return events;
 }
 
+void EventModelFilter::rebuild( bool reset )
+{
+    EventIdList rows;
+    QHash<EventId, QDateTime> starts;
+    QHash<EventId, int> durations;
+    int total = 0;
+    if ( m_dataModel ) {
+        // events that start before the time frame are shown if they end in it:
+        const EventTimeIndex& timeIndex = m_dataModel->eventTimeIndex();
+        const QDate first = m_start.isValid()
+            ? m_start.addDays( -timeIndex.longestSpanInDays() ) : m_start;
+        Q_FOREACH( EventId id, timeIndex.eventsStartingBetween( first, m_end ) ) {
+            const Event& event = m_dataModel->eventForId( id );
+            if ( accepts( event ) ) {
+                rows.append( id );
+                starts.insert( id, event.startDateTime( Qt::UTC ) );
+                durations.insert( id, event.duration() );
+                total += event.duration();
+            }
+        }
+        sortRows( rows, starts );
+    }
 
-#include "moc_EventModelFilter.cpp"
+    if ( reset ) {
+        beginResetModel();
+        m_rows = rows;
+        m_rowOfEvent.clear();
+        m_validRows = 0;
+        m_starts = starts;
+        m_durations = durations;
+        m_totalDuration = total;
+        endResetModel();
+        return;
+    }
+
+    emit layoutAboutToBeChanged();
+    const QModelIndexList from = persistentIndexList();
+    EventIdList ids;
+    ids.reserve( from.size() );
+    Q_FOREACH( const QModelIndex& index, from )
+        ids.append( m_rows.value( index.row() ) );
+    m_rows = rows;
+    m_rowOfEvent.clear();
+    m_validRows = 0;
+    m_starts = starts;
+    m_durations = durations;
+    m_totalDuration = total;
+    QModelIndexList to;
+    to.reserve( from.size() );
+    Q_FOREACH( EventId id, ids ) {
+        const int row = rowForEvent( id );
+        to.append( row >= 0 ? index( row ) : QModelIndex() );
+    }
+    changePersistentIndexList( from, to );
+    emit layoutChanged();
+}
+
+void EventModelFilter::sortRows( EventIdList& rows, const QHash<EventId, QDateTime>& starts ) const
+{
+    // date comparison in UTC is much faster and just as correct
+    std::sort( rows.begin(), rows.end(), [&starts]( EventId left, EventId right ) {
+        const QDateTime leftStart = starts.value( left );
+        const QDateTime rightStart = starts.value( right );
+        return leftStart < rightStart || ( leftStart == rightStart && left < right );
+    } );
+}
+
+int EventModelFilter::insertPosition( const QDateTime& start, EventId id ) const
+{
+    const auto it = std::lower_bound( m_rows.begin(), m_rows.end(), id,
+        [this, &start]( EventId row, EventId key ) {
+            const QDateTime rowStart = m_starts.value( row );
+            return rowStart < start || ( rowStart == start && row < key );
+        } );
+    return int( it - m_rows.begin() );
+}
+
+int EventModelFilter::rowForEvent( EventId id ) const
+{
+    if ( !m_starts.contains( id ) )
+        return -1;
+    const auto it = m_rowOfEvent.constFind( id );
+    if ( it != m_rowOfEvent.constEnd() && it.value() < m_validRows )
+        return it.value();
+    // rows have been inserted or removed above this one, renumber the rest:
+    for ( int row = m_validRows; row < m_rows.size(); ++row )
+        m_rowOfEvent[m_rows[row]] = row;
+    m_validRows = m_rows.size();
+    const int row = m_rowOfEvent.value( id, -1 );
+    Q_ASSERT( row >= 0 && row < m_rows.size() && m_rows[row] == id ); // inconsistency between filter and model
+    return row;
+}
+
+void EventModelFilter::invalidateRowsFrom( int row )
+{
+    m_validRows = qMin( m_validRows, row );
+}
+
+void EventModelFilter::insertEvent( const Event& event )
+{
+    const QDateTime start = event.startDateTime( Qt::UTC );
+    const int row = insertPosition( start, event.id() );
+    beginInsertRows( QModelIndex(), row, row );
+    m_rows.insert( row, event.id() );
+    invalidateRowsFrom( row );
+    m_starts.insert( event.id(), start );
+    m_durations.insert( event.id(), event.duration() );
+    m_totalDuration += event.duration();
+    endInsertRows();
+}
+
+void EventModelFilter::removeEvent( EventId id )
+{
+    const int row = rowForEvent( id );
+    Q_ASSERT( row != -1 );
+    beginRemoveRows( QModelIndex(), row, row );
+    m_rows.removeAt( row );
+    m_rowOfEvent.remove( id );
+    invalidateRowsFrom( row );
+    m_starts.remove( id );
+    m_totalDuration -= m_durations.take( id );
+    endRemoveRows();
+}
+
+void EventModelFilter::updateEvent( const Event& event )
+{
+    const bool shown = m_starts.contains( event.id() );
+    const bool accepted = accepts( event );
+    if ( !shown ) {
+        if ( accepted )
+            insertEvent( event );
+        return;
+    }
+    if ( !accepted ) {
+        removeEvent( event.id() );
+        return;
+    }
+
+    // the total is updated before the views learn about the change:
+    int& duration = m_durations[event.id()];
+    m_totalDuration += event.duration() - duration;
+    duration = event.duration();
+
+    int row = rowForEvent( event.id() );
+    const QDateTime start = event.startDateTime( Qt::UTC );
+    if ( m_starts.value( event.id() ) != start ) {
+        // find the new position among the other rows:
+        m_rows.removeAt( row );
+        const int newRow = insertPosition( start, event.id() );
+        m_rows.insert( row, event.id() );
+        if ( newRow != row ) {
+            beginMoveRows( QModelIndex(), row, row, QModelIndex(), newRow > row ? newRow + 1 : newRow );
+            m_rows.removeAt( row );
+            m_rows.insert( newRow, event.id() );
+            invalidateRowsFrom( qMin( row, newRow ) );
+            m_starts.insert( event.id(), start );
+            endMoveRows();
+            row = newRow;
+        } else {
+            m_starts.insert( event.id(), start );
+        }
+    }
+    emit dataChanged( index( row ), index( row ) );
+}
+
+void EventModelFilter::resetEvents()
+{
+    rebuild( true );
+}
+
+void EventModelFilter::eventAdded( EventId id )
+{
+    updateEvent( m_dataModel->eventForId( id ) );
+}
+
+void EventModelFilter::eventModified( EventId id, Event )
+{
+    updateEvent( m_dataModel->eventForId( id ) );
+}
 
+void EventModelFilter::eventAboutToBeDeleted( EventId id )
+{
+    if ( m_starts.contains( id ) )
+        removeEvent( id );
+}
+
+void EventModelFilter::eventsAdded( const EventIdList& ids )
+{
+    // many single insertions cost more than collecting the time frame again:
+    if ( ids.size() > qMax( 16, m_rows.size() ) ) {
+        rebuild( true );
+        return;
+    }
+    Q_FOREACH( EventId id, ids )
+        updateEvent( m_dataModel->eventForId( id ) );
+}
+
+void EventModelFilter::eventsModified( const EventIdList& ids )
+{
+    if ( ids.size() > qMax( 16, m_rows.size() ) ) {
+        rebuild( true );
+        return;
+    }
+    Q_FOREACH( EventId id, ids )
+        updateEvent( m_dataModel->eventForId( id ) );
+}
+
+void EventModelFilter::eventsDeleted( const EventIdList& ids )
+{
+    // the events are gone, the stored start times still find the rows:
+    QVector<int> rows;
+    rows.reserve( ids.size() );
+    Q_FOREACH( EventId id, ids ) {
+        if ( m_starts.contains( id ) )
+            rows.append( rowForEvent( id ) );
+    }
+    std::sort( rows.begin(), rows.end() );
+
+    // one removal per range of adjacent rows, starting at the bottom so
+    // the rows of the ranges above stay valid:
+    int last = rows.size() - 1;
+    while ( last >= 0 ) {
+        int first = last;
+        while ( first > 0 && rows.at( first - 1 ) == rows.at( first ) - 1 )
+            --first;
+        const int firstRow = rows.at( first );
+        const int lastRow = rows.at( last );
+        beginRemoveRows( QModelIndex(), firstRow, lastRow );
+        for ( int row = firstRow; row <= lastRow; ++row ) {
+            const EventId id = m_rows.at( row );
+            m_rowOfEvent.remove( id );
+            m_starts.remove( id );
+            m_totalDuration -= m_durations.take( id );
+        }
+        m_rows.erase( m_rows.begin() + firstRow, m_rows.begin() + lastRow + 1 );
+        invalidateRowsFrom( firstRow );
+        endRemoveRows();
+        last = first - 1;
+    }
+}
+
+void EventModelFilter::eventActivated( EventId id )
+{
+    emit eventActivationNotice( id );
+}
+
+void EventModelFilter::eventDeactivated( EventId id )
+{
+    emit eventDeactivationNotice( id );
+}
+
+#include "moc_EventModelFilter.cpp"
@@ -25,17 +25,27 @@
 #ifndef EVENTMODELFILTER_H
 #define EVENTMODELFILTER_H
 
+#include <QAbstractListModel>
 #include <QDate>
-#include <QSortFilterProxyModel>
+#include <QDateTime>
+#include <QHash>
+#include <QPointer>
 
+#include <Core/Event.h>
 #include <Core/EventModelInterface.h>
+#include <Core/CharmDataModelAdapterInterface.h>
 #include <Core/CommandEmitterInterface.h>
 
-#include "EventModelAdapter.h"
-
 class CharmDataModel;
 
-class EventModelFilter : public QSortFilterProxyModel,
+/** EventModelFilter exposes the events in a time frame, optionally only
+    those of one task, sorted by their start time.
+    The events are looked up in the time index of the data model, so
+    changing the time frame or the task costs time proportional to the
+    events in the frame, not to the whole history. Changes to the events
+    are applied as single row insertions, removals and moves. */
+class EventModelFilter : public QAbstractListModel,
+                         public CharmDataModelAdapterInterface,
                          public CommandEmitterInterface,
                          public EventModelInterface
 {
@@ -45,33 +55,85 @@ public:
     explicit EventModelFilter( CharmDataModel*, QObject* parent = nullptr );
     ~EventModelFilter() override;
 
-    /** Returns the total number of seconds of all events in the model. */
+    int rowCount( const QModelIndex& parent = QModelIndex() ) const override;
+
+    QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+
+    /** Returns the total number of seconds of all events in the model.
+        The total is maintained while the events change. */
     int totalDuration() const;
 
     // implement EventModelInterface:
     const Event& eventForIndex( const QModelIndex& ) const override;
     QModelIndex indexForEvent( const Event& ) const override;
 
-    bool filterAcceptsRow( int srow, const QModelIndex & sparent ) const override;
-
     void setFilterStartDate( const QDate& date );
     void setFilterEndDate( const QDate& date );
+    /** Sets start and end date at once, avoiding the intermediate time frame. */
+    void setFilterDates( const QDate& start, const QDate& end );
     void setFilterTaskId( TaskId id );
 
     // implement CommandEmitterInterface:
     void commitCommand( CharmCommand* ) override;
 
-    // implement to sort by event start datetime
-    bool lessThan( const QModelIndex& left, const QModelIndex& right ) const override;
-
     QList<Event> events() const;
 
+    // implement CharmDataModelAdapterInterface:
+    void resetTasks() override {}
+    void taskAboutToBeAdded( TaskId, int ) override {}
+    void taskAdded( TaskId ) override {}
+    void taskModified( TaskId ) override {}
+    void taskParentAboutToChange( TaskId, TaskId, TaskId ) override {}
+    void taskParentChanged( TaskId, TaskId, TaskId ) override {}
+    void taskAboutToBeDeleted( TaskId ) override {}
+    void taskDeleted( TaskId ) override {}
+
+    void resetEvents() override;
+    void eventAboutToBeAdded( EventId ) override {}
+    void eventAdded( EventId id ) override;
+    void eventModified( EventId id, Event ) override;
+    void eventAboutToBeDeleted( EventId id ) override;
+    void eventDeleted( EventId ) override {}
+    void eventsAdded( const EventIdList& ids ) override;
+    void eventsModified( const EventIdList& ids ) override;
+    void eventsDeleted( const EventIdList& ids ) override;
+
+    void eventActivated( EventId id ) override;
+    void eventDeactivated( EventId id ) override;
+
 Q_SIGNALS:
     void eventActivationNotice( EventId id );
     void eventDeactivationNotice( EventId id );
 
 private:
-    EventModelAdapter m_model;
+    bool accepts( const Event& event ) const;
+    /** Collects the events in the time frame. A reset is used if the
+        events changed, otherwise the layout change keeps the persistent
+        indexes (and the selection) of the remaining events. */
+    void rebuild( bool reset );
+    void sortRows( EventIdList& rows, const QHash<EventId, QDateTime>& starts ) const;
+    /** Returns the row of the event, or -1 if it is not in the model. */
+    int rowForEvent( EventId id ) const;
+    /** Marks the row positions from @p row onwards as stale. */
+    void invalidateRowsFrom( int row );
+    int insertPosition( const QDateTime& start, EventId id ) const;
+    void updateEvent( const Event& event );
+    void insertEvent( const Event& event );
+    void removeEvent( EventId id );
+
+    QPointer<CharmDataModel> m_dataModel;
+    /** The events in the time frame, sorted by start time and id. */
+    EventIdList m_rows;
+    /** The start time (UTC) of every event in m_rows, as sorted by. */
+    QHash<EventId, QDateTime> m_starts;
+    /** The row of every event in m_rows. Insertions and removals shift
+        the rows below them, so only entries for the first m_validRows rows
+        are known to be correct, the rest are fixed up on the next lookup. */
+    mutable QHash<EventId, int> m_rowOfEvent;
+    mutable int m_validRows = 0;
+    /** The duration of every event in m_rows, as added to m_totalDuration. */
+    QHash<EventId, int> m_durations;
+    int m_totalDuration = 0;
     QDate m_start;
     QDate m_end;
     TaskId m_filterId = {};
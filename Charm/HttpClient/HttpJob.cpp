@@ -160,6 +160,12 @@ void HttpJob::doStart()
         return;
     }
 
+    /* a password set on the job takes precedence over the keychain */
+    if (!m_password.isEmpty()) {
+        passwordWritten();
+        return;
+    }
+
     auto readJob = new ReadPasswordJob(QStringLiteral("Charm"), this);
     connect(readJob, SIGNAL(finished(QKeychain::Job*)), this, SLOT(passwordRead(QKeychain::Job*)));
     readJob->setKey(QStringLiteral("lotsofcake"));
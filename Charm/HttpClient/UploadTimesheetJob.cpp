@@ -29,6 +29,26 @@
 #include <QNetworkRequest>
 #include <QRegExp> // Required for Qt 4
 #include <QSettings>
+#include <QStringList>
+#include <QTimer>
+
+static bool isTransientError(QNetworkReply::NetworkError error)
+{
+    switch (error) {
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+    case QNetworkReply::InternalServerError:
+    case QNetworkReply::ServiceUnavailableError:
+    case QNetworkReply::UnknownServerError:
+        return true;
+    default:
+        return false;
+    }
+}
 
 UploadTimesheetJob::UploadTimesheetJob(QObject* parent)
     : HttpJob(parent), m_fileName(QStringLiteral("payload"))
@@ -72,20 +92,86 @@ void UploadTimesheetJob::setUploadUrl(const QUrl& url)
     m_uploadUrl = url;
 }
 
+int UploadTimesheetJob::addUpload(const QString &fileName, const QByteArray &payload)
+{
+    Upload upload;
+    upload.fileName = fileName;
+    upload.payload = payload;
+    m_uploads.append(upload);
+    return m_uploads.size() - 1;
+}
+
+int UploadTimesheetJob::maximumConcurrentUploads() const
+{
+    return m_maximumConcurrentUploads;
+}
+
+void UploadTimesheetJob::setMaximumConcurrentUploads(int count)
+{
+    m_maximumConcurrentUploads = qMax(1, count);
+}
+
+int UploadTimesheetJob::maximumRetries() const
+{
+    return m_maximumRetries;
+}
+
+void UploadTimesheetJob::setMaximumRetries(int count)
+{
+    m_maximumRetries = qMax(0, count);
+}
+
+int UploadTimesheetJob::retryDelay() const
+{
+    return m_retryDelay;
+}
+
+void UploadTimesheetJob::setRetryDelay(int milliseconds)
+{
+    m_retryDelay = qMax(0, milliseconds);
+}
+
 bool UploadTimesheetJob::execute(int state, QNetworkAccessManager *manager)
 {
     if (state != UploadTimesheet)
         return HttpJob::execute(state, manager);
 
+    if (m_uploads.isEmpty())
+        addUpload(m_fileName, m_payload);
+
+    m_manager = manager;
+    startUploads();
+    return true;
+}
+
+void UploadTimesheetJob::startUploads()
+{
+    while (m_running < m_maximumConcurrentUploads && m_nextUpload < m_uploads.size()) {
+        ++m_running;
+        post(m_nextUpload++);
+    }
+}
+
+void UploadTimesheetJob::post(int index)
+{
+    /* the job may have been canceled while a retry was pending */
+    if (error() != NoError) {
+        --m_running;
+        return;
+    }
+
+    Upload &upload = m_uploads[index];
+    ++upload.attempts;
+
     QByteArray data;
     QByteArray uploadName;
 
     /* validate filename */
-    if (!m_fileName.contains(QRegExp(QStringLiteral("^WeeklyTimeSheet-\\d\\d\\d\\d-\\d\\d$")))) {
+    if (!upload.fileName.contains(QRegExp(QStringLiteral("^WeeklyTimeSheet-\\d\\d\\d\\d-\\d\\d$")))) {
         qDebug("Invalid filename encountered, using default (\"payload\").");
         uploadName = "payload";
     }
-    else uploadName = m_fileName.toUtf8();
+    else uploadName = upload.fileName.toUtf8();
 
     /* username */
     data += "--KDAB\r\n"
@@ -97,7 +183,7 @@ bool UploadTimesheetJob::execute(int state, QNetworkAccessManager *manager)
     data += "--KDAB\r\n"
             "Content-Disposition: form-data; name=\"" + uploadName + "\"; filename=\"" +
             uploadName + "\"\r\nContent-Type: application/octet-stream\r\n\r\n";
-    data += m_payload;
+    data += upload.payload;
     data += "\r\n";
 
     /* eot */
@@ -107,35 +193,90 @@ bool UploadTimesheetJob::execute(int state, QNetworkAccessManager *manager)
     request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("multipart/form-data; boundary=KDAB"));
     request.setHeader(QNetworkRequest::ContentLengthHeader, data.size());
 
-    QNetworkReply *reply = manager->post(request, data);
-
-    if (reply->error() != QNetworkReply::NoError)
-        setErrorFromReplyAndEmitFinished(reply);
-    return true;
+    /* errors are reported through handle() */
+    m_replies.insert(m_manager->post(request, data), index);
 }
 
 bool UploadTimesheetJob::handle(QNetworkReply *reply)
 {
-    /* check for failure */
+    if (state() != UploadTimesheet) {
+        /* check for failure */
+        if (reply->error() != QNetworkReply::NoError) {
+            setErrorFromReplyAndEmitFinished(reply);
+            return false;
+        }
+        return HttpJob::handle(reply);
+    }
+
+    const auto it = m_replies.find(reply);
+    if (it == m_replies.end())
+        return false;
+    const int index = it.value();
+    m_replies.erase(it);
+    reply->deleteLater();
+
     if (reply->error() != QNetworkReply::NoError) {
-        setErrorFromReplyAndEmitFinished(reply);
+        uploadFailed(index,
+                     reply->error() == QNetworkReply::HostNotFoundError ? HostNotFound : SomethingWentWrong,
+                     reply->errorString(), isTransientError(reply->error()));
         return false;
     }
 
-    if (state() != UploadTimesheet)
-        return HttpJob::handle(reply);
-
     const QByteArray answer = reply->readAll();
 
     if (answer.contains("SuccessResultMessage")) {
-        delayedNext();
+        emit timesheetUploaded(index);
+        uploadDone();
     } else {
+        /* the server rejected the time sheet, trying again will not help */
         const QString errorMessage = extractErrorMessageFromReply(answer);
-        setErrorAndEmitFinished(SomethingWentWrong, !errorMessage.isEmpty()
-                                ? errorMessage
-                                : tr("An error occurred, could not extract details"));
+        uploadFailed(index, SomethingWentWrong, !errorMessage.isEmpty()
+                     ? errorMessage
+                     : tr("An error occurred, could not extract details"), false);
     }
     return true;
 }
 
+void UploadTimesheetJob::uploadFailed(int index, int code, const QString &message, bool transient)
+{
+    const Upload &upload = m_uploads[index];
+    if (transient && upload.attempts <= m_maximumRetries) {
+        const int delay = m_retryDelay << (upload.attempts - 1);
+        QTimer::singleShot(delay, this, [this, index]() { post(index); });
+        return;
+    }
+
+    Failure failure;
+    failure.index = index;
+    failure.code = code;
+    failure.message = message;
+    m_failures.append(failure);
+    uploadDone();
+}
+
+void UploadTimesheetJob::uploadDone()
+{
+    --m_running;
+    startUploads();
+    if (m_running > 0)
+        return;
+
+    if (m_failures.isEmpty()) {
+        delayedNext();
+        return;
+    }
+
+    if (m_uploads.size() == 1) {
+        setErrorAndEmitFinished(m_failures.first().code, m_failures.first().message);
+        return;
+    }
+
+    QStringList messages;
+    Q_FOREACH (const Failure &failure, m_failures)
+        messages.append(QStringLiteral("%1: %2").arg(m_uploads[failure.index].fileName, failure.message));
+    setErrorAndEmitFinished(m_failures.first().code,
+                            tr("%1 of %2 time sheets could not be uploaded:\n%3")
+                            .arg(m_failures.size()).arg(m_uploads.size()).arg(messages.join(QLatin1Char('\n'))));
+}
+
 #include "moc_UploadTimesheetJob.cpp"
@@ -26,7 +26,9 @@
 
 #include "HttpJob.h"
 
+#include <QHash>
 #include <QUrl>
+#include <QVector>
 
 class UploadTimesheetJob : public HttpJob
 {
@@ -43,6 +45,25 @@ public:
     QUrl uploadUrl() const;
     void setUploadUrl(const QUrl& url);
 
+    /**
+     * Queues a time sheet for upload and returns its index.
+     * The job logs in once and then uploads all queued time sheets. If none
+     * were queued, payload() is uploaded as fileName().
+     */
+    int addUpload(const QString &fileName, const QByteArray &payload);
+    int maximumConcurrentUploads() const;
+    void setMaximumConcurrentUploads(int count);
+    /** How often an upload is retried after a network or server error. */
+    int maximumRetries() const;
+    void setMaximumRetries(int count);
+    /** The delay before the first retry in milliseconds, it doubles with every further attempt. */
+    int retryDelay() const;
+    void setRetryDelay(int milliseconds);
+
+Q_SIGNALS:
+    /** The time sheet queued as @p index was accepted by the server. */
+    void timesheetUploaded(int index);
+
 public Q_SLOTS:
 
     bool execute(int state, QNetworkAccessManager *manager) override;
@@ -55,9 +76,35 @@ protected:
     };
 
 private:
+    struct Upload {
+        QString fileName;
+        QByteArray payload;
+        int attempts = 0;
+    };
+    struct Failure {
+        int index;
+        int code;
+        QString message;
+    };
+
+    void startUploads();
+    void post(int index);
+    void uploadFailed(int index, int code, const QString &message, bool transient);
+    void uploadDone();
+
     QByteArray m_payload;
     QString m_fileName;
     QUrl m_uploadUrl;
+    int m_maximumConcurrentUploads = 4;
+    int m_maximumRetries = 3;
+    int m_retryDelay = 1000;
+    QVector<Upload> m_uploads;
+    QVector<Failure> m_failures;
+    QHash<QNetworkReply*, int> m_replies;
+    QNetworkAccessManager *m_manager = nullptr;
+    int m_nextUpload = 0;
+    /* uploads in flight or waiting for a retry */
+    int m_running = 0;
 };
 
 #endif
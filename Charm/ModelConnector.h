@@ -60,7 +60,7 @@ private:
 
     ViewFilter m_viewFilter; // this is the filtered task model adapter
 
-    EventModelFilter m_eventModelFilter; // owns the event model adapter
+    EventModelFilter m_eventModelFilter;
 
     EventModelFilter m_findEventModelFilter;
 };
@@ -0,0 +1,104 @@
+/*
+  HtmlReportWriter.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "HtmlReportWriter.h"
+
+HtmlReportWriter::HtmlReportWriter()
+    : m_stream( &m_html )
+{
+    // FIXME this is only a rudimentary subset of a valid xhtml 1 document
+    m_stream << "<!DOCTYPE html>\n";
+    beginElement( QStringLiteral("html"), { { QStringLiteral("xmlns"), QStringLiteral("http://www.w3.org/1999/xhtml") } } );
+    emptyElement( QStringLiteral("head") );
+    beginElement( QStringLiteral("body") );
+}
+
+void HtmlReportWriter::beginElement( const QString& name, const Attributes& attributes )
+{
+    writeStartTag( name, attributes );
+    m_stream << '>';
+    m_openElements.append( name );
+}
+
+void HtmlReportWriter::endElement()
+{
+    Q_ASSERT_X( ! m_openElements.isEmpty(), Q_FUNC_INFO, "No element is open" );
+    m_stream << "</" << m_openElements.takeLast() << '>';
+}
+
+void HtmlReportWriter::textElement( const QString& name, const QString& text, const Attributes& attributes )
+{
+    writeStartTag( name, attributes );
+    m_stream << '>' << text.toHtmlEscaped() << "</" << name << '>';
+}
+
+void HtmlReportWriter::emptyElement( const QString& name )
+{
+    writeStartTag( name, Attributes() );
+    m_stream << "/>";
+}
+
+void HtmlReportWriter::link( const QString& href, const QString& text )
+{
+    textElement( QStringLiteral("a"), text, { { QStringLiteral("href"), href } } );
+}
+
+void HtmlReportWriter::beginTable()
+{
+    beginElement( QStringLiteral("table"), {
+                      { QStringLiteral("width"), QStringLiteral("100%") },
+                      { QStringLiteral("align"), QStringLiteral("left") },
+                      { QStringLiteral("cellpadding"), QStringLiteral("3") },
+                      { QStringLiteral("cellspacing"), QStringLiteral("0") } } );
+}
+
+void HtmlReportWriter::beginRow( const QString& cssClass )
+{
+    if ( cssClass.isEmpty() )
+        beginElement( QStringLiteral("tr") );
+    else
+        beginElement( QStringLiteral("tr"), { { QStringLiteral("class"), cssClass } } );
+}
+
+void HtmlReportWriter::headerCell( const QString& text )
+{
+    textElement( QStringLiteral("th"), text );
+}
+
+void HtmlReportWriter::cell( const QString& text, const Attributes& attributes )
+{
+    textElement( QStringLiteral("td"), text, attributes );
+}
+
+QString HtmlReportWriter::finish()
+{
+    while ( ! m_openElements.isEmpty() )
+        endElement();
+    m_stream.flush();
+    return m_html;
+}
+
+void HtmlReportWriter::writeStartTag( const QString& name, const Attributes& attributes )
+{
+    m_stream << '<' << name;
+    Q_FOREACH( const auto& attribute, attributes )
+        m_stream << ' ' << attribute.first << "=\"" << attribute.second.toHtmlEscaped() << '"';
+}
@@ -0,0 +1,66 @@
+/*
+  HtmlReportWriter.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HTMLREPORTWRITER_H
+#define HTMLREPORTWRITER_H
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+/** HtmlReportWriter writes the HTML of the report previews as a stream
+    of elements, without building a document tree first.
+    Text and attribute values are escaped, elements are closed in the
+    reverse order they were opened. */
+class HtmlReportWriter {
+public:
+    typedef QList<QPair<QString, QString> > Attributes;
+
+    /** Starts the html document and opens its body. */
+    HtmlReportWriter();
+
+    void beginElement( const QString& name, const Attributes& attributes = Attributes() );
+    void endElement();
+    /** Writes an element that only contains text. */
+    void textElement( const QString& name, const QString& text, const Attributes& attributes = Attributes() );
+    void emptyElement( const QString& name );
+    void link( const QString& href, const QString& text );
+
+    /** Opens a table with the layout all reports use. */
+    void beginTable();
+    void beginRow( const QString& cssClass = QString() );
+    void headerCell( const QString& text );
+    void cell( const QString& text, const Attributes& attributes = Attributes() );
+
+    /** Closes all open elements and returns the document. */
+    QString finish();
+
+private:
+    void writeStartTag( const QString& name, const Attributes& attributes );
+
+    QString m_html;
+    QTextStream m_stream;
+    QStringList m_openElements;
+};
+
+#endif
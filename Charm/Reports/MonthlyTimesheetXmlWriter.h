@@ -24,11 +24,12 @@
 #ifndef MONTHLYTIMESHEETXMLWRITER_H
 #define MONTHLYTIMESHEETXMLWRITER_H
 
+#include "Core/CharmDataModelSnapshot.h"
 #include "Core/Event.h"
 #include "Core/Task.h"
 
 class QByteArray;
-class CharmDataModel;
+class QIODevice;
 
 class MonthlyTimesheetXmlWriter {
 public:
@@ -37,8 +38,15 @@ public:
      * @throws XmlSerializationException
      */
     QByteArray saveToXml() const;
+    /**
+     * Writes the time sheet to @p device, which has to be open for writing.
+     * @throws XmlSerializationException
+     */
+    void saveToXml( QIODevice* device ) const;
 
-    void setDataModel( const CharmDataModel* dataModel );
+    void setSnapshot( const CharmDataModelSnapshot& snapshot );
+    /** The user name in the metadata, read on the GUI thread by the caller. */
+    void setUserName( const QString& userName );
     void setYearOfMonth( int yearOfMonth );
     void setMonthNumber( int monthNumber );
     void setNumberOfWeeks( int numberOfWeeks );
@@ -46,7 +54,8 @@ public:
     void setRootTask( TaskId rootTask );
 
 private:
-    const CharmDataModel* m_dataModel = nullptr;
+    CharmDataModelSnapshot m_snapshot;
+    QString m_userName;
     int m_yearOfMonth = 0;
     int m_monthNumber = 0;
     int m_numberOfWeeks = 0;
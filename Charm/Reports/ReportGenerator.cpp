@@ -0,0 +1,139 @@
+/*
+  ReportGenerator.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ReportGenerator.h"
+
+#include <QRunnable>
+
+class ReportGenerator::Runnable : public QRunnable
+{
+public:
+    Runnable( const QSharedPointer<Control>& control, const CharmDataModelSnapshot& snapshot, const Job& job )
+        : m_control( control )
+        , m_snapshot( snapshot )
+        , m_job( job )
+    {
+    }
+
+    void run() override
+    {
+        if ( m_control->isCanceled() )
+            return;
+        const QString html = m_job( m_snapshot, *m_control );
+        if ( m_control->isCanceled() )
+            return;
+        // the generator waits for its jobs before it is destroyed, and
+        // takes the pages from the control once it got the result:
+        QMetaObject::invokeMethod( m_control->m_generator, "slotFinished", Qt::QueuedConnection,
+                                   Q_ARG( int, m_control->m_request ), Q_ARG( QString, html ) );
+    }
+
+private:
+    QSharedPointer<Control> m_control;
+    CharmDataModelSnapshot m_snapshot;
+    Job m_job;
+};
+
+ReportGenerator::Control::Control( ReportGenerator* generator, int request )
+    : m_generator( generator )
+    , m_request( request )
+{
+}
+
+bool ReportGenerator::Control::isCanceled() const
+{
+    return m_canceled.load() != 0;
+}
+
+void ReportGenerator::Control::setProgress( int done, int total )
+{
+    const int percent = total > 0 ? int( qint64( qBound( 0, done, total ) ) * 100 / total ) : 0;
+    if ( percent == m_percent )
+        return;
+    m_percent = percent;
+    QMetaObject::invokeMethod( m_generator, "slotProgress", Qt::QueuedConnection,
+                               Q_ARG( int, m_request ), Q_ARG( int, percent ) );
+}
+
+void ReportGenerator::Control::setMorePages( int count, const PageJob& pageJob )
+{
+    m_pageCount = count;
+    m_pageJob = pageJob;
+}
+
+ReportGenerator::ReportGenerator( QObject* parent )
+    : QObject( parent )
+{
+    // a canceled job finishes before the next one starts:
+    m_pool.setMaxThreadCount( 1 );
+}
+
+ReportGenerator::~ReportGenerator()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void ReportGenerator::start( const CharmDataModelSnapshot& snapshot, const Job& job )
+{
+    cancel();
+    m_current = QSharedPointer<Control>( new Control( this, ++m_requests ) );
+    m_pool.start( new Runnable( m_current, snapshot, job ) );
+}
+
+void ReportGenerator::cancel()
+{
+    if ( m_current ) {
+        m_current->m_canceled.store( 1 );
+        m_current.reset();
+    }
+}
+
+bool ReportGenerator::isRunning() const
+{
+    return !m_current.isNull();
+}
+
+QString ReportGenerator::page( int page ) const
+{
+    if ( page < 1 || page > m_pageCount )
+        return QString();
+    return m_pageJob( page );
+}
+
+void ReportGenerator::slotProgress( int request, int percent )
+{
+    if ( m_current && m_current->m_request == request )
+        emit progress( percent );
+}
+
+void ReportGenerator::slotFinished( int request, const QString& html )
+{
+    if ( !m_current || m_current->m_request != request )
+        return;
+    m_pageCount = m_current->m_pageCount;
+    m_pageJob = m_current->m_pageJob;
+    m_current.reset();
+    emit finished( html, m_pageCount );
+}
+
+#include "moc_ReportGenerator.cpp"
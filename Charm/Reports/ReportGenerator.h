@@ -0,0 +1,116 @@
+/*
+  ReportGenerator.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef REPORTGENERATOR_H
+#define REPORTGENERATOR_H
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+
+#include <functional>
+
+#include "Core/CharmDataModelSnapshot.h"
+
+/** ReportGenerator computes report previews on a worker thread.
+    A job gets a snapshot of the data model and returns the HTML of the
+    report. Long reports can be split into pages that are only written
+    when the preview asks for them, so that neither the job nor the
+    preview has to handle what the user never scrolls to. There is only one
+    request at a time: starting a new request
+    cancels the one in flight, and the results of canceled requests are
+    dropped. The signals are emitted on the thread the generator lives in. */
+class ReportGenerator : public QObject
+{
+    Q_OBJECT
+    class Runnable;
+
+public:
+    /** Writes page @p page of a report, counting from 1 for the page
+        after the HTML the job returned. */
+    typedef std::function<QString( int page )> PageJob;
+
+    /** Handed to the running job, to report progress and to find out
+        whether the request was canceled. */
+    class Control {
+    public:
+        /** Jobs check this regularly, and return early once it is set. */
+        bool isCanceled() const;
+        /** Reports that @p done of @p total steps are complete. */
+        void setProgress( int done, int total );
+        /** The report has @p count more pages after the HTML the job
+            returns, which @p pageJob writes when they are asked for.
+            It is called on the generator's thread, and must only use
+            data it holds a copy of, like the snapshot. */
+        void setMorePages( int count, const PageJob& pageJob );
+
+    private:
+        friend class ReportGenerator;
+        friend class Runnable;
+        Control( ReportGenerator* generator, int request );
+
+        ReportGenerator* m_generator;
+        const int m_request;
+        QAtomicInt m_canceled;
+        // only used by the worker thread:
+        int m_percent = -1;
+        int m_pageCount = 0;
+        PageJob m_pageJob;
+    };
+
+    typedef std::function<QString( const CharmDataModelSnapshot& snapshot, Control& control )> Job;
+
+    explicit ReportGenerator( QObject* parent = nullptr );
+    /** Cancels the request in flight and waits for its job to return. */
+    ~ReportGenerator() override;
+
+    /** Runs @p job on @p snapshot, canceling the previous request. */
+    void start( const CharmDataModelSnapshot& snapshot, const Job& job );
+    void cancel();
+    bool isRunning() const;
+    /** Page @p page of the last finished report, from 1 to the number
+        of more pages it announced. */
+    QString page( int page ) const;
+
+Q_SIGNALS:
+    /** Progress of the current request, in percent. */
+    void progress( int percent );
+    /** The report is done, @p morePages is the number of pages after
+        the first one. */
+    void finished( const QString& html, int morePages );
+
+private Q_SLOTS:
+    void slotProgress( int request, int percent );
+    void slotFinished( int request, const QString& html );
+
+private:
+    QThreadPool m_pool;
+    QSharedPointer<Control> m_current;
+    int m_requests = 0;
+    // the pages of the last finished report:
+    int m_pageCount = 0;
+    PageJob m_pageJob;
+};
+
+#endif
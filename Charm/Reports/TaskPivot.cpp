@@ -0,0 +1,261 @@
+/*
+  TaskPivot.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "TaskPivot.h"
+
+#include "Core/CharmDataModel.h"
+#include "Core/CharmDataModelSnapshot.h"
+#include "Core/DurationRollup.h"
+
+#include <algorithm>
+
+TaskPivot::Buckets TaskPivot::Buckets::days( const QDate& start, const QDate& end )
+{
+    return custom( start, end, qMax( 0, int( start.daysTo( end ) ) ), [start]( const QDate& day ) {
+        return int( start.daysTo( day ) );
+    } );
+}
+
+TaskPivot::Buckets TaskPivot::Buckets::weeks( const QDate& start, const QDate& end )
+{
+    // counted from the Monday of the first week, same as Charm::weekDifference():
+    const QDate firstMonday = start.addDays( 1 - start.dayOfWeek() );
+    const int count = end > start ? int( firstMonday.daysTo( end.addDays( -1 ) ) / 7 ) + 1 : 0;
+    return custom( start, end, count, [firstMonday]( const QDate& day ) {
+        return int( firstMonday.daysTo( day ) / 7 );
+    } );
+}
+
+TaskPivot::Buckets TaskPivot::Buckets::months( const QDate& start, const QDate& end )
+{
+    const auto monthsSinceStart = [start]( const QDate& day ) {
+        return ( day.year() - start.year() ) * 12 + day.month() - start.month();
+    };
+    const int count = end > start ? monthsSinceStart( end.addDays( -1 ) ) + 1 : 0;
+    return custom( start, end, count, monthsSinceStart );
+}
+
+TaskPivot::Buckets TaskPivot::Buckets::custom( const QDate& start, const QDate& end, int count, const Function& bucketOf )
+{
+    Buckets buckets;
+    buckets.m_start = start;
+    buckets.m_end = end;
+    buckets.m_firstDays.resize( count );
+    const int days = qMax( 0, int( start.daysTo( end ) ) );
+    buckets.m_buckets.resize( days );
+    for ( int i = 0; i < days; ++i ) {
+        const QDate day = start.addDays( i );
+        const int bucket = bucketOf( day );
+        Q_ASSERT( bucket < count );
+        buckets.m_buckets[i] = bucket >= 0 && bucket < count ? bucket : -1;
+        if ( buckets.m_buckets[i] >= 0 && ! buckets.m_firstDays[bucket].isValid() )
+            buckets.m_firstDays[bucket] = day;
+    }
+    return buckets;
+}
+
+QDate TaskPivot::Buckets::start() const
+{
+    return m_start;
+}
+
+QDate TaskPivot::Buckets::end() const
+{
+    return m_end;
+}
+
+int TaskPivot::Buckets::count() const
+{
+    return m_firstDays.size();
+}
+
+int TaskPivot::Buckets::bucket( const QDate& day ) const
+{
+    const qint64 index = m_start.daysTo( day );
+    return index >= 0 && index < m_buckets.size() ? m_buckets[int( index )] : -1;
+}
+
+QDate TaskPivot::Buckets::firstDay( int bucket ) const
+{
+    return m_firstDays.value( bucket );
+}
+
+TaskPivot::TaskPivot( const Buckets& buckets )
+    : m_buckets( buckets )
+{
+    clear();
+}
+
+void TaskPivot::setRootTask( TaskId root )
+{
+    m_root = root;
+}
+
+void TaskPivot::clear()
+{
+    m_tasks = TaskIdList() << m_root;
+    m_parents = QVector<int>() << -1;
+    m_rows.clear();
+    m_rows.insert( m_root, 0 );
+    m_taskRows.clear();
+    m_seconds = QVector<int>( columnCount(), 0 );
+    m_subtreeSeconds = m_seconds;
+}
+
+template<typename Lookup>
+int TaskPivot::rowForTask( TaskId task, const Lookup& lookup )
+{
+    const auto known = m_taskRows.constFind( task );
+    if ( known != m_taskRows.constEnd() )
+        return known.value();
+
+    // the path from the task up to the root:
+    TaskIdList path;
+    TaskId id = task;
+    while ( id != m_root ) {
+        if ( id == 0 ) {
+            // not below the root:
+            m_taskRows.insert( task, -1 );
+            return -1;
+        }
+        path << id;
+        // tasks that are not known count as top level tasks, like in the rollup:
+        const Task& item = lookup( id );
+        id = item.isValid() ? item.parent() : 0;
+    }
+
+    // add the rows that are missing, from the top:
+    int parent = 0;
+    for ( int i = path.size() - 1; i >= 0; --i ) {
+        const auto existing = m_rows.constFind( path[i] );
+        if ( existing != m_rows.constEnd() ) {
+            parent = existing.value();
+            continue;
+        }
+        m_rows.insert( path[i], m_tasks.size() );
+        m_tasks << path[i];
+        m_parents << parent;
+        m_seconds.resize( m_seconds.size() + columnCount() );
+        parent = m_tasks.size() - 1;
+    }
+    m_taskRows.insert( task, parent );
+    return parent;
+}
+
+void TaskPivot::compute( const CharmDataModel* dataModel )
+{
+    clear();
+    const auto lookup = [dataModel]( TaskId id ) -> const Task& { return dataModel->getTask( id ); };
+    const DurationRollup& rollup = dataModel->durationRollup();
+    Q_FOREACH( TaskId task, rollup.tasksWithEvents( m_buckets.start(), m_buckets.end() ) ) {
+        const int row = rowForTask( task, lookup );
+        if ( row < 0 )
+            continue;
+        int* cells = m_seconds.data() + row * columnCount();
+        rollup.forEachDay( task, m_buckets.start(), m_buckets.end(), [&]( const QDate& day, int seconds ) {
+            const int bucket = m_buckets.bucket( day );
+            if ( bucket >= 0 )
+                cells[bucket] += seconds;
+        } );
+    }
+    m_subtreeSeconds = m_seconds;
+    rollUp( m_subtreeSeconds, m_parents, columnCount() );
+}
+
+void TaskPivot::compute( const CharmDataModelSnapshot& snapshot )
+{
+    clear();
+    const auto lookup = [&snapshot]( TaskId id ) -> const Task& { return snapshot.getTask( id ); };
+    Q_FOREACH( EventId id, snapshot.eventsThatStartInTimeFrame( m_buckets.start(), m_buckets.end() ) ) {
+        const Event& event = snapshot.eventForId( id );
+        const int bucket = m_buckets.bucket( event.startDateTime().date() );
+        if ( bucket < 0 )
+            continue;
+        const int row = rowForTask( event.taskId(), lookup );
+        if ( row >= 0 )
+            m_seconds[row * columnCount() + bucket] += event.duration();
+    }
+    m_subtreeSeconds = m_seconds;
+    rollUp( m_subtreeSeconds, m_parents, columnCount() );
+}
+
+const TaskPivot::Buckets& TaskPivot::buckets() const
+{
+    return m_buckets;
+}
+
+int TaskPivot::rowCount() const
+{
+    return m_tasks.size();
+}
+
+int TaskPivot::columnCount() const
+{
+    return m_buckets.count();
+}
+
+TaskId TaskPivot::taskId( int row ) const
+{
+    return m_tasks.at( row );
+}
+
+int TaskPivot::parentRow( int row ) const
+{
+    return m_parents.at( row );
+}
+
+int TaskPivot::row( TaskId task ) const
+{
+    return m_rows.value( task, -1 );
+}
+
+int TaskPivot::seconds( int row, int column ) const
+{
+    return m_seconds.at( row * columnCount() + column );
+}
+
+int TaskPivot::subtreeSeconds( int row, int column ) const
+{
+    return m_subtreeSeconds.at( row * columnCount() + column );
+}
+
+int TaskPivot::subtreeTotal( int row ) const
+{
+    int total = 0;
+    const int* cells = m_subtreeSeconds.constData() + row * columnCount();
+    for ( int column = 0; column < columnCount(); ++column )
+        total += cells[column];
+    return total;
+}
+
+void TaskPivot::rollUp( QVector<int>& matrix, const QVector<int>& parents, int columns )
+{
+    int* data = matrix.data();
+    for ( int row = parents.size() - 1; row > 0; --row ) {
+        Q_ASSERT( parents[row] >= 0 && parents[row] < row );
+        int* target = data + parents[row] * columns;
+        const int* source = data + row * columns;
+        // plain additions of contiguous rows, which the compiler vectorizes:
+        for ( int column = 0; column < columns; ++column )
+            target[column] += source[column];
+    }
+}
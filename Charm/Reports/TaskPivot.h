@@ -0,0 +1,128 @@
+/*
+  TaskPivot.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TASKPIVOT_H
+#define TASKPIVOT_H
+
+#include <QDate>
+#include <QHash>
+#include <QVector>
+
+#include <functional>
+
+#include "Core/Task.h"
+
+class CharmDataModel;
+class CharmDataModelSnapshot;
+
+/** TaskPivot sums up the seconds of the events per task and bucket of
+    days, like the days of a week or the months of a year, in a dense
+    matrix with one row per task and one column per bucket. The time
+    sheets are made from it.
+    Next to the seconds of the task's own events, it keeps the seconds of
+    every task's subtree. The rows are the tasks with events in the range
+    and their ancestors up to the root task, parents always before their
+    children. Row 0 is the root task, so its subtree seconds are the
+    totals of the buckets.
+    Every event counts for the day it starts on, like in the reports. */
+class TaskPivot
+{
+public:
+    /** Assigns the days of a date range to the columns of the pivot. */
+    class Buckets
+    {
+    public:
+        typedef std::function<int( const QDate& day )> Function;
+
+        /** One bucket per day from start to end (exclusive). */
+        static Buckets days( const QDate& start, const QDate& end );
+        /** One bucket per ISO week, the first and the last one may be partial. */
+        static Buckets weeks( const QDate& start, const QDate& end );
+        /** One bucket per month, the first and the last one may be partial. */
+        static Buckets months( const QDate& start, const QDate& end );
+        /** @p count buckets, @p bucketOf returns the bucket of a day,
+            or -1 to leave the day out. */
+        static Buckets custom( const QDate& start, const QDate& end, int count, const Function& bucketOf );
+
+        QDate start() const;
+        QDate end() const;
+        int count() const;
+        /** The bucket of @p day, -1 if the day is not in the range or left out. */
+        int bucket( const QDate& day ) const;
+        /** The first day in the range that belongs to @p bucket. */
+        QDate firstDay( int bucket ) const;
+
+    private:
+        QDate m_start;
+        QDate m_end;
+        // the bucket of every day, computed once, not for every event:
+        QVector<int> m_buckets;
+        QVector<QDate> m_firstDays;
+    };
+
+    explicit TaskPivot( const Buckets& buckets );
+
+    /** Only the subtree of @p root, all tasks by default. */
+    void setRootTask( TaskId root );
+
+    /** Fills the pivot from the duration rollup of the data model,
+        on the GUI thread. */
+    void compute( const CharmDataModel* dataModel );
+    /** Fills the pivot from the events of @p snapshot, on any thread. */
+    void compute( const CharmDataModelSnapshot& snapshot );
+
+    const Buckets& buckets() const;
+    int rowCount() const;
+    int columnCount() const;
+    TaskId taskId( int row ) const;
+    /** The row of the parent of the task in @p row, -1 for row 0. */
+    int parentRow( int row ) const;
+    /** The row of @p task, -1 if it is not in the pivot. */
+    int row( TaskId task ) const;
+    /** Seconds of the own events of the task in @p row. */
+    int seconds( int row, int column ) const;
+    /** Same as seconds(), including the events of all subtasks. */
+    int subtreeSeconds( int row, int column ) const;
+    int subtreeTotal( int row ) const;
+
+    /** Adds every row of @p matrix to the row of its parent, given by
+        @p parents, which have to come before their children. */
+    static void rollUp( QVector<int>& matrix, const QVector<int>& parents, int columns );
+
+private:
+    template<typename Lookup>
+    int rowForTask( TaskId task, const Lookup& lookup );
+    void clear();
+
+    Buckets m_buckets;
+    TaskId m_root = 0;
+
+    TaskIdList m_tasks;
+    QVector<int> m_parents;
+    QHash<TaskId, int> m_rows;
+    // the rows of the tasks with events, -1 for the tasks left out:
+    QHash<TaskId, int> m_taskRows;
+    QVector<int> m_seconds;
+    QVector<int> m_subtreeSeconds;
+};
+
+#endif
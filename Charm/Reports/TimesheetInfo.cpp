@@ -22,8 +22,15 @@
 */
 
 #include "TimesheetInfo.h"
+#include "TaskPivot.h"
 
-#include "Core/CharmDataModel.h"
+#include "Core/CharmDataModelSnapshot.h"
+
+#include <QHash>
+#include <QSet>
+#include <QtDebug>
+
+#include <algorithm>
 
 TimeSheetInfo::TimeSheetInfo(int segments)
     : seconds( segments )
@@ -50,74 +57,204 @@ QString TimeSheetInfo::formattedTaskIdAndName( int taskPaddingLength ) const
     return QStringLiteral("%1: %2").arg( formattedId, taskName );
 }
 
-// make the list, aggregate the seconds in the subtask:
-TimeSheetInfoList TimeSheetInfo::taskWithSubTasks( const CharmDataModel* dataModel, int segments, TaskId id,
-    const SecondsMap& secondsMap,
-    TimeSheetInfo* addTo )
-{
-    TimeSheetInfoList result;
-    TimeSheetInfoList children;
-
-    TimeSheetInfo myInformation(segments);
-    const TaskTreeItem& item = dataModel->taskTreeItem( id );
-    // real task or virtual root item
-    Q_ASSERT( item.task().isValid() || id == 0 );
-
-    if ( id != 0 ) {
-        // add totals for task itself:
-        if ( secondsMap.contains( id ) ) {
-            myInformation.seconds = secondsMap.value(id);
-        }
-        // add name and id:
-        myInformation.taskId = item.task().id();
-        myInformation.taskName = item.task().name();
+namespace {
+    // the task tree of a snapshot, on any thread:
+    struct SnapshotTree {
+        const CharmDataModelSnapshot& snapshot;
 
-        if ( addTo != 0 ) {
-            myInformation.indentation = addTo->indentation + 1;
+        const Task& task( TaskId id ) const
+        {
+            return snapshot.getTask( id );
         }
-        myInformation.taskId = id;
-    } else {
-        myInformation.indentation = -1;
-    }
 
-    TaskIdList childIds = item.childIds();
-    // sort by task id
-    qSort( childIds );
-    // recursively add those to myself:
-    Q_FOREACH ( const TaskId i, childIds ) {
-        children << taskWithSubTasks( dataModel, segments, i, secondsMap, &myInformation );
-    }
+        bool hasChildren( TaskId id ) const
+        {
+            return ! snapshot.childIds( id ).isEmpty();
+        }
 
-    // add to parent:
-    if ( addTo != 0 ) {
-        for ( int i = 0; i < segments; ++i )
+        template<typename Function>
+        void forEachChild( TaskId id, Function function ) const
         {
-            addTo->seconds[i] += myInformation.seconds[i];
+            Q_FOREACH( TaskId child, snapshot.childIds( id ) )
+                function( child );
         }
-        addTo->aggregated = true;
+    };
+
+    // the list of @p items, parents always before their children, walked depth
+    // first with the children sorted by task id, from the seconds of their subtrees:
+    template<typename Tree>
+    TimeSheetInfoList listTasks( const Tree& tree, int segments, const QVector<TaskId>& items,
+                                 const QVector<int>& parents, const QVector<int>& matrix, bool activeTasksOnly )
+    {
+        const TaskId rootId = items.first();
+        const int count = items.size();
+        QVector<const Task*> tasks( count );
+        for ( int i = 0; i < count; ++i )
+            tasks[i] = &tree.task( items[i] );
+
+        // the children of every task, sorted by task id:
+        QVector<int> children( count - 1 );
+        for ( int i = 1; i < count; ++i )
+            children[i - 1] = i;
+        std::sort( children.begin(), children.end(), [&]( int left, int right ) {
+            if ( parents[left] != parents[right] )
+                return parents[left] < parents[right];
+            return items[left] < items[right];
+        } );
+        QVector<int> firstChild( count + 1, children.size() );
+        for ( int i = children.size() - 1; i >= 0; --i )
+            firstChild[parents[children[i]]] = i;
+        for ( int i = count - 1; i >= 0; --i )
+            firstChild[i] = qMin( firstChild[i], firstChild[i + 1] );
+
+        // walk the tree depth first, in the order of the old recursive version:
+        TimeSheetInfoList result;
+        QVector<int> indentations( count );
+        QVector<int> stack;
+        stack << 0;
+        indentations[0] = rootId == 0 ? -1 : 0;
+        while ( ! stack.isEmpty() ) {
+            const int index = stack.takeLast();
+            const Task& task = *tasks[index];
+            for ( int i = firstChild[index + 1] - 1; i >= firstChild[index]; --i ) {
+                indentations[children[i]] = indentations[index] + 1;
+                stack << children[i];
+            }
+
+            TimeSheetInfo info( segments );
+            std::copy( matrix.constBegin() + index * segments, matrix.constBegin() + ( index + 1 ) * segments,
+                       info.seconds.begin() );
+            if ( activeTasksOnly && info.total() <= 0 )
+                continue;
+            info.indentation = indentations[index];
+            if ( rootId != 0 || index != 0 ) {
+                info.taskId = task.id();
+                info.taskName = task.name();
+            }
+            info.aggregated = tree.hasChildren( items[index] );
+            result << info;
+        }
+
+        return result;
     }
 
-    result << myInformation << children;
+    // make the list, aggregate the seconds in the subtasks:
+    template<typename Tree>
+    TimeSheetInfoList collectTasks( const Tree& tree, int segments, TaskId rootId,
+                                    const SecondsMap& secondsMap, bool activeTasksOnly )
+    {
+        // the tasks in the report, parents always before their children:
+        QVector<TaskId> items;
+        QVector<int> parents;
+        QHash<TaskId, int> indexes;
 
-    return result;
+        // real task or virtual root item
+        Q_ASSERT( tree.task( rootId ).isValid() || rootId == 0 );
+        items << rootId;
+        parents << -1;
+        indexes.insert( rootId, 0 );
+
+        if ( activeTasksOnly ) {
+            // only the tasks with time, and the paths from them up to the root:
+            QSet<TaskId> outside;
+            TaskIdList path;
+            for ( auto it = secondsMap.constBegin(); it != secondsMap.constEnd(); ++it ) {
+                path.clear();
+                TaskId id = it.key();
+                while ( ! indexes.contains( id ) && ! outside.contains( id ) && id != 0 ) {
+                    const Task& task = tree.task( id );
+                    if ( ! task.isValid() )
+                        break;
+                    path << id;
+                    id = task.parent();
+                }
+                if ( indexes.contains( id ) ) {
+                    int parent = indexes.value( id );
+                    for ( int i = path.size() - 1; i >= 0; --i ) {
+                        indexes.insert( path[i], items.size() );
+                        items << path[i];
+                        parents << parent;
+                        parent = items.size() - 1;
+                    }
+                } else {
+                    Q_FOREACH( TaskId outsider, path )
+                        outside.insert( outsider );
+                }
+            }
+        } else {
+            // every task below the root:
+            for ( int i = 0; i < items.size(); ++i ) {
+                tree.forEachChild( items[i], [&]( TaskId child ) {
+                    items << child;
+                    parents << i;
+                } );
+            }
+        }
+
+        // one row of segments per task, the subtasks added to their parents:
+        QVector<int> matrix( items.size() * segments, 0 );
+        for ( int i = 0; i < items.size(); ++i ) {
+            const auto it = secondsMap.constFind( items[i] );
+            if ( it != secondsMap.constEnd() && tree.task( items[i] ).isValid() ) {
+                const int n = qMin( segments, it->size() );
+                for ( int segment = 0; segment < n; ++segment )
+                    matrix[i * segments + segment] = it->at( segment );
+            }
+        }
+        TaskPivot::rollUp( matrix, parents, segments );
+
+        return listTasks( tree, segments, items, parents, matrix, activeTasksOnly );
+    }
 }
 
-// retrieve events that match the settings (active, ...):
-TimeSheetInfoList TimeSheetInfo::filteredTaskWithSubTasks(
-    TimeSheetInfoList timeSheetInfo,
-    bool activeTasksOnly )
+TimeSheetInfoList TimeSheetInfo::taskWithSubTasks( const CharmDataModelSnapshot& snapshot, int segments, TaskId id,
+    const SecondsMap& secondsMap, bool activeTasksOnly )
 {
+    return collectTasks( SnapshotTree{ snapshot }, segments, id, secondsMap, activeTasksOnly );
+}
+
+TimeSheetInfoList TimeSheetInfo::fromPivot( const CharmDataModelSnapshot& snapshot, const TaskPivot& pivot,
+                                            bool activeTasksOnly )
+{
+    const SnapshotTree tree{ snapshot };
+    const int segments = pivot.columnCount();
+    QVector<TaskId> items;
+    QVector<int> parents;
+    QVector<int> rows;
     if ( activeTasksOnly ) {
-        TimeSheetInfoList nonZero;
-        // FIXME use algorithm (I just hate to lug the fat book around)
-        for ( int i = 0; i < timeSheetInfo.size(); ++i )
-        {
-            if ( timeSheetInfo[i].total() > 0 ) {
-                nonZero << timeSheetInfo[i];
-            }
+        // the rows of the pivot, without the tasks that are not known, like in the seconds map version:
+        QVector<int> indexes( pivot.rowCount(), -1 );
+        for ( int row = 0; row < pivot.rowCount(); ++row ) {
+            const int parent = row == 0 ? -1 : indexes[pivot.parentRow( row )];
+            if ( row != 0 && ( parent < 0 || ! tree.task( pivot.taskId( row ) ).isValid() ) )
+                continue;
+            indexes[row] = items.size();
+            items << pivot.taskId( row );
+            parents << parent;
+            rows << row;
         }
-        timeSheetInfo = nonZero;
+    } else {
+        // every task below the root, with or without a row:
+        items << pivot.taskId( 0 );
+        parents << -1;
+        for ( int i = 0; i < items.size(); ++i ) {
+            tree.forEachChild( items[i], [&]( TaskId child ) {
+                items << child;
+                parents << i;
+            } );
+        }
+        Q_FOREACH( TaskId id, items )
+            rows << pivot.row( id );
+    }
+
+    // the pivot has the seconds of the subtrees already:
+    QVector<int> matrix( items.size() * segments, 0 );
+    for ( int i = 0; i < items.size(); ++i ) {
+        if ( rows[i] < 0 )
+            continue;
+        for ( int segment = 0; segment < segments; ++segment )
+            matrix[i * segments + segment] = pivot.subtreeSeconds( rows[i], segment );
     }
 
-    return timeSheetInfo;
+    return listTasks( tree, segments, items, parents, matrix, activeTasksOnly );
 }
@@ -30,7 +30,8 @@
 
 #include "Core/Task.h"
 
-class CharmDataModel;
+class CharmDataModelSnapshot;
+class TaskPivot;
 class TimeSheetInfo;
 typedef QList<TimeSheetInfo> TimeSheetInfoList;
 
@@ -44,8 +45,17 @@ public:
     void dump();
 
 public:
-    static TimeSheetInfoList taskWithSubTasks( const CharmDataModel* dataModel, int segments, TaskId id, const SecondsMap& secondsMap, TimeSheetInfo* addTo = 0 );
-    static TimeSheetInfoList filteredTaskWithSubTasks( TimeSheetInfoList timeSheetInfo, bool activeTasksOnly );
+    /** The task @p id and all tasks below it in @p snapshot, depth first
+        and sorted by task id, with the seconds of the subtasks added to
+        their parents. With @p activeTasksOnly, only the tasks in
+        @p secondsMap and their ancestors are visited, and tasks without
+        time are left out. */
+    static TimeSheetInfoList taskWithSubTasks( const CharmDataModelSnapshot& snapshot, int segments, TaskId id,
+                                               const SecondsMap& secondsMap, bool activeTasksOnly );
+    /** The same list, one segment per bucket, from the rows of a
+        computed @p pivot and the seconds of their subtrees. */
+    static TimeSheetInfoList fromPivot( const CharmDataModelSnapshot& snapshot, const TaskPivot& pivot,
+                                        bool activeTasksOnly );
 
 public:
     QString formattedTaskIdAndName( int taskPaddingLength ) const;
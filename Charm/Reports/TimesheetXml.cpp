@@ -0,0 +1,104 @@
+/*
+  TimesheetXml.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TimesheetXml.h"
+
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QVector>
+#include <QXmlStreamWriter>
+
+#include <algorithm>
+
+namespace {
+    // the events of one task on one day:
+    struct Effort {
+        int firstEvent = 0;
+        int seconds = 0;
+        QString comment;
+    };
+}
+
+void TimesheetXml::writeTasks( QXmlStreamWriter& writer, const CharmDataModelSnapshot& snapshot,
+                               const TimeSheetInfoList& timeSheetInfo )
+{
+    writer.writeStartElement( QStringLiteral("tasks") );
+    Q_FOREACH ( const TimeSheetInfo& info, timeSheetInfo ) {
+        if ( info.taskId == 0 ) // the root task
+            continue;
+        snapshot.getTask( info.taskId ).toXml( writer );
+    }
+    writer.writeEndElement();
+}
+
+void TimesheetXml::writeEffort( QXmlStreamWriter& writer, const TimeSheetInfoList& timeSheetInfo,
+                                const EventList& events )
+{
+    QSet<TaskId> tasks;
+    tasks.reserve( timeSheetInfo.size() );
+    Q_FOREACH ( const TimeSheetInfo& info, timeSheetInfo )
+        tasks.insert( info.taskId );
+
+    // aggregate (group by task and day):
+    typedef QPair<TaskId, QDate> Key;
+    QHash<Key, Effort> efforts;
+    for ( int i = 0; i < events.size(); ++i ) {
+        const Event& event = events[i];
+        if ( ! tasks.contains( event.taskId() ) )
+            continue;
+        const Key key( event.taskId(), event.startDateTime().date() );
+        auto it = efforts.find( key );
+        if ( it == efforts.end() ) {
+            it = efforts.insert( key, Effort() );
+            it->firstEvent = i;
+        }
+        it->seconds += event.duration();
+        if ( ! event.comment().isEmpty() ) {
+            if ( ! it->comment.isEmpty() ) // make separator
+                it->comment += QLatin1String(" / ");
+            it->comment += event.comment();
+        }
+    }
+
+    // in the order of task and day, as before:
+    QVector<Key> keys;
+    keys.reserve( efforts.size() );
+    for ( auto it = efforts.constBegin(); it != efforts.constEnd(); ++it )
+        keys.append( it.key() );
+    std::sort( keys.begin(), keys.end() );
+
+    writer.writeStartElement( QStringLiteral("effort") );
+    Q_FOREACH ( const Key& key, keys ) {
+        const Effort& effort = efforts[key];
+        Event event( events[effort.firstEvent] );
+        event.setId( -event.id() ); // "synthetic" :-)
+        // move to start at midnight in UTC (for privacy reasons)
+        // never, never, never use setTime() here, it breaks on DST changes! (twice a year)
+        const QDateTime start( key.second, QTime( 0, 0, 0, 0 ), Qt::UTC );
+        event.setStartDateTime( start );
+        event.setEndDateTime( start.addSecs( effort.seconds ) );
+        event.setComment( effort.comment );
+        Q_ASSERT( event.duration() == effort.seconds );
+        event.toXml( writer );
+    }
+    writer.writeEndElement();
+}
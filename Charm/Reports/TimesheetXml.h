@@ -0,0 +1,43 @@
+/*
+  TimesheetXml.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TIMESHEETXML_H
+#define TIMESHEETXML_H
+
+#include "TimesheetInfo.h"
+
+#include "Core/CharmDataModelSnapshot.h"
+#include "Core/Event.h"
+
+class QXmlStreamWriter;
+
+/** The parts the weekly and the monthly time sheet XML have in common. */
+namespace TimesheetXml {
+    /** Writes the tasks element with the tasks of the time sheet. */
+    void writeTasks( QXmlStreamWriter& writer, const CharmDataModelSnapshot& snapshot,
+                     const TimeSheetInfoList& timeSheetInfo );
+    /** Writes the effort element: the events of the time sheet's tasks,
+        aggregated per task and day and moved to midnight UTC. */
+    void writeEffort( QXmlStreamWriter& writer, const TimeSheetInfoList& timeSheetInfo,
+                      const EventList& events );
+}
+
+#endif
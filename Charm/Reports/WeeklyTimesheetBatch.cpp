@@ -0,0 +1,118 @@
+/*
+  WeeklyTimesheetBatch.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "WeeklyTimesheetBatch.h"
+#include "WeeklyTimesheetXmlWriter.h"
+
+#include "Core/CharmExceptions.h"
+#include "Core/Dates.h"
+
+#include <QPair>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <algorithm>
+
+namespace {
+    class GenerateTimesheet : public QRunnable
+    {
+    public:
+        GenerateTimesheet( const CharmDataModelSnapshot& snapshot, const QString& userName, TaskId rootTask,
+                           const EventList& events, WeeklyTimesheetUpload* upload, QString* error )
+            : m_snapshot( snapshot )
+            , m_userName( userName )
+            , m_rootTask( rootTask )
+            , m_events( events )
+            , m_upload( upload )
+            , m_error( error )
+        {
+        }
+
+        void run() override
+        {
+            try {
+                WeeklyTimesheetXmlWriter timesheet;
+                timesheet.setSnapshot( m_snapshot );
+                timesheet.setUserName( m_userName );
+                timesheet.setYear( m_upload->year );
+                timesheet.setWeekNumber( m_upload->week );
+                timesheet.setRootTask( m_rootTask );
+                timesheet.setEvents( m_events );
+                m_upload->payload = timesheet.saveToXml();
+            } catch ( const XmlSerializationException& e ) {
+                *m_error = e.what();
+            }
+        }
+
+    private:
+        const CharmDataModelSnapshot m_snapshot;
+        const QString m_userName;
+        const TaskId m_rootTask;
+        const EventList m_events;
+        // every runnable writes to its own entries only:
+        WeeklyTimesheetUpload* m_upload;
+        QString* m_error;
+    };
+}
+
+QString WeeklyTimesheetBatch::fileName( int year, int week )
+{
+    return QStringLiteral( "WeeklyTimeSheet-%1-%2" ).arg( year ).arg( week, 2, 10, QLatin1Char('0') );
+}
+
+WeeklyTimesheetUploadList WeeklyTimesheetBatch::generate( const CharmDataModelSnapshot& snapshot, const QString& userName,
+                                                          TaskId rootTask, const WeeksByYear& weeks )
+{
+    WeeklyTimesheetUploadList uploads;
+    for ( auto it = weeks.constBegin(); it != weeks.constEnd(); ++it ) {
+        Q_FOREACH( int week, it.value() ) {
+            WeeklyTimesheetUpload upload;
+            upload.year = it.key();
+            upload.week = week;
+            upload.fileName = fileName( upload.year, upload.week );
+            uploads << upload;
+        }
+    }
+    std::sort( uploads.begin(), uploads.end(), []( const WeeklyTimesheetUpload& left, const WeeklyTimesheetUpload& right ) {
+        return qMakePair( left.year, left.week ) < qMakePair( right.year, right.week );
+    } );
+
+    // the time index only visits the days of the weeks:
+    QVector<EventList> events( uploads.size() );
+    for ( int i = 0; i < uploads.size(); ++i ) {
+        const QDate start = Charm::dateByWeekNumberAndWeekDay( uploads[i].year, uploads[i].week, 1 );
+        Q_FOREACH( EventId id, snapshot.eventsThatStartInTimeFrame( start, start.addDays( 7 ) ) )
+            events[i] << snapshot.eventForId( id );
+    }
+
+    QThreadPool pool;
+    QVector<QString> errors( uploads.size() );
+    for ( int i = 0; i < uploads.size(); ++i )
+        pool.start( new GenerateTimesheet( snapshot, userName, rootTask, events[i], &uploads[i], &errors[i] ) );
+    pool.waitForDone();
+
+    Q_FOREACH( const QString& error, errors ) {
+        if ( !error.isEmpty() )
+            throw XmlSerializationException( error );
+    }
+    return uploads;
+}
@@ -0,0 +1,56 @@
+/*
+  WeeklyTimesheetBatch.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef WEEKLYTIMESHEETBATCH_H
+#define WEEKLYTIMESHEETBATCH_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "Core/CharmDataModelSnapshot.h"
+
+/** Weeks by year, as returned by missingTimeSheets(). */
+typedef QHash<int, QVector<int> > WeeksByYear;
+
+/** The XML of one weekly time sheet, ready for upload. */
+struct WeeklyTimesheetUpload {
+    int year = 0;
+    int week = 0;
+    QString fileName;
+    QByteArray payload;
+};
+typedef QVector<WeeklyTimesheetUpload> WeeklyTimesheetUploadList;
+
+namespace WeeklyTimesheetBatch {
+    /** The file name the upload server expects for the time sheet. */
+    QString fileName( int year, int week );
+    /** Generates the time sheets of @p weeks for the tasks below
+        @p rootTask, sorted by year and week. The weeks are written in
+        parallel, the call returns when all of them are done.
+        @throws XmlSerializationException */
+    WeeklyTimesheetUploadList generate( const CharmDataModelSnapshot& snapshot, const QString& userName,
+                                        TaskId rootTask, const WeeksByYear& weeks );
+}
+
+#endif
@@ -23,12 +23,14 @@
 
 #include "WeeklyTimesheetXmlWriter.h"
 #include "TimesheetInfo.h"
+#include "TimesheetXml.h"
 #include "CharmCMake.h"
 
-#include "Core/CharmDataModel.h"
+#include "Core/CharmExceptions.h"
 #include <Core/XmlSerialization.h>
 
-#include <QDomDocument>
+#include <QBuffer>
+#include <QXmlStreamWriter>
 
 static const int DaysInWeek = 7;
 
@@ -36,9 +38,14 @@ WeeklyTimesheetXmlWriter::WeeklyTimesheetXmlWriter()
 {
 }
 
-void WeeklyTimesheetXmlWriter::setDataModel( const CharmDataModel* model )
+void WeeklyTimesheetXmlWriter::setSnapshot( const CharmDataModelSnapshot& snapshot )
 {
-    m_dataModel = model;
+    m_snapshot = snapshot;
+}
+
+void WeeklyTimesheetXmlWriter::setUserName( const QString& userName )
+{
+    m_userName = userName;
 }
 
 void WeeklyTimesheetXmlWriter::setYear( int year )
@@ -62,114 +69,40 @@ void WeeklyTimesheetXmlWriter::setRootTask( TaskId rootTask )
 }
 
 QByteArray WeeklyTimesheetXmlWriter::saveToXml() const
+{
+    QByteArray data;
+    QBuffer buffer( &data );
+    buffer.open( QIODevice::WriteOnly );
+    saveToXml( &buffer );
+    return data;
+}
+
+void WeeklyTimesheetXmlWriter::saveToXml( QIODevice* device ) const
 {
     // now create the report:
-    QDomDocument document = XmlSerialization::createXmlTemplate( QStringLiteral("weekly-timesheet") );
-
-    // find metadata and report element:
-    QDomElement root = document.documentElement();
-    QDomElement metadata = XmlSerialization::metadataElement( document );
-    QDomElement charmVersion = document.createElement( QStringLiteral("charmversion") );
-    QDomText charmVersionString = document.createTextNode( QStringLiteral(CHARM_VERSION) );
-    charmVersion.appendChild( charmVersionString );
-    metadata.appendChild( charmVersion );
-    QDomElement report = XmlSerialization::reportElement( document );
-    Q_ASSERT( !root.isNull() && !metadata.isNull() && !report.isNull() );
+    QXmlStreamWriter writer( device );
+    writer.setAutoFormatting( true );
+    writer.setAutoFormattingIndent( 4 );
+    XmlSerialization::writeXmlTemplateStart( writer, QStringLiteral("weekly-timesheet"), m_userName );
+    writer.writeTextElement( QStringLiteral("charmversion"), QStringLiteral(CHARM_VERSION) );
 
     // extend metadata tag: add year, and serial (week) number:
-    {
-        QDomElement yearElement = document.createElement( QStringLiteral("year") );
-        metadata.appendChild( yearElement );
-        QDomText text = document.createTextNode( QString::number( m_year ) );
-        yearElement.appendChild( text );
-        QDomElement weekElement = document.createElement( QStringLiteral("serial-number") );
-        weekElement.setAttribute( QStringLiteral("semantics"), QStringLiteral("week-number") );
-        metadata.appendChild( weekElement );
-        QDomText weektext = document.createTextNode( QString::number( m_weekNumber ) );
-        weekElement.appendChild( weektext );
-    }
-
-
-    typedef QMap< TaskId, QVector<int> > SecondsMap;
-    SecondsMap secondsMap;
-    TimeSheetInfoList timeSheetInfo = TimeSheetInfo::filteredTaskWithSubTasks(
-        TimeSheetInfo::taskWithSubTasks( m_dataModel, DaysInWeek, m_rootTask, secondsMap ),
-        false ); // here, we don't care about active or not, because we only report on the tasks
-
-    // extend report tag: add tasks and effort structure
-    {   // tasks
-        QDomElement tasks = document.createElement( QStringLiteral("tasks") );
-        report.appendChild( tasks );
-        Q_FOREACH ( const TimeSheetInfo& info, timeSheetInfo ) {
-            if ( info.taskId == 0 ) // the root task
-                continue;
-            const Task& modelTask = m_dataModel->getTask( info.taskId );
-            tasks.appendChild( modelTask.toXml( document ) );
-//             TaskId parentTask = DATAMODEL->parentItem( modelTask ).task().id();
-//             QDomElement task = document.createElement( "task" );
-//             task.setAttribute( "taskid", QString::number( info.taskId ) );
-//             if ( parentTask != 0 )
-//                 task.setAttribute( "parent", QString::number( parentTask ) );
-
-//             QDomText name = document.createTextNode( modelTask.name() );
-//             task.appendChild( name );
-//             tasks.appendChild( task );
-        }
-    }
-    {   // effort
-        // make effort element:
-        QDomElement effort = document.createElement( QStringLiteral("effort") );
-        report.appendChild( effort );
-
-        // aggregate (group by task and day):
-        typedef QPair<TaskId, QDate> Key;
-        QMap< Key, Event> events;
-        Q_FOREACH ( const Event& event, m_events ) {
-            TimeSheetInfoList::iterator it;
-            for ( it = timeSheetInfo.begin(); it != timeSheetInfo.end(); ++it )
-                if ( ( *it ).taskId == event.taskId() ) break;
-            if ( it == timeSheetInfo.end() )
-                continue;
-            Key key( event.taskId(), event.startDateTime().date() );
-            if ( events.contains( key ) ) {
-                // add to previous events:
-                const Event& oldEvent = events[key];
-                const int seconds = oldEvent.duration() + event.duration();
-                const QDateTime start = oldEvent.startDateTime();
-                const QDateTime end( start.addSecs( seconds ) );
-                Q_ASSERT( start.secsTo( end ) == seconds );
-                Event newEvent( oldEvent );
-                newEvent.setStartDateTime( start );
-                newEvent.setEndDateTime( end );
-                Q_ASSERT( newEvent.duration() == seconds );
-                QString comment = oldEvent.comment();
-                if ( ! event.comment().isEmpty() ) {
-                    if ( !comment.isEmpty() ) { // make separator
-                        comment += QLatin1String(" / ");
-                    }
-                    comment += event.comment();
-                    newEvent.setComment( comment );
-                }
-                events[key] = newEvent;
-            } else {
-                // add this event:
-                events[key] = event;
-                events[key].setId( -events[key].id() ); // "synthetic" :-)
-                // move to start at midnight in UTC (for privacy reasons)
-                // never, never, never use setTime() here, it breaks on DST changes! (twice a year)
-                QDateTime start( event.startDateTime().date(), QTime(0, 0, 0, 0), Qt::UTC );
-                QDateTime end( start.addSecs( event.duration() ) );
-                events[key].setStartDateTime( start );
-                events[key].setEndDateTime( end );
-                Q_ASSERT( events[key].duration() == event.duration() );
-                Q_ASSERT( start.time() == QTime(0, 0, 0, 0) );
-            }
-        }
-        // create elements:
-        Q_FOREACH ( const Event & event, events ) {
-            effort.appendChild( event.toXml( document ) );
-        }
-    }
-
-    return document.toByteArray( 4 );
+    writer.writeTextElement( QStringLiteral("year"), QString::number( m_year ) );
+    writer.writeStartElement( QStringLiteral("serial-number") );
+    writer.writeAttribute( QStringLiteral("semantics"), QStringLiteral("week-number") );
+    writer.writeCharacters( QString::number( m_weekNumber ) );
+    writer.writeEndElement();
+    writer.writeEndElement(); // metadata
+
+    // here, we don't care about active or not, because we only report on the tasks:
+    const TimeSheetInfoList timeSheetInfo = TimeSheetInfo::taskWithSubTasks( m_snapshot, DaysInWeek, m_rootTask, SecondsMap(), false );
+
+    // the report tag: add tasks and effort structure
+    writer.writeStartElement( QStringLiteral("report") );
+    TimesheetXml::writeTasks( writer, m_snapshot, timeSheetInfo );
+    TimesheetXml::writeEffort( writer, timeSheetInfo, m_events );
+    writer.writeEndDocument();
+
+    if ( writer.hasError() )
+        throw XmlSerializationException( QObject::tr( "Cannot write the time sheet: %1" ).arg( device->errorString() ) );
 }
@@ -24,11 +24,12 @@
 #ifndef WEEKLYTIMESHEETXMLWRITER_H
 #define WEEKLYTIMESHEETXMLWRITER_H
 
+#include "Core/CharmDataModelSnapshot.h"
 #include "Core/Event.h"
 #include "Core/Task.h"
 
 class QByteArray;
-class CharmDataModel;
+class QIODevice;
 
 class WeeklyTimesheetXmlWriter {
 public:
@@ -37,14 +38,22 @@ public:
      * @throws XmlSerializationException
      */
     QByteArray saveToXml() const;
+    /**
+     * Writes the time sheet to @p device, which has to be open for writing.
+     * @throws XmlSerializationException
+     */
+    void saveToXml( QIODevice* device ) const;
 
-    void setDataModel( const CharmDataModel* model);
+    void setSnapshot( const CharmDataModelSnapshot& snapshot );
+    /** The user name in the metadata, read on the GUI thread by the caller. */
+    void setUserName( const QString& userName );
     void setYear( int year );
     void setWeekNumber( int weekNumber );
     void setEvents( const EventList& events );
     void setRootTask( TaskId rootTask );
 private:
-    const CharmDataModel* m_dataModel = nullptr;
+    CharmDataModelSnapshot m_snapshot;
+    QString m_userName;
     int m_year = 0;
     int m_weekNumber = 0;
     TaskId m_rootTask = {};
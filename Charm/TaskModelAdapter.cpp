@@ -35,6 +35,7 @@
 
 #include <QApplication>
 #include <QPalette>
+#include <QSet>
 
 TaskModelAdapter::TaskModelAdapter( CharmDataModel* parent )
     : QAbstractItemModel()
@@ -73,23 +74,22 @@ QVariant TaskModelAdapter::data( const QModelIndex& index, int role ) const
 
     const TaskTreeItem* item = itemFor( index );
     const TaskId id = item->task().id();
-    const Event& activeEvent = m_dataModel->activeEventFor( id );
-    const bool isActive = activeEvent.isValid();
-    const QApplication* application = static_cast<QApplication*>( QApplication::instance() );
-    Q_ASSERT( application ); // we assume this code is executed in a GUI app
 
     // handle roles that are treated all the same, everywhere:
     switch( role ) {
     // problem: foreground role is never queried for
-    case Qt::ForegroundRole:
-        if( item->task().isCurrentlyValid() ) {
+    case Qt::ForegroundRole: {
+        const QApplication* application = static_cast<QApplication*>( QApplication::instance() );
+        Q_ASSERT( application ); // we assume this code is executed in a GUI app
+        if( m_dataModel->isTaskCurrentlyValid( id ) ) {
             return application->palette().color( QPalette::Active, QPalette::Text );
         } else {
             return application->palette().color( QPalette::Disabled, QPalette::Text );
         }
         break;
+    }
     case Qt::BackgroundRole:
-        if( item->task().isCurrentlyValid() ) {
+        if( m_dataModel->isTaskCurrentlyValid( id ) ) {
             return QVariant();
         } else {
             QColor color( "crimson" );
@@ -98,9 +98,9 @@ QVariant TaskModelAdapter::data( const QModelIndex& index, int role ) const
         }
         break;
     case Qt::DisplayRole:
-        return DATAMODEL->taskIdAndNameString( item->task().id() );
+        return displayData( item->task() ).idAndName;
     case Qt::DecorationRole:
-        if ( isActive ) {
+        if ( activeEventFor( id ).isValid() ) {
             return Data::activePixmap();
         } else {
             return QVariant();
@@ -118,14 +118,18 @@ QVariant TaskModelAdapter::data( const QModelIndex& index, int role ) const
     case TasksViewRole_Name: // now unused
         return item->task().name();
     case TasksViewRole_RunningTime:
-        return hoursAndMinutes( activeEvent.duration() );
+        return hoursAndMinutes( activeEventFor( id ).duration() );
     case TasksViewRole_TaskId:
         return id;
     case Qt::EditRole: // we edit the comment
     case TasksViewRole_UserComment:
-        return activeEvent.comment();
-    case TasksViewRole_Filter:
-        return DATAMODEL->taskIdAndFullNameString( item->task().id() );
+        return activeEventFor( id ).comment();
+    case TasksViewRole_Filter: {
+        DisplayData& data = displayData( item->task() );
+        if ( data.idAndFullName.isNull() )
+            data.idAndFullName = m_dataModel->taskIdAndFullNameString( id );
+        return data.idAndFullName;
+    }
     default:
         return QVariant();
     }
@@ -171,11 +175,9 @@ Qt::ItemFlags TaskModelAdapter::flags( const QModelIndex & index ) const
     if ( index.isValid() ) {
         const TaskTreeItem* item = itemFor( index );
         flags = Qt::ItemIsUserCheckable|Qt::ItemIsSelectable|Qt::ItemIsEnabled;
-        const bool isCurrent = item->task().isCurrentlyValid();
+        const bool isCurrent = m_dataModel->isTaskCurrentlyValid( item->task().id() );
         if ( isCurrent ) {
-            const TaskId id = item->task().id();
-            const Event& activeEvent = m_dataModel->activeEventFor( id );
-            const bool isActive = activeEvent.isValid();
+            const bool isActive = activeEventFor( item->task().id() ).isValid();
             if ( isActive ) {
                 flags |= Qt::ItemIsEditable;
             }
@@ -216,6 +218,7 @@ bool TaskModelAdapter::setData( const QModelIndex & index, const QVariant & valu
 void TaskModelAdapter::resetTasks()
 {
     beginResetModel();
+    m_displayData.clear();
     endResetModel();
 }
 
@@ -230,25 +233,52 @@ void TaskModelAdapter::taskAdded( TaskId )
     endInsertRows();
 }
 
-void TaskModelAdapter::taskParentChanged( TaskId task, TaskId oldParent, TaskId newParent )
+void TaskModelAdapter::taskParentAboutToChange( TaskId task, TaskId oldParent, TaskId newParent )
 {
-    // remove task from old parent:
+    // the task is appended to the children of the new parent:
     const TaskTreeItem& item = m_dataModel->taskTreeItem( task );
     const int row = item.row();
     const TaskTreeItem& oldParentItem = m_dataModel->taskTreeItem( oldParent );
-    beginRemoveRows( indexForTaskTreeItem( oldParentItem, 0 ), row, row );
-    // the actual remove happens in the data model
-    endRemoveRows();
-    // add task to new patent:
     const TaskTreeItem& newParentItem = m_dataModel->taskTreeItem( newParent );
-    const int pos = newParentItem.childCount();
-    beginInsertRows( indexForTaskTreeItem( newParentItem, 0 ), pos, pos );
-    // the actual insert happens in the data model
-    endInsertRows();
+    m_moveAccepted = beginMoveRows( indexForTaskTreeItem( oldParentItem, 0 ), row, row,
+                                    indexForTaskTreeItem( newParentItem, 0 ),
+                                    newParentItem.childCount() );
+}
+
+void TaskModelAdapter::taskParentChanged( TaskId, TaskId, TaskId )
+{
+    // the actual move happened in the data model
+    if ( m_moveAccepted ) {
+        endMoveRows();
+    } else {
+        // the views refused the move (moving a task below itself),
+        // fall back to a reset:
+        resetTasks();
+    }
+    m_moveAccepted = false;
 }
 
 
 void TaskModelAdapter::taskModified( TaskId id )
+{
+    m_displayData.remove( id );
+    // the full names of the subtasks contain the name of the task:
+    invalidateFullNamesBelow( m_dataModel->taskTreeItem( id ) );
+    taskRowChanged( id );
+}
+
+void TaskModelAdapter::invalidateFullNamesBelow( const TaskTreeItem& item )
+{
+    for ( int i = 0; i < item.childCount(); ++i ) {
+        const TaskTreeItem& child = item.child( i );
+        const auto it = m_displayData.find( child.task().id() );
+        if ( it != m_displayData.end() )
+            it->idAndFullName = QString();
+        invalidateFullNamesBelow( child );
+    }
+}
+
+void TaskModelAdapter::taskRowChanged( TaskId id )
 {
     const TaskTreeItem& item = m_dataModel->taskTreeItem( id );
     if ( item.isValid() ) {
@@ -268,32 +298,36 @@ void TaskModelAdapter::taskAboutToBeDeleted( TaskId id )
     beginRemoveRows( indexForTaskTreeItem( parent, 0 ), row, row );
 }
 
-void TaskModelAdapter::taskDeleted( TaskId )
+void TaskModelAdapter::taskDeleted( TaskId id )
 {
+    m_displayData.remove( id );
     endRemoveRows();
 }
 
+void TaskModelAdapter::resetEvents()
+{
+    m_activeEventsValid = false;
+}
+
 void TaskModelAdapter::eventAdded( EventId id )
 {
+    m_activeEventsValid = false;
     const Event& event = m_dataModel->eventForId( id );
-    taskModified( event.taskId() );
+    taskRowChanged( event.taskId() );
 }
 
-void TaskModelAdapter::eventModified( EventId id, Event )
+void TaskModelAdapter::eventModified( EventId id, Event oldEvent )
 {
+    // find out about what fields have actually changed, so that no
+    // ongoing edits are overridden (to fix till' s bug report)
+    // -- DF: we can't do that anymore, with a single column.
+    // see TasksViewDelegate::setEditorData for the fix.
+    m_activeEventsValid = false;
     const Event& event = m_dataModel->eventForId( id );
-    const TaskTreeItem& item = m_dataModel->taskTreeItem( event.taskId() );
-
-    if ( item.isValid() ) {
-        // find out about what fields have actually changed, so that no
-        // ongoing edits are overridden (to fix till' s bug report)
-        // -- DF: we can't do that anymore, with a single column.
-        // see TasksViewDelegate::setEditorData for the fix.
-
-        QModelIndex startIndex = indexForTaskTreeItem( item, 0 );
-        QModelIndex endIndex = indexForTaskTreeItem( item, Column_TaskId );
-        emit dataChanged( startIndex, endIndex );
-    }
+    taskRowChanged( event.taskId() );
+    // an event moved to another task changes both rows:
+    if ( oldEvent.taskId() != event.taskId() )
+        taskRowChanged( oldEvent.taskId() );
 }
 
 void TaskModelAdapter::eventDeleted( EventId id )
@@ -301,26 +335,77 @@ void TaskModelAdapter::eventDeleted( EventId id )
     eventAdded( id );
 }
 
+void TaskModelAdapter::eventsAdded( const EventIdList& ids )
+{
+    // notify every affected task once:
+    m_activeEventsValid = false;
+    QSet<TaskId> tasks;
+    Q_FOREACH( EventId id, ids )
+        tasks.insert( m_dataModel->eventForId( id ).taskId() );
+    Q_FOREACH( TaskId id, tasks )
+        taskRowChanged( id );
+}
+
+void TaskModelAdapter::eventsModified( const EventIdList& ids )
+{
+    eventsAdded( ids );
+}
+
 void TaskModelAdapter::eventActivated( EventId id )
 {
+    m_activeEventsValid = false;
     // query the model to find out the task:
     const Event& event = m_dataModel->eventForId( id );
     if ( event.isValid() ) {
-        taskModified( event.taskId() );
+        taskRowChanged( event.taskId() );
         emit eventActivationNotice( id );
     }
 }
 
 void TaskModelAdapter::eventDeactivated( EventId id )
 {
+    m_activeEventsValid = false;
     // query the model to find out the task:
     const Event& event = m_dataModel->eventForId( id );
     if ( event.isValid() ) {
-        taskModified( event.taskId() );
+        taskRowChanged( event.taskId() );
         emit eventDeactivationNotice( id );
     }
 }
 
+TaskModelAdapter::DisplayData& TaskModelAdapter::displayData( const Task& task ) const
+{
+    DisplayData& data = m_displayData[task.id()];
+    // a new id padding changes the strings of all tasks:
+    const int padding = CONFIGURATION.taskPaddingLength;
+    if ( data.idAndName.isNull() || data.padding != padding ) {
+        data = DisplayData();
+        data.padding = padding;
+        data.idAndName = m_dataModel->taskIdAndNameString( task.id() );
+    }
+    return data;
+}
+
+const Event& TaskModelAdapter::activeEventFor( TaskId id ) const
+{
+    if ( ! m_activeEventsValid ) {
+        m_activeEvents.clear();
+        // the first active event of a task wins, as in CharmDataModel::activeEventFor():
+        Q_FOREACH( EventId eventId, m_dataModel->activeEvents() ) {
+            const TaskId taskId = m_dataModel->eventForId( eventId ).taskId();
+            if ( ! m_activeEvents.contains( taskId ) )
+                m_activeEvents.insert( taskId, eventId );
+        }
+        m_activeEventsValid = true;
+    }
+    const auto it = m_activeEvents.constFind( id );
+    if ( it == m_activeEvents.constEnd() ) {
+        static Event InvalidEvent;
+        return InvalidEvent;
+    }
+    return m_dataModel->eventForId( it.value() );
+}
+
 const TaskTreeItem* TaskModelAdapter::itemFor ( const QModelIndex& index ) const
 {
     if ( index.isValid() ) {
@@ -26,6 +26,7 @@
 #define TASKMODELADAPTER_H
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QPointer>
 
 #include "Core/TaskModelInterface.h"
@@ -61,6 +62,7 @@ class TaskModelAdapter :  public QAbstractItemModel,
                           public CharmDataModelAdapterInterface
 {
     Q_OBJECT
+    friend class CharmDataModelTests;
 
 public:
     explicit TaskModelAdapter( CharmDataModel* parent );
@@ -81,16 +83,21 @@ public:
     void taskAboutToBeAdded( TaskId parent, int pos ) override;
     void taskAdded( TaskId id ) override;
     void taskModified( TaskId id ) override;
+    void taskParentAboutToChange( TaskId task, TaskId oldParent, TaskId newParent ) override;
     void taskParentChanged( TaskId task, TaskId oldParent, TaskId newParent ) override;
     void taskAboutToBeDeleted( TaskId ) override;
     void taskDeleted( TaskId id ) override;
 
-    void resetEvents() override {}
+    void resetEvents() override;
     void eventAboutToBeAdded( EventId ) override {}
     void eventAdded( EventId ) override;
     void eventModified( EventId, Event ) override;
     void eventAboutToBeDeleted( EventId ) override {}
     void eventDeleted( EventId ) override;
+    void eventsAdded( const EventIdList& ids ) override;
+    void eventsModified( const EventIdList& ids ) override;
+    // deleted events are never active, the task rows do not change:
+    void eventsDeleted( const EventIdList& ) override {}
 
     void eventActivated( EventId id ) override;
     void eventDeactivated( EventId id ) override;
@@ -111,10 +118,29 @@ Q_SIGNALS:
     void eventDeactivationNotice( EventId id ) override;
 
 private:
+    /** What the views ask for repeatedly, per task. Modifying a task
+        drops its entry and the full names of the tasks below it. */
+    struct DisplayData {
+        // the id padding the strings were made with:
+        int padding = 0;
+        QString idAndName;
+        QString idAndFullName;
+    };
+
     const TaskTreeItem* itemFor ( const QModelIndex& ) const;
     QModelIndex indexForTaskTreeItem( const TaskTreeItem& item, int column = 0 ) const;
+    DisplayData& displayData( const Task& task ) const;
+    const Event& activeEventFor( TaskId id ) const;
+    void taskRowChanged( TaskId id );
+    void invalidateFullNamesBelow( const TaskTreeItem& item );
 
     QPointer<CharmDataModel> m_dataModel;
+    // false if the current move could not be expressed as a row move:
+    bool m_moveAccepted = false;
+    mutable QHash<TaskId, DisplayData> m_displayData;
+    // the active event of every task, rebuilt after events changed:
+    mutable QHash<TaskId, EventId> m_activeEvents;
+    mutable bool m_activeEventsValid = false;
 };
 
 #endif
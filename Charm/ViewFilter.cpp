@@ -28,6 +28,7 @@
 
 ViewFilter::ViewFilter( CharmDataModel* model, QObject* parent )
     : QSortFilterProxyModel( parent )
+    , m_dataModel( model )
     , m_model( model )
 {
     setSourceModel( &m_model );
@@ -72,49 +73,127 @@ bool ViewFilter::taskHasChildren( const Task& task ) const
 
 void ViewFilter::prefilteringModeChanged()
 {
+    // task validity depends on the current date, check again:
+    m_acceptedValid = false;
     invalidate();
 }
 
 bool ViewFilter::filterAcceptsRow( int source_row, const QModelIndex& parent ) const
 {
-    // by default, QSortFilterProxyModel only accepts row where already the parents where accepted
-    bool acceptedByFilter = QSortFilterProxyModel::filterAcceptsRow( source_row, parent );
-    // in our case, this is not what we want, we want parents to be
-    // accepted if any of their children are accepted (this is a
-    // recursive call, and could possibly be slow):
     const QModelIndex index( m_model.index( source_row, 0, parent ) );
-    if ( ! index.isValid() ) return acceptedByFilter;
+    if ( ! index.isValid() )
+        return QSortFilterProxyModel::filterAcceptsRow( source_row, parent );
+
+    ensureAcceptedTasks();
+    return m_acceptedTasks.contains( m_model.taskForIndex( index ).id() );
+}
+
+void ViewFilter::ensureAcceptedTasks() const
+{
+    const FilterState state = currentFilterState();
+    if ( ! m_acceptedValid || ! ( m_acceptedState == state ) ) {
+        updateAcceptedTasks();
+        m_acceptedState = state;
+        m_acceptedValid = true;
+    }
+}
+
+void ViewFilter::setSearchText( const QString& text )
+{
+    if ( m_searchText == text )
+        return;
+    m_searchText = text;
+    invalidate();
+}
+
+QString ViewFilter::searchText() const
+{
+    return m_searchText;
+}
+
+TaskIdList ViewFilter::searchMatches() const
+{
+    if ( m_searchText.isEmpty() )
+        return TaskIdList();
+    ensureAcceptedTasks();
+    return m_searchMatches;
+}
+
+ViewFilter::FilterState ViewFilter::currentFilterState() const
+{
+    FilterState state;
+    state.regExp = filterRegExp();
+    state.searchText = m_searchText;
+    state.role = filterRole();
+    state.column = filterKeyColumn();
+    state.mode = Configuration::instance().taskPrefilteringMode;
+    state.taskGeneration = m_dataModel->taskGeneration();
+    return state;
+}
+
+bool ViewFilter::FilterState::operator==( const FilterState& other ) const
+{
+    return taskGeneration == other.taskGeneration && mode == other.mode
+        && role == other.role && column == other.column && regExp == other.regExp
+        && searchText == other.searchText;
+}
+
+void ViewFilter::updateAcceptedTasks() const
+{
+    m_searchMatches.clear();
+    m_searchMatchSet.clear();
+    if ( ! m_searchText.isEmpty() ) {
+        m_searchMatches = m_dataModel->searchTasks( m_searchText );
+        m_searchMatchSet = m_searchMatches.toSet();
+    }
 
-    int rowCount = m_model.rowCount( index );
+    m_acceptedTasks.clear();
+    const int rowCount = m_model.rowCount( QModelIndex() );
+    for ( int i = 0; i < rowCount; ++i )
+        collectAcceptedTasks( i, QModelIndex() );
+}
+
+bool ViewFilter::collectAcceptedTasks( int row, const QModelIndex& parent ) const
+{
+    const QModelIndex index( m_model.index( row, 0, parent ) );
+    const Task task = m_model.taskForIndex( index );
+    // by default, QSortFilterProxyModel only accepts row where already the parents where accepted
+    bool acceptedByFilter = m_searchText.isEmpty()
+        ? QSortFilterProxyModel::filterAcceptsRow( row, parent )
+        : m_searchMatchSet.contains( task.id() );
+    // in our case, this is not what we want, we want parents to be
+    // accepted if any of their children are accepted. The children are
+    // visited first, so every task is checked only once:
+    bool haveValidChild = false;
+    bool haveSubscribedChild = false;
+    const int rowCount = m_model.rowCount( index );
     for ( int i = 0; i < rowCount; ++i ) {
-        if ( filterAcceptsRow( i, index ) ) {
+        if ( collectAcceptedTasks( i, index ) )
             acceptedByFilter = true;
-            break;
-        }
+        const Task child = m_model.taskForIndex( m_model.index( i, 0, index ) );
+        haveValidChild |= m_dataModel->isTaskCurrentlyValid( child.id() );
+        haveSubscribedChild |= child.subscribed();
     }
 
     bool accepted = acceptedByFilter;
-    const Task task = m_model.taskForIndex( index );
     switch( Configuration::instance().taskPrefilteringMode ) {
     case Configuration::TaskPrefilter_ShowAll:
         break;
-    case Configuration::TaskPrefilter_CurrentOnly: {
-        const bool ok = ( task.isCurrentlyValid() || checkChildren( task, HaveValidChild ) );
-        accepted &= ok;
+    case Configuration::TaskPrefilter_CurrentOnly:
+        accepted &= ( m_dataModel->isTaskCurrentlyValid( task.id() ) || haveValidChild );
         break;
-    }
-    case Configuration::TaskPrefilter_SubscribedOnly: {
-        const bool ok = ( task.subscribed() || checkChildren( task, HaveSubscribedChild ) );
-        accepted &= ok;
+    case Configuration::TaskPrefilter_SubscribedOnly:
+        accepted &= ( task.subscribed() || haveSubscribedChild );
         break;
-    }
     case Configuration::TaskPrefilter_SubscribedAndCurrentOnly:
-        accepted &= ( (task.subscribed() || checkChildren( task, HaveSubscribedChild ) ) && ( task.isCurrentlyValid() || checkChildren( task, HaveValidChild ) ) );
+        accepted &= ( ( task.subscribed() || haveSubscribedChild ) && ( m_dataModel->isTaskCurrentlyValid( task.id() ) || haveValidChild ) );
         break;
     default:
         break;
     }
 
+    if ( accepted )
+        m_acceptedTasks.insert( task.id() );
     return accepted;
 }
 
@@ -128,20 +207,6 @@ bool ViewFilter::taskIdExists( TaskId taskId ) const
     return m_model.taskIdExists( taskId );
 }
 
-bool ViewFilter::checkChildren( Task task, CheckFor checkFor ) const
-{
-    if ( taskHasChildren( task ) ) {
-        const TaskList taskList = m_model.children( task );
-        for ( const Task& taskChild : taskList ) {
-            if ( checkFor == HaveSubscribedChild && taskChild.subscribed() )
-                return true;
-            else if ( checkFor == HaveValidChild && taskChild.isCurrentlyValid() )
-                return true;
-        }
-    }
-    return false;
-}
-
 void ViewFilter::commitCommand( CharmCommand* command )
 {   // we do not emit signals, we are the relay (since we are a proxy):
     m_model.commitCommand( command );
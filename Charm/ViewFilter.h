@@ -25,6 +25,8 @@
 #ifndef VIEWFILTER_H
 #define VIEWFILTER_H
 
+#include <QRegExp>
+#include <QSet>
 #include <QSortFilterProxyModel>
 
 #include "Core/Configuration.h"
@@ -56,6 +58,13 @@ public:
     // filter for subscriptions:
     void prefilteringModeChanged();
 
+    /** Shows the tasks found by CharmDataModel::searchTasks() instead of
+        matching the filter pattern. An empty text ends the search. */
+    void setSearchText( const QString& text );
+    QString searchText() const;
+    /** The tasks found for the search text, sorted by id. */
+    TaskIdList searchMatches() const;
+
     bool taskIdExists( TaskId taskId ) const override;
     void commitCommand( CharmCommand* ) override;
     bool filterAcceptsColumn( int source_column, const QModelIndex& source_parent ) const override;
@@ -66,13 +75,31 @@ Q_SIGNALS:
     void eventDeactivationNotice( EventId id ) override;
 
 private:
-    enum CheckFor {
-        HaveValidChild,
-        HaveSubscribedChild
+    /** What the accepted tasks were determined for. */
+    struct FilterState {
+        QRegExp regExp;
+        QString searchText;
+        int role = -1;
+        int column = -1;
+        Configuration::TaskPrefilteringMode mode = Configuration::TaskPrefilter_ShowAll;
+        quint64 taskGeneration = 0;
+        bool operator==( const FilterState& other ) const;
     };
 
-    bool checkChildren( Task task, CheckFor checkFor ) const;
+    FilterState currentFilterState() const;
+    void ensureAcceptedTasks() const;
+    void updateAcceptedTasks() const;
+    bool collectAcceptedTasks( int row, const QModelIndex& parent ) const;
+
+    CharmDataModel* m_dataModel;
     TaskModelAdapter m_model;
+    // the tasks accepted by the filter, determined in one bottom-up pass:
+    mutable QSet<TaskId> m_acceptedTasks;
+    QString m_searchText;
+    mutable TaskIdList m_searchMatches;
+    mutable QSet<TaskId> m_searchMatchSet;
+    mutable FilterState m_acceptedState;
+    mutable bool m_acceptedValid = false;
 };
 
 #endif
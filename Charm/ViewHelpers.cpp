@@ -23,7 +23,6 @@
 
 #include "ViewHelpers.h"
 
-#include <QtAlgorithms>
 #include <QFile>
 
 void Charm::connectControllerAndView( Controller* controller, CharmWindow* view )
@@ -39,34 +38,6 @@ void Charm::connectControllerAndView( Controller* controller, CharmWindow* view
                       view, SLOT(commitCommand(CharmCommand*)) );
 }
 
-struct StartsEarlier {
-    bool operator()( const EventId& leftId, const EventId& rightId ) const {
-        const Event& left = DATAMODEL->eventForId( leftId );
-        const Event& right = DATAMODEL->eventForId( rightId );
-        return left.startDateTime() < right.startDateTime();
-    }
-};
-
-EventIdList Charm::eventIdsSortedByStartTime( EventIdList ids )
-{
-    qStableSort( ids.begin(), ids.end(), StartsEarlier() );
-    return ids;
-}
-
-EventIdList Charm::filteredBySubtree( EventIdList ids, TaskId parent, bool exclude )
-{
-    EventIdList result;
-    bool isParent = false;
-    Q_FOREACH( EventId id, ids ) {
-        const Event& event = DATAMODEL->eventForId( id );
-        isParent = ( parent == event.taskId() || DATAMODEL->isParentOf( parent, event.taskId() ) );
-        if ( isParent != exclude ) {
-            result << id;
-        }
-    }
-    return result;
-}
-
 QString Charm::elidedTaskName( const QString& text, const QFont& font, int width )
 {
     QFontMetrics metrics( font );
@@ -37,10 +37,6 @@
 
 namespace Charm {
     void connectControllerAndView( Controller*, CharmWindow* );
-    EventIdList eventIdsSortedByStartTime( EventIdList );
-    /** Return those ids in the input list that elements of the subtree
-     * under the parent task, which includes the parent task. */
-    EventIdList filteredBySubtree( EventIdList, TaskId parent, bool exclude=false );
     QString elidedTaskName( const QString& text, const QFont& font, int width );
     QString reportStylesheet( const QPalette& palette );
 }
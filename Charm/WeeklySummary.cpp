@@ -27,6 +27,10 @@
 #include "Core/Event.h"
 #include "Core/Task.h"
 
+#include "Reports/TaskPivot.h"
+
+#include <algorithm>
+
 static const int DAYS_IN_WEEK = 7;
 
 WeeklySummary::WeeklySummary()
@@ -35,37 +39,63 @@ WeeklySummary::WeeklySummary()
 
 QVector<WeeklySummary> WeeklySummary::summariesForTimespan( CharmDataModel* dataModel, const TimeSpan& timespan )
 {
-    const EventIdList eventIds = dataModel->eventsThatStartInTimeFrame( timespan );
-    // prepare a list of unique task ids used within the time span:
-    TaskIdList taskIds, uniqueTaskIds; // the list of tasks to show
-    EventList events;
-    Q_FOREACH( EventId id, eventIds ) {
-        Event event = dataModel->eventForId( id );
-        events << event;
-        taskIds << event.taskId();
-    }
-    qSort( taskIds );
-    std::unique_copy( taskIds.begin(), taskIds.end(), std::back_inserter( uniqueTaskIds ) );
-    Q_ASSERT( events.size() == eventIds.size() );
-    // retrieve task information
-    QVector<WeeklySummary> summaries( uniqueTaskIds.size() );
-    for ( int i = 0; i < uniqueTaskIds.size(); ++i ) {
-        summaries[i].task = uniqueTaskIds.at( i );
-        const Task& task = dataModel->getTask( uniqueTaskIds[i] );
-        summaries[i].taskname = dataModel->fullTaskName( task );
-    }
-    // now add the times to the tasks:
-    Q_FOREACH( const Event& event, events ) {
-        // find the index for this event:
-        auto it = std::find( uniqueTaskIds.begin(), uniqueTaskIds.end(), event.taskId() );
-        if ( it != uniqueTaskIds.end() ) {
-            const int index = std::distance( uniqueTaskIds.begin(), it );
-            Q_ASSERT( index >= 0 && index < summaries.size() );
-            const int dayOfWeek = event.startDateTime().date().dayOfWeek() - 1;
-            Q_ASSERT( dayOfWeek >= 0 && dayOfWeek < 7 );
-            summaries[index].durations[dayOfWeek] += event.duration();
-        }
+    // the tasks to show are the ones with events in the time span:
+    TaskPivot pivot( TaskPivot::Buckets::custom( timespan.first, timespan.second, DAYS_IN_WEEK, []( const QDate& day ) {
+        return day.dayOfWeek() - 1;
+    } ) );
+    pivot.compute( dataModel );
+    // sorted by task id, the ancestors in the pivot have no events of their own:
+    const TaskIdList tasks = dataModel->durationRollup().tasksWithEvents( timespan.first, timespan.second );
+    QVector<WeeklySummary> summaries;
+    summaries.reserve( tasks.size() );
+    Q_FOREACH( TaskId task, tasks ) {
+        const int row = pivot.row( task );
+        if ( row < 0 )
+            continue;
+        WeeklySummary summary;
+        summary.task = task;
+        summary.taskname = dataModel->fullTaskName( dataModel->getTask( task ) );
+        for ( int day = 0; day < DAYS_IN_WEEK; ++day )
+            summary.durations[day] = pivot.seconds( row, day );
+        summaries << summary;
     }
 
     return summaries;
 }
+
+int WeeklySummary::updateSummaries( QVector<WeeklySummary>& summaries, CharmDataModel* dataModel,
+                                    const TimeSpan& timespan, TaskId task, const QDate& day )
+{
+    if ( day < timespan.first || day >= timespan.second )
+        return NoChange;
+
+    const DurationRollup& rollup = dataModel->durationRollup();
+    // the summaries are sorted by task id:
+    auto it = std::lower_bound( summaries.begin(), summaries.end(), task,
+                                []( const WeeklySummary& summary, TaskId id ) { return summary.task < id; } );
+    const bool found = it != summaries.end() && it->task == task;
+    const bool hasEvents = rollup.hasEvents( task, timespan.first, timespan.second );
+
+    if ( found && !hasEvents ) {
+        summaries.erase( it );
+        return RowsChanged;
+    } else if ( !found && hasEvents ) {
+        WeeklySummary summary;
+        summary.task = task;
+        summary.taskname = dataModel->fullTaskName( dataModel->getTask( task ) );
+        for ( QDate d = timespan.first; d < timespan.second; d = d.addDays( 1 ) )
+            summary.durations[d.dayOfWeek() - 1] += rollup.seconds( task, d );
+        summaries.insert( it, summary );
+        return RowsChanged;
+    } else if ( !found ) {
+        return NoChange;
+    }
+
+    const int dayOfWeek = day.dayOfWeek() - 1;
+    Q_ASSERT( dayOfWeek >= 0 && dayOfWeek < DAYS_IN_WEEK );
+    const int seconds = rollup.seconds( task, day );
+    if ( it->durations[dayOfWeek] == seconds )
+        return NoChange;
+    it->durations[dayOfWeek] = seconds;
+    return std::distance( summaries.begin(), it );
+}
@@ -37,6 +37,18 @@ class WeeklySummary
 public:
     static QVector<WeeklySummary> summariesForTimespan( CharmDataModel* dataModel, const TimeSpan& timespan );
 
+    /** Returned by updateSummaries() if no summary changed. */
+    static const int NoChange = -1;
+    /** Returned by updateSummaries() if a summary was added or removed. */
+    static const int RowsChanged = -2;
+    /** Update summaries after the events of task that start on day
+        changed. summaries must have been created by
+        summariesForTimespan() for the same time span. Only the affected
+        cell is read from the model.
+        Returns the index of the changed summary, NoChange or RowsChanged. */
+    static int updateSummaries( QVector<WeeklySummary>& summaries, CharmDataModel* dataModel,
+                                const TimeSpan& timespan, TaskId task, const QDate& day );
+
     WeeklySummary();
 
     TaskId task = {};
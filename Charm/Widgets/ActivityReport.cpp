@@ -29,20 +29,27 @@
 #include "SelectTaskDialog.h"
 #include "ViewHelpers.h"
 
+#include "Core/CharmDataModel.h"
 #include "Core/Configuration.h"
 #include "Core/Dates.h"
 
+#include "Reports/HtmlReportWriter.h"
+
 #include <QCalendarWidget>
-#include <QDomDocument>
-#include <QDomElement>
 #include <QFile>
 #include <QPushButton>
+#include <QSharedPointer>
 #include <QTimer>
-#include <QtAlgorithms>
 #include <QUrl>
+#include <QVector>
+
+#include <algorithm>
 
 #include "ui_ActivityReportConfigurationDialog.h"
 
+// the number of events on each page of the report:
+static const int EventsPerPage = 500;
+
 ActivityReportConfigurationDialog::ActivityReportConfigurationDialog( QWidget* parent )
     : ReportConfigurationDialog( parent )
     , m_ui( new Ui::ActivityReportConfigurationDialog )
@@ -237,31 +244,6 @@ void ActivityReport::timeSpanSelection( NamedTimeSpan timeSpanSelection )
 
 void ActivityReport::slotUpdate()
 {
-    // retrieve matching events:
-    EventIdList matchingEvents = DATAMODEL->eventsThatStartInTimeFrame( m_start, m_end );
-    
-    if( !m_rootTasks.isEmpty() ) {
-        QSet<EventId> filteredEvents;
-        Q_FOREACH( TaskId include,  m_rootTasks ) {
-           filteredEvents |= Charm::filteredBySubtree( matchingEvents, include ).toSet();
-        }
-        matchingEvents = filteredEvents.toList();
-    }
-    matchingEvents = Charm::eventIdsSortedByStartTime( matchingEvents );
-
-    // filter unproductive events:
-    Q_FOREACH( TaskId exclude,  m_rootExcludeTasks ) {
-        matchingEvents = Charm::filteredBySubtree( matchingEvents, exclude, true );
-    }
-
-    // calculate total:
-    int totalSeconds = 0;
-    Q_FOREACH( EventId id, matchingEvents ) {
-        const Event& event = DATAMODEL->eventForId( id );
-        Q_ASSERT( event.isValid() );
-        totalSeconds += event.duration();
-    }
-
     // which TimeSpan type
     QString timeSpanTypeName;
     switch( m_timeSpanSelection.timeSpanType ) {
@@ -284,140 +266,166 @@ void ActivityReport::slotUpdate()
         Q_ASSERT( false ); // should not happen
     }
 
-    auto report = new QTextDocument( this );
-    QDomDocument doc = createReportTemplate();
-    QDomElement root = doc.documentElement();
-    QDomElement body = root.firstChildElement( QStringLiteral("body") );
+    generateReport( reportJob( DATAMODEL, m_start, m_end, m_rootTasks, m_rootExcludeTasks, timeSpanTypeName ) );
+}
 
-    // create the caption:
-    {
-        QDomElement headline = doc.createElement( QStringLiteral("h1") );
-        QDomText text = doc.createTextNode( tr( "Activity Report" ) );
-        headline.appendChild( text );
-        body.appendChild( headline );
+ReportGenerator::Job ActivityReport::reportJob( const CharmDataModel* model, const QDate& start, const QDate& end,
+                                                const QSet<TaskId>& rootTasks, const QSet<TaskId>& rootExcludeTasks,
+                                                const QString& timeSpanTypeName )
+{
+    // the total comes from the rollup, without visiting the events. A
+    // task below another selected task is counted with its ancestor:
+    const auto isBelow = [model]( const QSet<TaskId>& parents, TaskId task ) {
+        Q_FOREACH( TaskId parent, parents ) {
+            if ( model->isParentOf( parent, task ) )
+                return true;
+        }
+        return false;
+    };
+    const DurationRollup& rollup = model->durationRollup();
+    int totalSeconds = rootTasks.isEmpty() ? rollup.subtreeSeconds( 0, start, end ) : 0;
+    Q_FOREACH( TaskId task, rootTasks ) {
+        if ( !isBelow( rootTasks, task ) && !rootExcludeTasks.contains( task ) && !isBelow( rootExcludeTasks, task ) )
+            totalSeconds += rollup.subtreeSeconds( task, start, end );
     }
-    {
-        QDomElement headline = doc.createElement( QStringLiteral("h3") );
-        QString content = tr( "Report for %1, from %2 to %3" )
-                          .arg( CONFIGURATION.user.name(),
-                                m_start.toString( Qt::TextDate ),
-                                m_end.toString( Qt::TextDate ) );
-        QDomText text = doc.createTextNode( content );
-        headline.appendChild( text );
-        body.appendChild( headline );
-        QDomElement previousLink = doc.createElement( QStringLiteral("a") );
-        previousLink.setAttribute( QStringLiteral("href") , QStringLiteral("Previous") );
-        QDomText previousLinkText = doc.createTextNode( tr( "<Previous %1>" ).arg( timeSpanTypeName ) );
-        previousLink.appendChild( previousLinkText );
-        body.appendChild( previousLink );
-        QDomElement nextLink = doc.createElement( QStringLiteral("a") );
-        nextLink.setAttribute( QStringLiteral("href") , QStringLiteral("Next") );
-        QDomText nextLinkText = doc.createTextNode( tr( "<Next %1>" ).arg( timeSpanTypeName ) );
-        nextLink.appendChild( nextLinkText );
-        body.appendChild( nextLink );
-        {
-            QDomElement paragraph = doc.createElement( QStringLiteral("h4") );
-            QString totalsText = tr( "Total: %1" ).arg( hoursAndMinutes( totalSeconds ) );
-            QDomText totalsElement = doc.createTextNode( totalsText );
-            paragraph.appendChild( totalsElement );
-            body.appendChild( paragraph );
+    Q_FOREACH( TaskId task, rootExcludeTasks ) {
+        if ( !isBelow( rootExcludeTasks, task ) && ( rootTasks.isEmpty() || isBelow( rootTasks, task ) ) )
+            totalSeconds -= rollup.subtreeSeconds( task, start, end );
+    }
+
+    // the report is made from a snapshot on a worker thread:
+    const QString userName = CONFIGURATION.user.name();
+    const int taskPaddingLength = CONFIGURATION.taskPaddingLength;
+    const Configuration::DurationFormat durationFormat = CONFIGURATION.durationFormat;
+    return [=]( const CharmDataModelSnapshot& snapshot, ReportGenerator::Control& control ) {
+        const auto inSubtrees = [&snapshot]( const QSet<TaskId>& parents, TaskId task ) {
+            Q_FOREACH( TaskId parent, parents ) {
+                if ( parent == task || snapshot.isParentOf( parent, task ) )
+                    return true;
+            }
+            return false;
+        };
+
+        // retrieve matching events, without the unproductive ones. The
+        // events stay valid as long as a copy of the snapshot exists:
+        typedef QVector<QPair<qint64, const Event*> > Rows;
+        QSharedPointer<Rows> matchingEvents( new Rows );
+        const EventIdList ids = snapshot.eventsThatStartInTimeFrame( start, end );
+        for ( int i = 0; i < ids.size(); ++i ) {
+            if ( control.isCanceled() )
+                return QString();
+            control.setProgress( i, ids.size() );
+            const Event& event = snapshot.eventForId( ids[i] );
+            Q_ASSERT( event.isValid() );
+            if ( !rootTasks.isEmpty() && !inSubtrees( rootTasks, event.taskId() ) )
+                continue;
+            if ( inSubtrees( rootExcludeTasks, event.taskId() ) )
+                continue;
+            matchingEvents->append( qMakePair( event.startDateTime( Qt::UTC ).toMSecsSinceEpoch(), &event ) );
         }
-        if ( !m_rootTasks.isEmpty() ) {
-            QDomElement paragraph = doc.createElement( QStringLiteral("p") );
-            QString rootTaskText = tr( "Activity under tasks:" );
+        std::stable_sort( matchingEvents->begin(), matchingEvents->end(),
+                          []( const QPair<qint64, const Event*>& left, const QPair<qint64, const Event*>& right ) {
+            return left.first < right.first;
+        } );
+        if ( control.isCanceled() )
+            return QString();
+
+        HtmlReportWriter writer;
 
-            Q_FOREACH( TaskId taskId, m_rootTasks ) {
-                const Task& task = DATAMODEL->getTask( taskId );
-                rootTaskText.append( QStringLiteral( " ( %1 ),").arg( DATAMODEL->fullTaskName( task ) ) );
+        // create the caption:
+        writer.textElement( QStringLiteral("h1"), tr( "Activity Report" ) );
+        {
+            QString content = tr( "Report for %1, from %2 to %3" )
+                              .arg( userName,
+                                    start.toString( Qt::TextDate ),
+                                    end.toString( Qt::TextDate ) );
+            writer.textElement( QStringLiteral("h3"), content );
+            writer.link( QStringLiteral("Previous"), tr( "<Previous %1>" ).arg( timeSpanTypeName ) );
+            writer.link( QStringLiteral("Next"), tr( "<Next %1>" ).arg( timeSpanTypeName ) );
+            writer.textElement( QStringLiteral("h4"), tr( "Total: %1" ).arg( hoursAndMinutes( totalSeconds, durationFormat ) ) );
+            if ( !rootTasks.isEmpty() ) {
+                QString rootTaskText = tr( "Activity under tasks:" );
+
+                Q_FOREACH( TaskId taskId, rootTasks ) {
+                    rootTaskText.append( QStringLiteral( " ( %1 ),").arg( snapshot.fullTaskName( taskId ) ) );
+                }
+                rootTaskText = rootTaskText.mid(0, rootTaskText.length() - 1 );
+                writer.textElement( QStringLiteral("p"), rootTaskText );
             }
-            rootTaskText = rootTaskText.mid(0, rootTaskText.length() - 1 );
-            QDomText rootText = doc.createTextNode( rootTaskText );
-            paragraph.appendChild( rootText );
-            body.appendChild( paragraph );
+
+            writer.emptyElement( QStringLiteral("br") );
         }
 
-        QDomElement paragraph = doc.createElement( QStringLiteral("br") );
-        body.appendChild( paragraph );
-    }
-    {
         const QString Headlines[] = {
             tr( "Date and Time, Task, Description" )
         };
         const int NumberOfColumns = sizeof Headlines / sizeof Headlines[0];
 
-        // now for a table
-        QDomElement table = doc.createElement( QStringLiteral("table") );
-        table.setAttribute( QStringLiteral("width"), QStringLiteral("100%") );
-        table.setAttribute( QStringLiteral("align"), QStringLiteral("left") );
-        table.setAttribute( QStringLiteral("cellpadding"), QStringLiteral("3") );
-        table.setAttribute( QStringLiteral("cellspacing"), QStringLiteral("0") );
-        body.appendChild( table );
-        // table header
-        QDomElement tableHead = doc.createElement( QStringLiteral("thead") );
-        table.appendChild( tableHead );
-        QDomElement headerRow = doc.createElement( QStringLiteral("tr") );
-        headerRow.setAttribute( QStringLiteral("class"), QStringLiteral("header_row") );
-        tableHead.appendChild( headerRow );
-        // column headers
-        for ( int i = 0; i < NumberOfColumns; ++i )
-        {
-            QDomElement header = doc.createElement( QStringLiteral("th") );
-            QDomText text = doc.createTextNode( Headlines[i] );
-            header.appendChild( text );
-            headerRow.appendChild( header );
-        }
-        QDomElement tableBody = doc.createElement( QStringLiteral("tbody") );
-        table.appendChild( tableBody );
-        // rows
-        Q_FOREACH( EventId id, matchingEvents ) {
-            const Event& event = DATAMODEL->eventForId( id );
-            Q_ASSERT( event.isValid() );
-            const TaskTreeItem& item = DATAMODEL->taskTreeItem( event.taskId() );
-            const Task& task = item.task();
-            Q_ASSERT( task.isValid() );
-
-            const auto paddedId = QStringLiteral("%1").arg( QString::number( task.id() ).trimmed(), Configuration::instance().taskPaddingLength, QLatin1Char('0') );
-
-            const QString row1Texts[] = {
-                tr( "%1 %2-%3 (%4) -- [%5] %6" )
-                .arg( event.startDateTime().date().toString( Qt::SystemLocaleShortDate ).trimmed(),
-                      event.startDateTime().time().toString( Qt::SystemLocaleShortDate ).trimmed(),
-                      event.endDateTime().time().toString( Qt::SystemLocaleShortDate ).trimmed(),
-                      hoursAndMinutes( event.duration() ),
-                      paddedId,
-                      task.name().trimmed() )
-            };
-
-            QDomElement row1 = doc.createElement( QStringLiteral("tr") );
-            row1.setAttribute( QStringLiteral("class"), QStringLiteral("event_attributes_row") );
-            QDomElement row2 = doc.createElement( QStringLiteral("tr") );
-            for ( int index = 0; index < NumberOfColumns; ++index ) {
-                QDomElement cell = doc.createElement( QStringLiteral("td") );
-                cell.setAttribute( QStringLiteral("class"), QStringLiteral("event_attributes") );
-                QDomText text = doc.createTextNode( row1Texts[index] );
-                cell.appendChild( text );
-                row1.appendChild( cell );
+        // writes the rows of the events in [from, to), also for the pages
+        // written later, on the GUI thread:
+        const CharmDataModelSnapshot pageSnapshot = snapshot;
+        const auto writeRows = [=]( HtmlReportWriter& page, int from, int to ) {
+            const HtmlReportWriter::Attributes attributesCell = {
+                { QStringLiteral("class"), QStringLiteral("event_attributes") } };
+            const HtmlReportWriter::Attributes descriptionCell = {
+                { QStringLiteral("class"), QStringLiteral("event_description") },
+                { QStringLiteral("align"), QStringLiteral("left") } };
+            for ( int i = from; i < to; ++i ) {
+                const Event& event = *matchingEvents->at( i ).second;
+                const Task& task = pageSnapshot.getTask( event.taskId() );
+                Q_ASSERT( task.isValid() );
+
+                const auto paddedId = QStringLiteral("%1").arg( QString::number( task.id() ).trimmed(), taskPaddingLength, QLatin1Char('0') );
+
+                const QString row1Texts[] = {
+                    tr( "%1 %2-%3 (%4) -- [%5] %6" )
+                    .arg( event.startDateTime().date().toString( Qt::SystemLocaleShortDate ).trimmed(),
+                          event.startDateTime().time().toString( Qt::SystemLocaleShortDate ).trimmed(),
+                          event.endDateTime().time().toString( Qt::SystemLocaleShortDate ).trimmed(),
+                          hoursAndMinutes( event.duration(), durationFormat ),
+                          paddedId,
+                          task.name().trimmed() )
+                };
+
+                page.beginRow( QStringLiteral("event_attributes_row") );
+                for ( int index = 0; index < NumberOfColumns; ++index )
+                    page.cell( row1Texts[index], attributesCell );
+                page.endElement();
+
+                page.beginRow();
+                page.beginElement( QStringLiteral("td"), descriptionCell );
+                page.textElement( QStringLiteral("pre"), event.comment() );
+                page.endElement(); // td
+                page.endElement(); // tr
             }
-            QDomElement cell2 = doc.createElement( QStringLiteral("td") );
-            cell2.setAttribute( QStringLiteral("class"), QStringLiteral("event_description") );
-            cell2.setAttribute( QStringLiteral("align"), QStringLiteral("left") );
-            QDomElement preElement = doc.createElement( QStringLiteral("pre") );
-            QDomText preText = doc.createTextNode( event.comment() );
-            preElement.appendChild( preText );
-            cell2.appendChild( preElement );
-            row2.appendChild( cell2 );
-
-            tableBody.appendChild( row1 );
-            tableBody.appendChild( row2 );
-        }
-    }
-
-    // NOTE: seems like the style sheet has to be set before the html
-    // code is pushed into the QTextDocument
-    report->setDefaultStyleSheet(Charm::reportStylesheet(palette()));
+        };
 
-    report->setHtml( doc.toString() );
-    setDocument( report );
+        // the first page has the caption and the table header:
+        writer.beginTable();
+        writer.beginElement( QStringLiteral("thead") );
+        writer.beginRow( QStringLiteral("header_row") );
+        for ( int i = 0; i < NumberOfColumns; ++i )
+            writer.headerCell( Headlines[i] );
+        writer.endElement(); // tr
+        writer.endElement(); // thead
+        writer.beginElement( QStringLiteral("tbody") );
+        writeRows( writer, 0, qMin( EventsPerPage, matchingEvents->size() ) );
+
+        // the other pages continue the table, they are only written
+        // once the user scrolls to them:
+        const int eventCount = matchingEvents->size();
+        const int morePages = qMax( 0, ( eventCount - 1 ) / EventsPerPage );
+        control.setMorePages( morePages, [=]( int pageNumber ) {
+            HtmlReportWriter page;
+            page.beginTable();
+            page.beginElement( QStringLiteral("tbody") );
+            const int begin = pageNumber * EventsPerPage;
+            writeRows( page, begin, qMin( begin + EventsPerPage, eventCount ) );
+            return page.finish();
+        } );
+
+        return writer.finish();
+    };
 }
 
 void ActivityReport::slotLinkClicked( const QUrl& which )
@@ -36,6 +36,7 @@ namespace Ui {
     class ActivityReportConfigurationDialog;
 }
 
+class CharmDataModel;
 class QUrl;
 
 class ActivityReportConfigurationDialog : public ReportConfigurationDialog
@@ -81,6 +82,13 @@ public:
         QSet<TaskId> rootTasks, QSet<TaskId> rootExcludeTasks );
     void timeSpanSelection( NamedTimeSpan timeSpanSelection );
 
+    /** The job that writes the report on a worker thread, 500 events
+        per page. The configuration and the total are read from @p model
+        when the job is made. */
+    static ReportGenerator::Job reportJob( const CharmDataModel* model, const QDate& start, const QDate& end,
+                                           const QSet<TaskId>& rootTasks, const QSet<TaskId>& rootExcludeTasks,
+                                           const QString& timeSpanTypeName );
+
 private Q_SLOTS:
     void slotLinkClicked( const QUrl& which );
 
@@ -22,6 +22,8 @@
 */
 
 #include "BillDialog.h"
+#include "HttpClient/HttpJob.h"
+
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QDialogButtonBox>
@@ -46,9 +48,12 @@ BillDialog::BillDialog( QWidget* parent, Qt::WindowFlags f )
     connect(m_alreadyDone, SIGNAL(clicked()), SLOT(slotAlreadyDone()));
     m_later = new QPushButton(QStringLiteral("Later"));
     connect(m_later, SIGNAL(clicked()), SLOT(slotLater()));
+    m_uploadAll = new QPushButton(QStringLiteral("Upload all"));
+    connect(m_uploadAll, SIGNAL(clicked()), SLOT(slotUploadAll()));
 
     auto layout = new QVBoxLayout(this);
     auto buttonBox = new QDialogButtonBox();
+    buttonBox->addButton(m_uploadAll, QDialogButtonBox::AcceptRole);
     buttonBox->addButton(m_asYouWish, QDialogButtonBox::YesRole);
     buttonBox->addButton(m_alreadyDone, QDialogButtonBox::NoRole);
     buttonBox->addButton(m_later, QDialogButtonBox::RejectRole);
@@ -60,6 +65,7 @@ void BillDialog::setReport(int year, int week)
     m_year = year;
     m_week = week;
     m_alreadyDone->setText(QStringLiteral("Already sent Week %1 (%2)").arg(week).arg(year));
+    m_uploadAll->setVisible(HttpJob::credentialsAvailable());
 }
 
 int BillDialog::year() const
@@ -87,4 +93,9 @@ void BillDialog::slotLater()
     done(Later);
 }
 
+void BillDialog::slotUploadAll()
+{
+    done(UploadAll);
+}
+
 #include "moc_BillDialog.cpp"
@@ -35,6 +35,7 @@ public:
         Later,
         AsYouWish,
         AlreadyDone,
+        UploadAll,
     };
     explicit BillDialog(QWidget* parent = nullptr, Qt::WindowFlags f = 0);
     void setReport(int year, int week);
@@ -44,10 +45,12 @@ private Q_SLOTS:
     void slotAsYouWish();
     void slotAlreadyDone();
     void slotLater();
+    void slotUploadAll();
 private:
     QPushButton *m_asYouWish;
     QPushButton *m_alreadyDone;
     QPushButton *m_later;
+    QPushButton *m_uploadAll;
     int m_year = 0;
     int m_week = 0;
 };
@@ -362,8 +362,8 @@ void EventView::timeFrameChanged( int index )
     if ( m_comboBox->count() == 0 ) return;
     if ( !m_model ) return;
     if ( index >= 0 && index < m_timeSpans.size() ) {
-        m_model->setFilterStartDate( m_timeSpans[index].timespan.first );
-        m_model->setFilterEndDate( m_timeSpans[index].timespan.second );
+        m_model->setFilterDates( m_timeSpans[index].timespan.first,
+                                 m_timeSpans[index].timespan.second );
     } else {
         Q_ASSERT( false );
     }
@@ -426,7 +426,7 @@ void EventView::slotEventIdChanged(int oldId, int newId)
 }
 
 void EventView::slotUpdateTotal()
-{   // what matching signal does the proxy emit?
+{
     int seconds = m_model->totalDuration();
     if ( seconds == 0 ) {
         m_labelTotal->clear();
@@ -446,6 +446,7 @@ void EventView::slotFindAndReplace()
         return;
 
     QList<Event> events = findAndReplace.modifiedEvents();
+    const EventBatch batch( DATAMODEL );
     for ( int i = 0; i < events.count(); ++i )
         slotEventChangesCompleted( events[i] );
 }
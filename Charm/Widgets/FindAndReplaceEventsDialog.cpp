@@ -72,8 +72,7 @@ FindAndReplaceEventsDialog::FindAndReplaceEventsDialog( QWidget* parent )
 
     m_model.reset( new EventModelFilter( DATAMODEL ) );
     m_ui->findAndReplaceLV->setModel( m_model.data() );
-    m_model->setFilterStartDate( m_timeSpan.first );
-    m_model->setFilterEndDate( m_timeSpan.second );
+    m_model->setFilterDates( m_timeSpan.first, m_timeSpan.second );
 
     auto delegate = new EventEditorDelegate( m_model.data(), m_ui->findAndReplaceLV );
     m_ui->findAndReplaceLV->setItemDelegate( delegate );
@@ -113,9 +112,8 @@ void FindAndReplaceEventsDialog::slotTimeSpansChanged()
 {
     m_timeSpan.first = m_ui->dateEditStart->date();
     m_timeSpan.second = m_ui->dateEditEnd->date();
-    m_model->setFilterStartDate( m_timeSpan.first );
     // add a day as the timespan logic in charm excludes events on the end date.
-    m_model->setFilterEndDate( m_timeSpan.second.addDays( 1 ) );
+    m_model->setFilterDates( m_timeSpan.first, m_timeSpan.second.addDays( 1 ) );
     if ( m_taskToSearch > 0 )
         searchProjectCode();
 }
@@ -22,6 +22,7 @@
 */
 
 #include "MonthlyTimesheet.h"
+#include "Reports/TaskPivot.h"
 #include "Reports/MonthlyTimesheetXmlWriter.h"
 
 #include <QFile>
@@ -78,45 +79,27 @@ QString MonthlyTimeSheetReport::suggestedFileName() const
     return tr( "MonthlyTimeSheet-%1-%2" ).arg( m_yearOfMonth ).arg( m_monthNumber, 2, 10, QLatin1Char('0') );
 }
 
-QByteArray MonthlyTimeSheetReport::saveToText()
+QString MonthlyTimeSheetReport::caption() const
 {
-    QByteArray output;
-    QTextStream stream( &output );
-    QString content = tr( "Report for %1, %2 %3 (%4 to %5)" )
-                      .arg( CONFIGURATION.user.name(),
-                            QDate::longMonthName( m_monthNumber ),
-                            QString::number( startDate().year() ),
-                            startDate().toString( Qt::TextDate ),
-                            endDate().addDays( -1 ).toString( Qt::TextDate ) );
-    stream << content << '\n';
-    stream << '\n';
-    TimeSheetInfoList timeSheetInfo = TimeSheetInfo::filteredTaskWithSubTasks(
-        TimeSheetInfo::taskWithSubTasks( DATAMODEL, m_numberOfWeeks, rootTask(), secondsMap() ),
-        activeTasksOnly() );
-
-    TimeSheetInfo totalsLine( m_numberOfWeeks );
-    if ( ! timeSheetInfo.isEmpty() ) {
-        totalsLine = timeSheetInfo.first();
-        if( rootTask() == 0 ) {
-            timeSheetInfo.removeAt( 0 ); // there is always one, because there is always the root item
-        }
-    }
-
-    for ( int i = 0; i < timeSheetInfo.size(); ++i ) {
-        stream << timeSheetInfo[i].formattedTaskIdAndName( CONFIGURATION.taskPaddingLength ) << "\t" << hoursAndMinutes( timeSheetInfo[i].total() ) << '\n';
-    }
-    stream << '\n';
-    stream << "Month total: " << hoursAndMinutes( totalsLine.total() ) << '\n';
-    stream.flush();
+    return tr( "Report for %1, %2 %3 (%4 to %5)" )
+           .arg( CONFIGURATION.user.name(),
+                 QDate::longMonthName( m_monthNumber ),
+                 QString::number( startDate().year() ),
+                 startDate().toString( Qt::TextDate ),
+                 endDate().addDays( -1 ).toString( Qt::TextDate ) );
+}
 
-    return output;
+QByteArray MonthlyTimeSheetReport::saveToText()
+{
+    return timeSheetText( TaskPivot::Buckets::weeks( startDate(), endDate() ), caption(), QStringLiteral( "Month total: " ) );
 }
 
 QByteArray MonthlyTimeSheetReport::saveToXml()
 {
     try {
         MonthlyTimesheetXmlWriter timesheet;
-        timesheet.setDataModel( DATAMODEL );
+        timesheet.setSnapshot( DATAMODEL->snapshot() );
+        timesheet.setUserName( CONFIGURATION.user.name() );
         timesheet.setMonthNumber( m_monthNumber );
         timesheet.setYearOfMonth( m_yearOfMonth );
         timesheet.setNumberOfWeeks( m_numberOfWeeks );
@@ -136,170 +119,30 @@ QByteArray MonthlyTimeSheetReport::saveToXml()
     return QByteArray();
 }
 
-static QDomElement addTblHdr( QDomElement &toRow, const QString &text )
-{
-    QDomElement header = toRow.ownerDocument().createElement( QStringLiteral("th") );
-    QDomText textNode = toRow.ownerDocument().createTextNode( text );
-    header.appendChild( textNode );
-    toRow.appendChild( header );
-    return header;
-}
-
-static QDomElement addTblCell( QDomElement &toRow, const QString &text )
-{
-    QDomElement cell = toRow.ownerDocument().createElement( QStringLiteral("td") );
-    cell.setAttribute( QStringLiteral("align"), QStringLiteral("center") );
-    QDomText textNode = toRow.ownerDocument().createTextNode( text );
-    cell.appendChild( textNode );
-    toRow.appendChild( cell );
-    return cell;
-}
-
 void MonthlyTimeSheetReport::update()
 {
     // this creates the time sheet
-    // retrieve matching events:
-    const EventIdList matchingEvents = DATAMODEL->eventsThatStartInTimeFrame( startDate(), endDate() );
-
-    m_secondsMap.clear();
-
-    // for every task, make a vector that includes a number of seconds
-    // for every week of a month ( int seconds[m_numberOfWeeks]), and store those in
-    // a map by their task id
-    Q_FOREACH( EventId id, matchingEvents ) {
-        const Event& event = DATAMODEL->eventForId( id );
-        QVector<int> seconds( m_numberOfWeeks );
-        if ( m_secondsMap.contains( event.taskId() ) ) {
-            seconds = m_secondsMap.value(event.taskId());
-        }
-        // what week of the month is the event (normalized to vector indexes):
-        const int weekOfMonth = Charm::weekDifference( startDate(), event.startDateTime().date() );
-        seconds[weekOfMonth] += event.duration();
-        // store in minute map:
-        m_secondsMap[event.taskId()] = seconds;
-    }
-    // now the reporting:
-    // headline first:
-    QTextDocument report;
-    QDomDocument doc = createReportTemplate();
-    QDomElement root = doc.documentElement();
-    QDomElement body = root.firstChildElement( QStringLiteral("body") );
-
-//     QTextCursor cursor( m_report );
-    // create the caption:
-    {
-        QDomElement headline = doc.createElement( QStringLiteral("h1") );
-        QDomText text = doc.createTextNode( tr( "Monthly Time Sheet" ) );
-        headline.appendChild( text );
-        body.appendChild( headline );
-    }
-    {
-        QDomElement headline = doc.createElement( QStringLiteral("h3") );
-        QString content = tr( "Report for %1, %2 %3 (%4 to %5)" )
-                          .arg( CONFIGURATION.user.name(),
-                                QDate::longMonthName( m_monthNumber ),
-                                QString::number( startDate().year() ),
-                                startDate().toString( Qt::TextDate ),
-                                endDate().addDays( -1 ).toString( Qt::TextDate ) );
-        QDomText text = doc.createTextNode( content );
-        headline.appendChild( text );
-        body.appendChild( headline );
-        QDomElement previousLink = doc.createElement( QStringLiteral("a") );
-        previousLink.setAttribute( QStringLiteral("href") , QStringLiteral("Previous") );
-        QDomText previousLinkText = doc.createTextNode( tr( "<Previous Month>" ) );
-        previousLink.appendChild( previousLinkText );
-        body.appendChild( previousLink );
-        QDomElement nextLink = doc.createElement( QStringLiteral("a") );
-        nextLink.setAttribute( QStringLiteral("href") , QStringLiteral("Next") );
-        QDomText nextLinkText = doc.createTextNode( tr( "<Next Month>" ) );
-        nextLink.appendChild( nextLinkText );
-        body.appendChild( nextLink );
-        QDomElement paragraph = doc.createElement( QStringLiteral("br") );
-        body.appendChild( paragraph );
-    }
-    {
-        // now for a table
-        // retrieve the information for the report:
-        // TimeSheetInfoList timeSheetInfo = taskWithSubTasks( m_rootTask, m_secondsMap );
-        TimeSheetInfoList timeSheetInfo = TimeSheetInfo::filteredTaskWithSubTasks(
-            TimeSheetInfo::taskWithSubTasks( DATAMODEL, m_numberOfWeeks, rootTask(), secondsMap() ),
-            activeTasksOnly() );
-
-        QDomElement table = doc.createElement( QStringLiteral("table") );
-        table.setAttribute( QStringLiteral("width"), QStringLiteral("100%") );
-        table.setAttribute( QStringLiteral("align"), QStringLiteral("left") );
-        table.setAttribute( QStringLiteral("cellpadding"), QStringLiteral("3") );
-        table.setAttribute( QStringLiteral("cellspacing"), QStringLiteral("0") );
-        body.appendChild( table );
-
-        TimeSheetInfo totalsLine( m_numberOfWeeks );
-        if ( ! timeSheetInfo.isEmpty() ) {
-            totalsLine = timeSheetInfo.first();
-            if( rootTask() == 0 ) {
-                timeSheetInfo.removeAt( 0 ); // there is always one, because there is always the root item
-            }
-        }
-
-        {   //Header Row
-            QDomElement headerRow = doc.createElement( QStringLiteral("tr") );
-            headerRow.setAttribute( QStringLiteral("class"), QStringLiteral("header_row") );
-            table.appendChild( headerRow );
-            addTblHdr( headerRow, tr( "Task" ) );
-            for ( int i = 0; i < m_numberOfWeeks; ++i )
-                addTblHdr( headerRow, tr( "Week" ) );
-            addTblHdr( headerRow, tr( "Total" ) );
-            addTblHdr( headerRow, tr( "Days" ) );
-        }
-
-        {   //Header day row
-            QDomElement headerDayRow = doc.createElement( QStringLiteral("tr") );
-            headerDayRow.setAttribute( QStringLiteral("class"), QStringLiteral("header_row") );
-            table.appendChild( headerDayRow );
-            addTblHdr( headerDayRow, QString() );
-            for ( int i = 0; i < m_numberOfWeeks; ++i ) {
-                QString label = tr("%1").arg(startDate().addDays( i * 7 ).weekNumber(), 2, 10, QLatin1Char('0') );
-                addTblHdr( headerDayRow, label );
-            }
-            addTblHdr( headerDayRow, QString() );
-            addTblHdr( headerDayRow, QString::number(m_dailyhours) + tr(" hours") );
-        }
-
-        for ( int i = 0; i < timeSheetInfo.size(); ++i )
-        {
-            QDomElement row = doc.createElement( QStringLiteral("tr") );
-            if (i % 2)
-                row.setAttribute( QStringLiteral("class"), QStringLiteral("alternate_row") );
-            table.appendChild( row );
-
-            QDomElement taskCell = addTblCell( row, timeSheetInfo[i].formattedTaskIdAndName( CONFIGURATION.taskPaddingLength ) );
-            taskCell.setAttribute( QStringLiteral("align"), QStringLiteral("left") );
-            taskCell.setAttribute( QStringLiteral("style"), QStringLiteral( "text-indent: %1px;" )
-                                            .arg( 9 * timeSheetInfo[i].indentation ) );
-            for ( int week = 0; week < m_numberOfWeeks; ++week )
-                addTblCell( row, hoursAndMinutes( timeSheetInfo[i].seconds[week] ) );
-            addTblCell( row, hoursAndMinutes( timeSheetInfo[i].total() ) );
-            addTblCell( row, QString::number( timeSheetInfo[i].total() / SecondsInDay, 'f', 1) );
-        }
-
-        {   // Totals row
-            QDomElement totals = doc.createElement( QStringLiteral("tr") );
-            totals.setAttribute( QStringLiteral("class"), QStringLiteral("header_row") );
-            table.appendChild( totals );
-
-            addTblHdr( totals, tr( "Total:" ) );
-            for ( int i = 0; i < m_numberOfWeeks; ++i )
-                addTblHdr( totals, hoursAndMinutes( totalsLine.seconds[i] ) );
-            addTblHdr( totals, hoursAndMinutes( totalsLine.total() ) );
-            addTblHdr( totals, QString::number( totalsLine.total() / SecondsInDay, 'f', 1) );
-        }
+    // for every task, the seconds for every week of the month:
+    const TaskPivot::Buckets weeks = TaskPivot::Buckets::weeks( startDate(), endDate() );
+    Q_ASSERT( weeks.count() == m_numberOfWeeks );
+    Layout layout;
+    layout.heading = tr( "Monthly Time Sheet" );
+    layout.caption = caption();
+    layout.previousLink = tr( "<Previous Month>" );
+    layout.nextLink = tr( "<Next Month>" );
+    QStringList header;
+    QStringList weekHeader;
+    header << tr( "Task" );
+    weekHeader << QString();
+    for ( int i = 0; i < m_numberOfWeeks; ++i ) {
+        header << tr( "Week" );
+        weekHeader << tr("%1").arg( startDate().addDays( i * 7 ).weekNumber(), 2, 10, QLatin1Char('0') );
     }
-
-    // NOTE: seems like the style sheet has to be set before the html
-    // code is pushed into the QTextDocument
-    report.setDefaultStyleSheet(Charm::reportStylesheet(palette()));
-
-    report.setHtml( doc.toString() );
-    setDocument( &report );
+    header << tr( "Total" ) << tr( "Days" );
+    weekHeader << QString() << QString::number( m_dailyhours ) + tr(" hours");
+    layout.headerRows << header << weekHeader;
+    layout.secondsInDay = SecondsInDay;
+    generateTimeSheet( weeks, layout );
     uploadButton()->setVisible(false);
     uploadButton()->setEnabled(false);
 }
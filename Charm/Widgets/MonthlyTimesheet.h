@@ -47,6 +47,7 @@ private Q_SLOTS:
     void slotLinkClicked( const QUrl& which );
 
 private:
+    QString caption() const;
     QString suggestedFileName() const override;
     void update() override;
     QByteArray saveToText() override;
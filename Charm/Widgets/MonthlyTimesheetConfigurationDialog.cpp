@@ -23,10 +23,7 @@
 
 #include "MonthlyTimesheetConfigurationDialog.h"
 
-#include <QSettings>
-
 #include "DateEntrySyncer.h"
-#include "SelectTaskDialog.h"
 #include "ViewHelpers.h"
 
 #include "CharmCMake.h"
@@ -36,7 +33,7 @@
 #include "ui_MonthlyTimesheetConfigurationDialog.h"
 
 MonthlyTimesheetConfigurationDialog::MonthlyTimesheetConfigurationDialog( QWidget* parent )
-    : ReportConfigurationDialog( parent )
+    : TimeSheetConfigurationDialog( parent )
     , m_ui( new Ui::MonthlyTimesheetConfigurationDialog )
 {
     setWindowTitle( tr( "Monthly Timesheet" ) );
@@ -47,12 +44,9 @@ MonthlyTimesheetConfigurationDialog::MonthlyTimesheetConfigurationDialog( QWidge
 
     connect( m_ui->comboBoxMonth, SIGNAL(currentIndexChanged(int)),
              SLOT(slotMonthComboItemSelected(int)) );
-    connect( m_ui->toolButtonSelectTask, SIGNAL(clicked()),
-             SLOT(slotSelectTask()) );
-    connect( m_ui->checkBoxSubTasksOnly, SIGNAL(toggled(bool)),
-             SLOT(slotCheckboxSubtasksOnlyChecked(bool)) );
     m_ui->comboBoxMonth->setCurrentIndex( 1 );
-    slotCheckboxSubtasksOnlyChecked( m_ui->checkBoxSubTasksOnly->isChecked() );
+    setTaskWidgets( m_ui->checkBoxSubTasksOnly, m_ui->labelTaskName,
+                    m_ui->toolButtonSelectTask, m_ui->checkBoxActiveOnly );
 
     slotStandardTimeSpansChanged();
     connect( ApplicationCore::instance().dateChangeWatcher(),
@@ -62,14 +56,6 @@ MonthlyTimesheetConfigurationDialog::MonthlyTimesheetConfigurationDialog( QWidge
     // set current month and year:
     m_ui->spinBoxMonth->setValue(QDate::currentDate().month());
     m_ui->spinBoxYear->setValue(QDate::currentDate().year());
-
-    // load settings:
-    QSettings settings;
-    if ( settings.contains( MetaKey_TimesheetActiveOnly ) ) {
-        m_ui->checkBoxActiveOnly->setChecked( settings.value( MetaKey_TimesheetActiveOnly ).toBool() );
-    } else {
-        m_ui->checkBoxActiveOnly->setChecked( true );
-    }
 }
 
 MonthlyTimesheetConfigurationDialog::~MonthlyTimesheetConfigurationDialog()
@@ -83,18 +69,6 @@ void MonthlyTimesheetConfigurationDialog::setDefaultMonth(int yearOfMonth, int m
     m_ui->comboBoxMonth->setCurrentIndex(4);
 }
 
-void MonthlyTimesheetConfigurationDialog::accept()
-{
-    // save settings:
-    QSettings settings;
-    settings.setValue( MetaKey_TimesheetActiveOnly,
-                       m_ui->checkBoxActiveOnly->isChecked() );
-    settings.setValue( MetaKey_TimesheetRootTask,
-                       m_rootTask );
-
-    QDialog::accept();
-}
-
 void MonthlyTimesheetConfigurationDialog::showReportPreviewDialog()
 {
     QDate start, end;
@@ -107,41 +81,11 @@ void MonthlyTimesheetConfigurationDialog::showReportPreviewDialog()
         start = m_monthInfo[index].timespan.first;
         end = m_monthInfo[index].timespan.second;
     }
-    bool activeOnly = m_ui->checkBoxActiveOnly->isChecked();
     auto report = new MonthlyTimeSheetReport();
-    report->setReportProperties( start, end, m_rootTask, activeOnly );
+    report->setReportProperties( start, end, rootTask(), activeTasksOnly() );
     report->show();
 }
 
-void MonthlyTimesheetConfigurationDialog::showEvent( QShowEvent* )
-{
-    QSettings settings;
-
-    // we only want to do this once a backend is loaded, and we ignore
-    // the saved root task if it does not exist anymore
-    if ( settings.contains( MetaKey_TimesheetRootTask ) ) {
-        TaskId root = settings.value( MetaKey_TimesheetRootTask ).toInt();
-        const TaskTreeItem& item = DATAMODEL->taskTreeItem( root );
-        if ( item.isValid() ) {
-            m_rootTask = root;
-            m_ui->labelTaskName->setText( DATAMODEL->fullTaskName( item.task() ) );
-            m_ui->checkBoxSubTasksOnly->setChecked( true );
-        }
-    }
-}
-
-void MonthlyTimesheetConfigurationDialog::slotCheckboxSubtasksOnlyChecked( bool checked )
-{
-    if ( checked && m_rootTask == 0 ) {
-        slotSelectTask();
-    }
-
-    if ( ! checked ) {
-        m_rootTask = 0;
-        m_ui->labelTaskName->setText( tr( "(All Tasks)" ) );
-    }
-}
-
 void MonthlyTimesheetConfigurationDialog::slotStandardTimeSpansChanged()
 {
     const TimeSpans timeSpans;
@@ -173,17 +117,3 @@ void MonthlyTimesheetConfigurationDialog::slotMonthComboItemSelected( int index
         m_ui->groupBox->setEnabled( false );
     }
 }
-
-void MonthlyTimesheetConfigurationDialog::slotSelectTask()
-{
-    SelectTaskDialog dialog( this );
-    dialog.setNonTrackableSelectable();
-    if ( dialog.exec() ) {
-        m_rootTask = dialog.selectedTask();
-        const TaskTreeItem& item = DATAMODEL->taskTreeItem( m_rootTask );
-        m_ui->labelTaskName->setText( DATAMODEL->fullTaskName( item.task() ) );
-    } else {
-        if ( m_rootTask == 0 )
-            m_ui->checkBoxSubTasksOnly->setChecked( false );
-    }
-}
@@ -27,13 +27,13 @@
 #include <Core/Task.h>
 #include <Core/TimeSpans.h>
 
-#include "ReportConfigurationDialog.h"
+#include "Timesheet.h"
 
 #include <QScopedPointer>
 
 namespace Ui { class MonthlyTimesheetConfigurationDialog; }
 
-class MonthlyTimesheetConfigurationDialog : public ReportConfigurationDialog
+class MonthlyTimesheetConfigurationDialog : public TimeSheetConfigurationDialog
 {
     Q_OBJECT
 
@@ -42,22 +42,15 @@ public:
     ~MonthlyTimesheetConfigurationDialog() override;
 
     void showReportPreviewDialog() override;
-    void showEvent( QShowEvent* ) override;
     void setDefaultMonth( int yearOfMonth, int month );
 
-public Q_SLOTS:
-    void accept() override;
-
 private Q_SLOTS:
-    void slotCheckboxSubtasksOnlyChecked( bool );
     void slotStandardTimeSpansChanged();
     void slotMonthComboItemSelected( int );
-    void slotSelectTask();
 
 private:
     QScopedPointer<Ui::MonthlyTimesheetConfigurationDialog> m_ui;
     QList<NamedTimeSpan> m_monthInfo;
-    TaskId m_rootTask;
 };
 
 #endif
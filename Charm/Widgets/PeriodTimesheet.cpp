@@ -0,0 +1,113 @@
+/*
+  PeriodTimesheet.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "PeriodTimesheet.h"
+#include "Reports/TaskPivot.h"
+
+#include <QPushButton>
+#include <QUrl>
+
+#include "ViewHelpers.h"
+
+PeriodTimeSheetReport::PeriodTimeSheetReport( Period period, QWidget* parent )
+    : TimeSheetReport( parent )
+    , m_period( period )
+{
+    connect( this, SIGNAL(anchorClicked(QUrl)), SLOT(slotLinkClicked(QUrl)) );
+    // there is no time sheet format to export quarters and years to:
+    saveToXmlButton()->setVisible( false );
+    uploadButton()->setVisible( false );
+    uploadButton()->setEnabled( false );
+}
+
+PeriodTimeSheetReport::~PeriodTimeSheetReport()
+{
+}
+
+TimeSpan PeriodTimeSheetReport::period( Period period, const QDate& date )
+{
+    if ( period == Quarter ) {
+        const QDate start( date.year(), ( date.month() - 1 ) / 3 * 3 + 1, 1 );
+        return TimeSpan( start, start.addMonths( 3 ) );
+    }
+    const QDate start( date.year(), 1, 1 );
+    return TimeSpan( start, start.addYears( 1 ) );
+}
+
+QString PeriodTimeSheetReport::title() const
+{
+    if ( m_period == Quarter )
+        return tr( "Q%1 %2" ).arg( ( startDate().month() - 1 ) / 3 + 1 ).arg( startDate().year() );
+    return QString::number( startDate().year() );
+}
+
+QString PeriodTimeSheetReport::suggestedFileName() const
+{
+    if ( m_period == Quarter )
+        return tr( "QuarterlyTimeSheet-%1-Q%2" ).arg( startDate().year() ).arg( ( startDate().month() - 1 ) / 3 + 1 );
+    return tr( "YearlyTimeSheet-%1" ).arg( startDate().year() );
+}
+
+QString PeriodTimeSheetReport::caption() const
+{
+    return tr( "Report for %1, %2 (%3 to %4)" )
+           .arg( CONFIGURATION.user.name(),
+                 title(),
+                 startDate().toString( Qt::TextDate ),
+                 endDate().addDays( -1 ).toString( Qt::TextDate ) );
+}
+
+QByteArray PeriodTimeSheetReport::saveToText()
+{
+    return timeSheetText( TaskPivot::Buckets::months( startDate(), endDate() ), caption(), QStringLiteral( "Total: " ) );
+}
+
+QByteArray PeriodTimeSheetReport::saveToXml()
+{
+    return QByteArray();
+}
+
+void PeriodTimeSheetReport::update()
+{
+    // the seconds for every month of the period:
+    const TaskPivot::Buckets months = TaskPivot::Buckets::months( startDate(), endDate() );
+    Layout layout;
+    layout.heading = m_period == Quarter ? tr( "Quarterly Time Sheet" ) : tr( "Yearly Time Sheet" );
+    layout.caption = caption();
+    layout.previousLink = m_period == Quarter ? tr( "<Previous Quarter>" ) : tr( "<Previous Year>" );
+    layout.nextLink = m_period == Quarter ? tr( "<Next Quarter>" ) : tr( "<Next Year>" );
+    QStringList header;
+    header << tr( "Task" );
+    for ( int i = 0; i < months.count(); ++i )
+        header << QDate::shortMonthName( months.firstDay( i ).month() );
+    header << tr( "Total" );
+    layout.headerRows << header;
+    generateTimeSheet( months, layout );
+}
+
+void PeriodTimeSheetReport::slotLinkClicked( const QUrl& which )
+{
+    const int months = m_period == Quarter ? 3 : 12;
+    const int direction = which.toString() == QLatin1String("Previous") ? -1 : 1;
+    const TimeSpan span = period( m_period, startDate().addMonths( direction * months ) );
+    setReportProperties( span.first, span.second, rootTask(), activeTasksOnly() );
+}
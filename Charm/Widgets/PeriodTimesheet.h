@@ -0,0 +1,66 @@
+/*
+  PeriodTimesheet.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef PERIODTIMESHEET_H
+#define PERIODTIMESHEET_H
+
+#include <Core/Task.h>
+#include <Core/TimeSpans.h>
+
+#include "Timesheet.h"
+
+class QUrl;
+
+/** A time sheet over a quarter or a year, one column per month. */
+class PeriodTimeSheetReport : public TimeSheetReport
+{
+    Q_OBJECT
+
+public:
+    enum Period {
+        Quarter,
+        Year
+    };
+
+    explicit PeriodTimeSheetReport( Period period, QWidget* parent = nullptr );
+    ~PeriodTimeSheetReport() override;
+
+    /** The quarter or year @p date is in. */
+    static TimeSpan period( Period period, const QDate& date );
+
+private Q_SLOTS:
+    void slotLinkClicked( const QUrl& which );
+
+private:
+    QString title() const;
+    QString caption() const;
+    QString suggestedFileName() const override;
+    void update() override;
+    QByteArray saveToText() override;
+    QByteArray saveToXml() override;
+
+private:
+    // properties of the report:
+    Period m_period;
+};
+
+#endif
@@ -0,0 +1,99 @@
+/*
+  PeriodTimesheetConfigurationDialog.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "PeriodTimesheetConfigurationDialog.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QToolButton>
+
+#include "ViewHelpers.h"
+
+PeriodTimesheetConfigurationDialog::PeriodTimesheetConfigurationDialog( PeriodTimeSheetReport::Period period, QWidget* parent )
+    : TimeSheetConfigurationDialog( parent )
+    , m_period( period )
+    , m_comboBoxPeriod( new QComboBox )
+{
+    setWindowTitle( period == PeriodTimeSheetReport::Quarter ? tr( "Quarterly Timesheet" ) : tr( "Yearly Timesheet" ) );
+
+    auto subTasksOnly = new QCheckBox( tr( "Subtasks of:" ) );
+    auto taskName = new QLabel( tr( "(All Tasks)" ) );
+    auto activeOnly = new QCheckBox( tr( "Active tasks only" ) );
+    auto selectTask = new QToolButton;
+    selectTask->setText( tr( "..." ) );
+    auto taskLayout = new QHBoxLayout;
+    taskLayout->addWidget( taskName, 1 );
+    taskLayout->addWidget( selectTask );
+
+    auto buttonBox = new QDialogButtonBox( QDialogButtonBox::Ok | QDialogButtonBox::Cancel );
+    buttonBox->button( QDialogButtonBox::Ok )->setText( tr( "Report" ) );
+
+    auto layout = new QFormLayout( this );
+    layout->addRow( period == PeriodTimeSheetReport::Quarter ? tr( "Quarter:" ) : tr( "Year:" ), m_comboBoxPeriod );
+    layout->addRow( subTasksOnly, taskLayout );
+    layout->addRow( activeOnly );
+    layout->addRow( buttonBox );
+
+    connect( buttonBox, SIGNAL(accepted()), this, SLOT(accept()) );
+    connect( buttonBox, SIGNAL(rejected()), this, SLOT(reject()) );
+    setTaskWidgets( subTasksOnly, taskName, selectTask, activeOnly );
+
+    slotStandardTimeSpansChanged();
+    connect( ApplicationCore::instance().dateChangeWatcher(),
+             SIGNAL(dateChanged()),
+             SLOT(slotStandardTimeSpansChanged()) );
+}
+
+PeriodTimesheetConfigurationDialog::~PeriodTimesheetConfigurationDialog()
+{
+}
+
+void PeriodTimesheetConfigurationDialog::showReportPreviewDialog()
+{
+    const TimeSpan span = m_periods.value( m_comboBoxPeriod->currentIndex() );
+    auto report = new PeriodTimeSheetReport( m_period );
+    report->setReportProperties( span.first, span.second, rootTask(), activeTasksOnly() );
+    report->show();
+}
+
+void PeriodTimesheetConfigurationDialog::slotStandardTimeSpansChanged()
+{
+    const QDate today = QDate::currentDate();
+    const int months = m_period == PeriodTimeSheetReport::Quarter ? 3 : 12;
+    const QStringList names = m_period == PeriodTimeSheetReport::Quarter
+        ? QStringList { tr( "This Quarter" ), tr( "Last Quarter" ), tr( "The Quarter Before Last Quarter" ) }
+        : QStringList { tr( "This Year" ), tr( "Last Year" ), tr( "The Year Before Last Year" ) };
+    m_periods.clear();
+    m_comboBoxPeriod->clear();
+    for ( int i = 0; i < names.size(); ++i ) {
+        const TimeSpan span = PeriodTimeSheetReport::period( m_period, today.addMonths( -i * months ) );
+        m_periods << span;
+        m_comboBoxPeriod->addItem( names[i] );
+    }
+    // Set current index to the last period as that's what you'll usually want
+    m_comboBoxPeriod->setCurrentIndex( 1 );
+}
@@ -29,6 +29,9 @@
 #include <QPrintDialog>
 #endif
 
+#include <QScrollBar>
+#include <QTextCursor>
+
 #include "ui_ReportPreviewWindow.h"
 
 ReportPreviewWindow::ReportPreviewWindow( QWidget* parent )
@@ -54,6 +57,16 @@ ReportPreviewWindow::ReportPreviewWindow( QWidget* parent )
     m_ui->pushButtonPrint->setEnabled(false);
 #endif
 
+    m_ui->progressBar->hide();
+    connect( &m_generator, SIGNAL(progress(int)),
+             SLOT(slotReportProgress(int)) );
+    connect( &m_generator, SIGNAL(finished(QString,int)),
+             SLOT(slotReportGenerated(QString,int)) );
+    connect( m_ui->textBrowser->verticalScrollBar(), SIGNAL(valueChanged(int)),
+             SLOT(slotFetchMorePages()) );
+    connect( m_ui->textBrowser->verticalScrollBar(), SIGNAL(rangeChanged(int,int)),
+             SLOT(slotFetchMorePages()) );
+
     m_updateTimer.setInterval(60 * 1000);
     m_updateTimer.start();
     connect( &m_updateTimer, SIGNAL(timeout()),
@@ -68,6 +81,7 @@ ReportPreviewWindow::~ReportPreviewWindow()
 
 void ReportPreviewWindow::setDocument( const QTextDocument* document )
 {
+    m_nextPage = m_pageCount = 0;
     if ( document != nullptr ) {
         // we keep a copy, to be able to show different versions of the same document
         QScopedPointer<QTextDocument> docClone( document->clone() );
@@ -79,24 +93,13 @@ void ReportPreviewWindow::setDocument( const QTextDocument* document )
     }
 }
 
-QDomDocument ReportPreviewWindow::createReportTemplate() const
+void ReportPreviewWindow::appendHtml( const QString& html )
 {
-    // create XHTML v1.0 structure:
-    QDomDocument doc( QStringLiteral("html") );
-    // FIXME this is only a rudimentary subset of a valid xhtml 1 document
-
-    // html element
-    QDomElement html = doc.createElement( QStringLiteral("html") );
-    html.setAttribute( QStringLiteral("xmlns"), QStringLiteral("http://www.w3.org/1999/xhtml") );
-    doc.appendChild( html );
-
-    // head and body, children of html
-    QDomElement head = doc.createElement( QStringLiteral("head") );
-    html.appendChild( head );
-    QDomElement body = doc.createElement( QStringLiteral("body") );
-    html.appendChild( body );
-
-    return doc;
+    if ( !m_document )
+        return;
+    QTextCursor cursor( m_document.data() );
+    cursor.movePosition( QTextCursor::End );
+    cursor.insertHtml( html );
 }
 
 QPushButton* ReportPreviewWindow::saveToXmlButton() const
@@ -114,6 +117,47 @@ QPushButton* ReportPreviewWindow::uploadButton() const
     return m_ui->pushButtonUpload;
 }
 
+void ReportPreviewWindow::generateReport( const ReportGenerator::Job& job )
+{
+    // busy indicator until the job reports progress:
+    m_ui->progressBar->setRange( 0, 0 );
+    m_ui->progressBar->show();
+    m_generator.start( DATAMODEL->snapshot(), job );
+}
+
+void ReportPreviewWindow::slotReportProgress( int percent )
+{
+    m_ui->progressBar->setRange( 0, 100 );
+    m_ui->progressBar->setValue( percent );
+}
+
+void ReportPreviewWindow::slotReportGenerated( const QString& html, int morePages )
+{
+    m_ui->progressBar->hide();
+    m_nextPage = m_pageCount = 0;
+
+    QScopedPointer<QTextDocument> report( new QTextDocument );
+    // NOTE: seems like the style sheet has to be set before the html
+    // code is pushed into the QTextDocument
+    report->setDefaultStyleSheet( Charm::reportStylesheet( palette() ) );
+    report->setHtml( html );
+    // no need to clone the document, nobody else uses it:
+    m_ui->textBrowser->setDocument( report.data() );
+    m_document.swap( report );
+    m_nextPage = 1;
+    m_pageCount = morePages;
+    slotFetchMorePages();
+}
+
+void ReportPreviewWindow::slotFetchMorePages()
+{
+    // write and add the next page once the user scrolled close to the end:
+    const QScrollBar* scrollBar = m_ui->textBrowser->verticalScrollBar();
+    if ( m_nextPage > 0 && m_nextPage <= m_pageCount
+         && scrollBar->value() >= scrollBar->maximum() - scrollBar->pageStep() )
+        appendHtml( m_generator.page( m_nextPage++ ) );
+}
+
 void ReportPreviewWindow::slotSaveToXml()
 {
 }
@@ -125,6 +169,11 @@ void ReportPreviewWindow::slotSaveToText()
 void ReportPreviewWindow::slotPrint()
 {
 #ifndef QT_NO_PRINTER
+    if ( !m_document ) // the report is still being generated
+        return;
+    // the printout contains the whole report:
+    while ( m_nextPage > 0 && m_nextPage <= m_pageCount )
+        appendHtml( m_generator.page( m_nextPage++ ) );
     QPrinter printer;
     QPrintDialog dialog( &printer, this );
 
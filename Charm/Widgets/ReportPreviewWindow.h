@@ -25,11 +25,12 @@
 #define REPORTPREVIEWWINDOW_H
 
 #include <QDialog>
-#include <QDomDocument>
 #include <QScopedPointer>
 #include <QTextDocument>
 #include <QTimer>
 
+#include "Reports/ReportGenerator.h"
+
 namespace Ui {
     class ReportPreviewWindow;
 }
@@ -49,10 +50,16 @@ Q_SIGNALS:
 
 protected:
     void setDocument( const QTextDocument* document );
-    QDomDocument createReportTemplate() const;
+    /** Adds @p html to the end of the shown document. */
+    void appendHtml( const QString& html );
     QPushButton* saveToXmlButton() const;
     QPushButton* saveToTextButton() const;
     QPushButton* uploadButton() const;
+    /** Runs @p job on a snapshot of the data model in the background,
+        and shows the resulting HTML when it is done. Further pages of the
+        report are written and added when the user scrolls to the end. A newer request
+        cancels the one in flight. */
+    void generateReport( const ReportGenerator::Job& job );
 
     QTimer m_updateTimer;
 
@@ -62,10 +69,17 @@ private Q_SLOTS:
     virtual void slotPrint();
     virtual void slotUpdate();
     virtual void slotClose();
+    void slotReportProgress( int percent );
+    void slotReportGenerated( const QString& html, int morePages );
+    void slotFetchMorePages();
 
 private:
     QScopedPointer<Ui::ReportPreviewWindow> m_ui;
     QScopedPointer<QTextDocument> m_document;
+    ReportGenerator m_generator;
+    // the next page of the report to show, from 1 to m_pageCount:
+    int m_nextPage = 0;
+    int m_pageCount = 0;
 };
 
 #endif
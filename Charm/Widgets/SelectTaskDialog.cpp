@@ -29,6 +29,8 @@
 #include <QPushButton>
 #include <QSettings>
 
+#include <limits>
+
 #include "ui_SelectTaskDialog.h"
 
 SelectTaskDialogProxy::SelectTaskDialogProxy( CharmDataModel* model, QObject* parent )
@@ -38,9 +40,41 @@ SelectTaskDialogProxy::SelectTaskDialogProxy( CharmDataModel* model, QObject* pa
     setFilterKeyColumn( Column_TaskId );
     setFilterCaseSensitivity( Qt::CaseInsensitive );
     setFilterRole( TasksViewRole_Filter );
+
+    // a task's rank is the sum of its positions in the MRU and MFU lists,
+    // a task missing in one list counts as behind the end of it, so that
+    // tasks in both lists rank higher:
+    const TaskIdList mru = model->mostRecentlyUsedTasks();
+    const TaskIdList mfu = model->mostFrequentlyUsedTasks();
+    for ( int i = 0; i < mru.size(); ++i )
+        m_taskRanks.insert( mru[i], i + mfu.size() );
+    for ( int i = 0; i < mfu.size(); ++i ) {
+        const auto it = m_taskRanks.find( mfu[i] );
+        if ( it != m_taskRanks.end() )
+            it.value() += i - mfu.size();
+        else
+            m_taskRanks.insert( mfu[i], mru.size() + i );
+    }
+
     prefilteringModeChanged();
 }
 
+int SelectTaskDialogProxy::taskRank( TaskId id ) const
+{
+    return m_taskRanks.value( id, std::numeric_limits<int>::max() );
+}
+
+bool SelectTaskDialogProxy::lessThan( const QModelIndex& left, const QModelIndex& right ) const
+{
+    if ( searchText().isEmpty() )
+        return ViewFilter::lessThan( left, right );
+    const int leftRank = taskRank( sourceModel()->data( left, TasksViewRole_TaskId ).toInt() );
+    const int rightRank = taskRank( sourceModel()->data( right, TasksViewRole_TaskId ).toInt() );
+    if ( leftRank != rightRank )
+        return leftRank < rightRank;
+    return ViewFilter::lessThan( left, right );
+}
+
 bool SelectTaskDialogProxy::filterAcceptsColumn( int column, const QModelIndex& ) const
 {
     return column == Column_TaskId;
@@ -155,7 +189,7 @@ void SelectTaskDialog::slotCurrentItemChanged( const QModelIndex& first,
         m_ui->taskStatusLB->clear();
     } else {
         m_selectedTask = 0;
-        const bool expired = !task.isCurrentlyValid();
+        const bool expired = !DATAMODEL->isTaskCurrentlyValid( task.id() );
         const bool trackable = task.trackable();
         const bool notTrackableAndExpired = ( !trackable && expired );
         const QString expirationDate = QLocale::system().toString( task.validUntil(), QLocale::ShortFormat );
@@ -175,7 +209,7 @@ bool SelectTaskDialog::isValidAndTrackable( const QModelIndex& index ) const
         return false;
     const Task task = m_proxy.taskForIndex( index );
 
-    const bool taskValid = m_nonValidSelectable || (task.isValid() && task.isCurrentlyValid());
+    const bool taskValid = m_nonValidSelectable || (task.isValid() && DATAMODEL->isTaskCurrentlyValid( task.id() ));
 
     if ( m_nonTrackableSelectable ) {
         return taskValid;
@@ -197,11 +231,33 @@ void SelectTaskDialog::slotFilterTextChanged( const QString& text )
     filtertext.replace( QLatin1Char(' '), QLatin1Char('*') );
 
     Charm::saveExpandStates( m_ui->treeView, &m_expansionStates );
-    m_proxy.setFilterWildcard( filtertext );
-    if (!filtertext.isEmpty())
+    // the search index answers as the user types:
+    m_proxy.setSearchText( filtertext );
+    if (!filtertext.isEmpty()) {
         m_ui->treeView->expandAll();
-    else
+        selectBestMatch();
+    } else {
         Charm::restoreExpandStates( m_ui->treeView, &m_expansionStates );
+    }
+}
+
+void SelectTaskDialog::selectBestMatch()
+{
+    // the selectable match with the best rank becomes the current task:
+    QModelIndex best;
+    int bestRank = 0;
+    Q_FOREACH( TaskId id, m_proxy.searchMatches() ) {
+        const int rank = m_proxy.taskRank( id );
+        if ( best.isValid() && rank >= bestRank )
+            continue;
+        const QModelIndex index = m_proxy.indexForTaskId( id );
+        if ( isValidAndTrackable( index ) ) {
+            best = index;
+            bestRank = rank;
+        }
+    }
+    if ( best.isValid() )
+        m_ui->treeView->setCurrentIndex( best );
 }
 
 void SelectTaskDialog::slotAccepted()
@@ -47,8 +47,17 @@ public:
     Qt::ItemFlags flags( const QModelIndex & index ) const override;
     QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
 
+    /** The rank of a task, lower is better. Tasks without rank come last. */
+    int taskRank( TaskId id ) const;
+
 protected:
     bool filterAcceptsColumn( int column, const QModelIndex& parent ) const override;
+    // while searching, the most used tasks come first:
+    bool lessThan( const QModelIndex& left, const QModelIndex& right ) const override;
+
+private:
+    // ranks by most recent and most frequent use:
+    QHash<TaskId, int> m_taskRanks;
 };
 
 class SelectTaskDialog : public QDialog
@@ -80,6 +89,7 @@ private Q_SLOTS:
 
 private:
     bool isValidAndTrackable( const QModelIndex& index ) const;
+    void selectBestMatch();
 
 private:
     QScopedPointer<Ui::SelectTaskDialog> m_ui;
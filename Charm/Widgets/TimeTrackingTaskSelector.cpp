@@ -165,7 +165,7 @@ void TimeTrackingTaskSelector::populate( const QVector<WeeklySummary>& summaries
             break;
 
         TaskId id = interestingTasks.takeFirst();
-        if( !addedTasks.contains( id ) && DATAMODEL->getTask(id).isCurrentlyValid() )
+        if( !addedTasks.contains( id ) && DATAMODEL->isTaskCurrentlyValid( id ) )
             interestingTasksToAdd.append( id );
     }
 
@@ -223,7 +223,7 @@ void TimeTrackingTaskSelector::handleActiveEvents()
         m_stopGoAction->setText( tr( "Start Task" ) );
         if( m_selectedTask != 0 ) {
             const Task& task = DATAMODEL->getTask( m_selectedTask );
-            m_stopGoAction->setEnabled( task.isCurrentlyValid() );
+            m_stopGoAction->setEnabled( DATAMODEL->isTaskCurrentlyValid( task.id() ) );
         } else {
             m_stopGoAction->setEnabled( false );
         }
@@ -238,7 +238,7 @@ void TimeTrackingTaskSelector::slotActionSelected( QAction* action )
     TaskId taskId = action->property( CUSTOM_TASK_PROPERTY_NAME ).value<TaskId>();
     const Task& task = DATAMODEL->getTask( taskId );
     if ( task.isValid() ) {
-        bool expired = !task.isCurrentlyValid();
+        bool expired = !DATAMODEL->isTaskCurrentlyValid( task.id() );
         bool trackable = task.trackable();
         bool notTrackableAndExpired = ( !trackable && expired );
         const auto id = QString::number( task.id() );
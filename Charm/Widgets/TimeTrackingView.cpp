@@ -31,6 +31,7 @@
 #include <QFont>
 #include <QFontMetrics>
 #include <QMessageBox>
+#include <QPixmap>
 #include <QPaintEvent>
 #include <QPainter>
 
@@ -39,6 +40,8 @@
 #include <numeric>
 
 const int Margin = 2;
+// a few rows for a couple of widths:
+const int MaxElidedTexts = 256;
 
 TimeTrackingView::TimeTrackingView( QWidget* parent )
     : QWidget( parent )
@@ -57,6 +60,8 @@ TimeTrackingView::TimeTrackingView( QWidget* parent )
     connect( m_taskSelector, SIGNAL(updateSummariesPlease()),
              SLOT(slotUpdateSummaries()) );
 
+    m_elidedTexts.setMaxCost( MaxElidedTexts );
+
     setFocusProxy( m_taskSelector );
     setFocusPolicy( Qt::StrongFocus );
 }
@@ -132,60 +137,18 @@ QMenu* TimeTrackingView::menu() const
 
 void TimeTrackingView::paintEvent( QPaintEvent* e )
 {
-    m_activeFieldRects.clear();
     const int FieldHeight = m_cachedTotalsFieldRect.height();
     QPainter painter( this );
-    // all attributes are determined in data(), we just paint the rects:
+    // the rows are rendered once and then taken from the cache:
     for ( int row = 0; row < rowCount() - 1; ++row ) {
-        for ( int column = 0; column < columnCount(); ++column ) {
-            // get the rectangle of the field that will be drawn
-            QRect fieldRect;
-            const int y = row * FieldHeight;
-            if ( column == columnCount() - 1 ) { // totals column
-                fieldRect = QRect( width() - m_cachedTotalsFieldRect.width(), y,
-                                   m_cachedTotalsFieldRect.width(), FieldHeight );
-            } else if ( column == 0 ) { // task column
-                fieldRect = QRect( 0, y, taskColumnWidth(), FieldHeight );
-            } else if ( column > 0 ) { //  a task
-                fieldRect = QRect( width() - m_cachedTotalsFieldRect.width()
-                                   - 8 * m_cachedDayFieldRect.width()
-                                   + column * m_cachedDayFieldRect.width(), y,
-                                   m_cachedDayFieldRect.width(), FieldHeight );
-            }
-            // paint the field, if it is in the dirty region
-            if( e->rect().contains( fieldRect ) ) {
-                DataField field = m_defaultField;
-                data( field, column, row );
-                int alignment = Qt::AlignRight | Qt::AlignVCenter;
-                if ( row == 0 ) {
-                    alignment = Qt::AlignCenter | Qt::AlignVCenter;
-                } else if ( column == 0 && row < rowCount() - 1 ) {
-                    alignment = Qt::AlignLeft | Qt::AlignVCenter;
-                }
-                if( column == 0 ) { // task column
-                    field.text = elidedText( field.text, field.font, fieldRect.width() - 2*Margin );
-                }
-                if ( field.storeAsActive ) m_activeFieldRects << fieldRect;
-                const QRect textRect = fieldRect.adjusted( Margin, Margin, -Margin, -Margin );
-                if ( field.hasHighlight ) {
-                    painter.setBrush( field.highlight );
-                    painter.setPen( Qt::NoPen );
-                    painter.drawRect( fieldRect );
-                } else {
-                    painter.setBrush( field.background );
-                    painter.setPen( Qt::NoPen );
-                    painter.drawRect( fieldRect );
-                }
-                painter.setPen( palette().text().color() );
-                painter.setFont( field.font );
-                painter.drawText( textRect, alignment, field.text );
-            }
-        }
+        const QRect rect = rowRect( row );
+        if ( e->rect().intersects( rect ) )
+            painter.drawPixmap( rect.topLeft(), rowPixmap( row ) );
     }
     // paint the tracking row
     const int top = ( rowCount() - 1 ) * FieldHeight;
     const QRect fieldRect( 0, top, width(), height() - top );
-    if ( e->rect().contains( fieldRect ) ) {
+    if ( e->rect().intersects( fieldRect ) ) {
         DataField field = m_defaultField;
         data( field, 0, rowCount() - 1 );
         painter.setBrush( field.background );
@@ -194,13 +157,88 @@ void TimeTrackingView::paintEvent( QPaintEvent* e )
     }
 }
 
+const QPixmap& TimeTrackingView::rowPixmap( int row )
+{
+    if ( m_rowCache.size() < rowCount() )
+        m_rowCache.resize( rowCount() );
+    RowCache& cache = m_rowCache[row];
+    const qint64 paletteKey = palette().cacheKey();
+    if ( cache.pixmap.isNull() || cache.width != width() || cache.paletteKey != paletteKey ) {
+        cache.pixmap = renderRow( row );
+        cache.width = width();
+        cache.paletteKey = paletteKey;
+    }
+    return cache.pixmap;
+}
+
+QPixmap TimeTrackingView::renderRow( int row )
+{
+    const int FieldHeight = m_cachedTotalsFieldRect.height();
+    const int ratio = devicePixelRatio();
+    QPixmap pixmap( QSize( width(), FieldHeight ) * ratio );
+    pixmap.setDevicePixelRatio( ratio );
+    pixmap.fill( Qt::transparent );
+    QPainter painter( &pixmap );
+    // all attributes are determined in data(), we just paint the rects:
+    for ( int column = 0; column < columnCount(); ++column ) {
+        // get the rectangle of the field that will be drawn
+        QRect fieldRect;
+        if ( column == columnCount() - 1 ) { // totals column
+            fieldRect = QRect( width() - m_cachedTotalsFieldRect.width(), 0,
+                               m_cachedTotalsFieldRect.width(), FieldHeight );
+        } else if ( column == 0 ) { // task column
+            fieldRect = QRect( 0, 0, taskColumnWidth(), FieldHeight );
+        } else if ( column > 0 ) { //  a task
+            fieldRect = QRect( width() - m_cachedTotalsFieldRect.width()
+                               - 8 * m_cachedDayFieldRect.width()
+                               + column * m_cachedDayFieldRect.width(), 0,
+                               m_cachedDayFieldRect.width(), FieldHeight );
+        }
+        DataField field = m_defaultField;
+        data( field, column, row );
+        int alignment = Qt::AlignRight | Qt::AlignVCenter;
+        if ( row == 0 ) {
+            alignment = Qt::AlignCenter | Qt::AlignVCenter;
+        } else if ( column == 0 && row < rowCount() - 1 ) {
+            alignment = Qt::AlignLeft | Qt::AlignVCenter;
+        }
+        if( column == 0 ) { // task column
+            field.text = elidedText( field.text, field.font, fieldRect.width() - 2*Margin );
+        }
+        const QRect textRect = fieldRect.adjusted( Margin, Margin, -Margin, -Margin );
+        if ( field.hasHighlight ) {
+            painter.setBrush( field.highlight );
+            painter.setPen( Qt::NoPen );
+            painter.drawRect( fieldRect );
+        } else {
+            painter.setBrush( field.background );
+            painter.setPen( Qt::NoPen );
+            painter.drawRect( fieldRect );
+        }
+        painter.setPen( palette().text().color() );
+        painter.setFont( field.font );
+        painter.drawText( textRect, alignment, field.text );
+    }
+    return pixmap;
+}
+
+void TimeTrackingView::invalidateRows()
+{
+    m_rowCache.clear();
+}
+
+void TimeTrackingView::invalidateRow( int row )
+{
+    if ( row >= 0 && row < m_rowCache.size() )
+        m_rowCache[row] = RowCache();
+}
+
 
 void TimeTrackingView::resizeEvent( QResizeEvent* )
 {
     sizeHint(); // make sure cached values are updated
     m_taskSelector->resize( width() - 2*Margin, m_taskSelector->sizeHint().height() );
     m_taskSelector->move( Margin, height() - Margin - m_taskSelector->height() );
-    m_elidedTexts.clear();
 }
 
 void TimeTrackingView::mousePressEvent( QMouseEvent* event )
@@ -333,7 +371,6 @@ void TimeTrackingView::data( DataField& field, int column, int row ) const
                 // highlight today as well, with the half highlight:
                 if ( day == m_dayOfWeek -1 ) {
                     field.hasHighlight = true;
-                    field.storeAsActive = active;
                     field.highlight = active ? QBrush(m_paintAttributes.runningTaskColor) : m_paintAttributes.halfHighlight;
                 }
             }
@@ -343,12 +380,12 @@ void TimeTrackingView::data( DataField& field, int column, int row ) const
 
 void TimeTrackingView::setSummaries( const QVector<WeeklySummary>& summaries )
 {
-    m_activeFieldRects.clear();
     m_summaries = summaries;
     m_cachedMinimumSizeHint = QSize();
     m_cachedSizeHint = QSize();
     m_dayOfWeek = QDate::currentDate().dayOfWeek();
-    m_elidedTexts.clear();
+    invalidateRows();
+    m_activeSummaries.fill( false, m_summaries.size() );
     updateGeometry();
     update();
     // populate menu:
@@ -357,6 +394,24 @@ void TimeTrackingView::setSummaries( const QVector<WeeklySummary>& summaries )
     handleActiveEvents();
 }
 
+void TimeTrackingView::setSummary( int index, const WeeklySummary& summary )
+{
+    Q_ASSERT( index >= 0 && index < m_summaries.size() );
+    Q_ASSERT( m_summaries[index].task == summary.task );
+    m_summaries[index].durations = summary.durations;
+    // the row of the summary, and the totals row:
+    invalidateRow( index + 1 );
+    invalidateRow( rowCount() - 2 );
+    update( rowRect( index + 1 ) );
+    update( rowRect( rowCount() - 2 ) );
+}
+
+QRect TimeTrackingView::rowRect( int row ) const
+{
+    const int fieldHeight = m_cachedTotalsFieldRect.height();
+    return QRect( 0, row * fieldHeight, width(), fieldHeight );
+}
+
 bool TimeTrackingView::isTracking() const
 {
     return DATAMODEL->activeEventCount() > 0;
@@ -387,16 +442,25 @@ void TimeTrackingView::configurationChanged()
     /* invalidate cache and force recalc */
     m_cachedSizeHint = QSize();
     m_cachedMinimumSizeHint = QSize();
+    m_elidedTexts.clear();
+    invalidateRows();
     updateGeometry();
     sizeHint();
 
-    /* force repaint */
-    repaint();
+    update();
 }
 
 void TimeTrackingView::handleActiveEvents()
 {
-    m_activeFieldRects.clear();
+    // only the rows of tasks that were started or stopped change:
+    for ( int index = 0; index < m_summaries.size(); ++index ) {
+        const bool active = DATAMODEL->isTaskActive( m_summaries[index].task );
+        if ( active != m_activeSummaries[index] ) {
+            m_activeSummaries[index] = active;
+            invalidateRow( index + 1 );
+            update( rowRect( index + 1 ) );
+        }
+    }
     Q_ASSERT( DATAMODEL->activeEventCount() >= 0 );
 
     m_taskSelector->handleActiveEvents();
@@ -404,10 +468,12 @@ void TimeTrackingView::handleActiveEvents()
 
 QString TimeTrackingView::elidedText( const QString& text, const QFont& font, int width )
 {
-    if( ! m_elidedTexts.contains( text ) )
-        m_elidedTexts.insert( text, Charm::elidedTaskName( text, font, width ) );
-    Q_ASSERT( m_elidedTexts.contains( text ) );
-    return m_elidedTexts.value( text );
+    const QString key = QString::number( width ) + QLatin1Char( '|' ) + text;
+    if ( const QString* elided = m_elidedTexts.object( key ) )
+        return *elided;
+    const QString elided = Charm::elidedTaskName( text, font, width );
+    m_elidedTexts.insert( key, new QString( elided ) );
+    return elided;
 }
 
 void TimeTrackingView::slotUpdateSummaries()
@@ -419,7 +485,7 @@ bool TimeTrackingView::taskIsValidAndTrackable( int taskId )
 {
     const Task& task = DATAMODEL->getTask( taskId );
 
-    bool expired = !task.isCurrentlyValid();
+    bool expired = !DATAMODEL->isTaskCurrentlyValid( task.id() );
     bool trackable = task.trackable();
     bool notTrackableAndExpired = ( !trackable && expired );
     const auto id = QString::number( task.id() );
@@ -24,9 +24,11 @@
 #ifndef TimeTrackingView_H
 #define TimeTrackingView_H
 
+#include <QCache>
 #include <QWidget>
 #include <QVector>
 #include <QMenu>
+#include <QPixmap>
 
 #include "Core/Task.h"
 #include "TimeTrackingTaskSelector.h"
@@ -42,7 +44,6 @@ private:
         QString text;
         QBrush background;
         bool hasHighlight = false; // QBrush does not have isValid()
-        bool storeAsActive = false;
         QBrush highlight;
         QFont font;
     };
@@ -70,6 +71,9 @@ public:
     void mouseDoubleClickEvent( QMouseEvent * event ) override;
 
     void setSummaries( const QVector<WeeklySummary>& summaries );
+    /** Replace the durations of one summary, the list of tasks is unchanged.
+        Only the task's row and the totals are repainted. */
+    void setSummary( int index, const WeeklySummary& summary );
     QSize sizeHint() const override;
     QSize minimumSizeHint() const override;
     QMenu* menu() const;
@@ -95,6 +99,11 @@ private:
     int columnCount() const { return 9; }
     int rowCount() const { return qMax( 6, m_summaries.count() ) + 3; }
     int getSummaryAt( const QPoint& position );
+    QRect rowRect( int row ) const;
+    const QPixmap& rowPixmap( int row );
+    QPixmap renderRow( int row );
+    void invalidateRows();
+    void invalidateRow( int row );
     bool taskIsValidAndTrackable( int taskId );
 
     int taskColumnWidth() const;
@@ -107,15 +116,25 @@ private:
     mutable QFont m_fixedFont;
     mutable QFont m_narrowFont;
     TimeTrackingTaskSelector* m_taskSelector;
-    QList<QRect> m_activeFieldRects;
+    /** A rendered row, valid for the width and palette it was painted with. */
+    struct RowCache {
+        QPixmap pixmap;
+        int width = 0;
+        qint64 paletteKey = 0;
+    };
+    QVector<RowCache> m_rowCache;
+    /** Whether the task of every summary was active when its row was
+        last invalidated, to find the rows whose highlight changes. */
+    QVector<bool> m_activeSummaries;
     PaintAttributes m_paintAttributes;
     DataField m_defaultField;
     /** Stored for performance reasons, QDate::currentDate() is expensive. */
     int m_dayOfWeek = 0;
     /** Stored for performance reasons, QDate::shortDayName() is slow on Mac. */
     QString m_shortDayNames[7];
-    /** Stored for performance reasons, QFontMetrics::elidedText is slow if called many times. */
-    QMap<QString, QString> m_elidedTexts;
+    /** Stored for performance reasons, QFontMetrics::elidedText is slow if called many times.
+        Keyed by width and text. */
+    QCache<QString, QString> m_elidedTexts;
     QString elidedText( const QString& text, const QFont& font, int width );
 };
 
@@ -36,6 +36,7 @@
 #include "MessageBox.h"
 #include "MonthlyTimesheet.h"
 #include "MonthlyTimesheetConfigurationDialog.h"
+#include "PeriodTimesheetConfigurationDialog.h"
 #include "TemporaryValue.h"
 #include "TimeTrackingView.h"
 #include "ViewHelpers.h"
@@ -53,25 +54,39 @@
 
 #include "HttpClient/GetProjectCodesJob.h"
 #include "HttpClient/GetUserInfoJob.h"
+#include "HttpClient/UploadTimesheetJob.h"
 
 #include "Idle/IdleDetector.h"
 
+#include "Reports/WeeklyTimesheetBatch.h"
+
 #include "Widgets/HttpJobProgressDialog.h"
 
+#include <QApplication>
 #include <QBuffer>
 #include <QDir>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QScriptEngine>
 #include <QScriptValue>
 #include <QSettings>
 #include <QToolBar>
+#include <QtConcurrentRun>
 #include <QtAlgorithms>
 
 #include <algorithm>
 
+namespace {
+    // the result of generating the missing weekly time sheets:
+    struct MissingTimesheets {
+        WeeklyTimesheetUploadList uploads;
+        QString error;
+    };
+}
+
 TimeTrackingWindow::TimeTrackingWindow( QWidget* parent )
     : CharmWindow( tr( "Time Tracker" ), parent )
     , m_summaryWidget( new TimeTrackingView( this ) )
@@ -185,6 +200,10 @@ void TimeTrackingWindow::taskModified( TaskId )
     slotSelectTasksToShow();
 }
 
+void TimeTrackingWindow::taskParentAboutToChange( TaskId, TaskId, TaskId )
+{
+}
+
 void TimeTrackingWindow::taskParentChanged( TaskId, TaskId, TaskId )
 {
     slotSelectTasksToShow();
@@ -208,21 +227,41 @@ void TimeTrackingWindow::eventAboutToBeAdded( EventId )
 {
 }
 
-void TimeTrackingWindow::eventAdded( EventId )
+void TimeTrackingWindow::eventAdded( EventId id )
 {
-    slotSelectTasksToShow();
+    updateSummaries( DATAMODEL->eventForId( id ) );
 }
 
-void TimeTrackingWindow::eventModified( EventId , Event )
+void TimeTrackingWindow::eventModified( EventId id, Event discardedEvent )
 {
-    slotSelectTasksToShow();
+    // the old and the new cell may differ:
+    updateSummaries( discardedEvent );
+    updateSummaries( DATAMODEL->eventForId( id ) );
 }
 
-void TimeTrackingWindow::eventAboutToBeDeleted( EventId )
+void TimeTrackingWindow::eventAboutToBeDeleted( EventId id )
 {
+    m_deletedEvent = DATAMODEL->eventForId( id );
 }
 
 void TimeTrackingWindow::eventDeleted( EventId )
+{
+    updateSummaries( m_deletedEvent );
+    m_deletedEvent = Event();
+}
+
+void TimeTrackingWindow::eventsAdded( const EventIdList& ids )
+{
+    Q_FOREACH( EventId id, ids )
+        updateSummaries( DATAMODEL->eventForId( id ) );
+}
+
+void TimeTrackingWindow::eventsModified( const EventIdList& )
+{
+    slotSelectTasksToShow();
+}
+
+void TimeTrackingWindow::eventsDeleted( const EventIdList& )
 {
     slotSelectTasksToShow();
 }
@@ -260,12 +299,25 @@ void TimeTrackingWindow::slotSelectTasksToShow()
 {
     // we would like to always show some tasks, if there are any
     // first, we select tasks that most recently where active
-    const NamedTimeSpan thisWeek = TimeSpans().thisWeek();
+    m_summariesTimeSpan = TimeSpans().thisWeek().timespan;
     // and update the widget:
-    m_summaries = WeeklySummary::summariesForTimespan( DATAMODEL, thisWeek.timespan );
+    m_summaries = WeeklySummary::summariesForTimespan( DATAMODEL, m_summariesTimeSpan );
     m_summaryWidget->setSummaries( m_summaries );
 }
 
+void TimeTrackingWindow::updateSummaries( const Event& event )
+{
+    if ( !event.isValid() )
+        return;
+    const int index = WeeklySummary::updateSummaries( m_summaries, DATAMODEL, m_summariesTimeSpan,
+                                                      event.taskId(), event.startDateTime().date() );
+    if ( index == WeeklySummary::RowsChanged ) {
+        m_summaryWidget->setSummaries( m_summaries );
+    } else if ( index != WeeklySummary::NoChange ) {
+        m_summaryWidget->setSummary( index, m_summaries.at( index ) );
+    }
+}
+
 void TimeTrackingWindow::insertEditMenu()
 {
     QMenu* editMenu = menuBar()->addMenu( tr( "Edit" ) );
@@ -276,7 +328,7 @@ void TimeTrackingWindow::slotStartEvent( TaskId id )
 {
     const TaskTreeItem& item = DATAMODEL->taskTreeItem( id );
 
-    if( item.task().isCurrentlyValid() ) {
+    if( DATAMODEL->isTaskCurrentlyValid( id ) ) {
         DATAMODEL->startEventRequested( item.task() );
     } else {
         QString nm = item.task().name();
@@ -322,6 +374,7 @@ void TimeTrackingWindow::slotEnterVacation()
     if ( dialog.exec() != QDialog::Accepted )
         return;
     const EventList events = dialog.events();
+    const EventBatch batch( DATAMODEL );
     Q_FOREACH ( const Event& event, events ) {
         auto command = new CommandMakeEvent( event, this );
         sendCommand( command );
@@ -368,6 +421,27 @@ void TimeTrackingWindow::slotMonthlyTimesheetReport()
     m_monthlyTimesheetDialog->show();
 }
 
+void TimeTrackingWindow::resetPeriodTimesheetDialog( PeriodTimesheetConfigurationDialog* dialog )
+{
+    delete m_periodTimesheetDialog;
+    m_periodTimesheetDialog = dialog;
+    m_periodTimesheetDialog->setAttribute( Qt::WA_DeleteOnClose );
+    connect( m_periodTimesheetDialog, SIGNAL(finished(int)),
+             this, SLOT(slotPeriodTimesheetPreview(int)) );
+}
+
+void TimeTrackingWindow::slotQuarterlyTimesheetReport()
+{
+    resetPeriodTimesheetDialog( new PeriodTimesheetConfigurationDialog( PeriodTimeSheetReport::Quarter, this ) );
+    m_periodTimesheetDialog->show();
+}
+
+void TimeTrackingWindow::slotYearlyTimesheetReport()
+{
+    resetPeriodTimesheetDialog( new PeriodTimesheetConfigurationDialog( PeriodTimeSheetReport::Year, this ) );
+    m_periodTimesheetDialog->show();
+}
+
 void TimeTrackingWindow::slotWeeklyTimesheetPreview( int result )
 {
     showPreview( m_weeklyTimesheetDialog, result );
@@ -380,6 +454,12 @@ void TimeTrackingWindow::slotMonthlyTimesheetPreview( int result )
     m_monthlyTimesheetDialog = nullptr;
 }
 
+void TimeTrackingWindow::slotPeriodTimesheetPreview( int result )
+{
+    showPreview( m_periodTimesheetDialog, result );
+    m_periodTimesheetDialog = nullptr;
+}
+
 void TimeTrackingWindow::slotActivityReportPreview( int result )
 {
     showPreview( m_activityReportDialog, result );
@@ -556,11 +636,77 @@ void TimeTrackingWindow::slotBillGone(int result)
         break;
     case BillDialog::Later:
         break;
+    case BillDialog::UploadAll:
+        uploadMissingTimesheets();
+        break;
     }
     if (CONFIGURATION.warnUnuploadedTimesheets)
         m_checkUploadedSheetsTimer.start();
 }
 
+void TimeTrackingWindow::uploadMissingTimesheets()
+{
+    // use the root task of the weekly time sheet, if it still exists
+    TaskId rootTask = 0;
+    QSettings settings;
+    if ( settings.contains( MetaKey_TimesheetRootTask ) ) {
+        const TaskId root = settings.value( MetaKey_TimesheetRootTask ).toInt();
+        if ( DATAMODEL->taskTreeItem( root ).isValid() )
+            rootTask = root;
+    }
+
+    // generate the time sheets on a worker thread, and upload them when they are done:
+    const CharmDataModelSnapshot snapshot = DATAMODEL->snapshot();
+    // the configuration is only read on the GUI thread:
+    const QString userName = CONFIGURATION.user.name();
+    const WeeksByYear weeks = missingTimeSheets();
+    auto watcher = new QFutureWatcher<MissingTimesheets>( this );
+    connect( watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+        const MissingTimesheets result = watcher->result();
+        watcher->deleteLater();
+        if ( !result.error.isEmpty() ) {
+            QMessageBox::critical( this, tr( "Error exporting the report" ), result.error );
+            return;
+        }
+        if ( !result.uploads.isEmpty() )
+            uploadTimesheets( result.uploads );
+    } );
+    watcher->setFuture( QtConcurrent::run( [snapshot, userName, rootTask, weeks]() {
+        MissingTimesheets result;
+        try {
+            result.uploads = WeeklyTimesheetBatch::generate( snapshot, userName, rootTask, weeks );
+        } catch ( const XmlSerializationException& e ) {
+            result.error = e.what();
+        }
+        return result;
+    } ) );
+}
+
+void TimeTrackingWindow::uploadTimesheets( const WeeklyTimesheetUploadList& uploads )
+{
+    auto job = new UploadTimesheetJob( this );
+    QVector<QPair<int, int> > weeks;
+    Q_FOREACH( const WeeklyTimesheetUpload& upload, uploads ) {
+        job->addUpload( upload.fileName, upload.payload );
+        weeks.append( qMakePair( upload.year, upload.week ) );
+    }
+    HttpJobProgressDialog* dialog = new HttpJobProgressDialog( job, this );
+    dialog->setWindowTitle( tr( "Uploading" ) );
+    connect( job, &UploadTimesheetJob::timesheetUploaded, this, [weeks]( int index ) {
+        addUploadedTimesheet( weeks[index].first, weeks[index].second );
+    } );
+    connect( job, SIGNAL(finished(HttpJob*)), this, SLOT(slotTimesheetsUploaded(HttpJob*)) );
+    job->start();
+}
+
+void TimeTrackingWindow::slotTimesheetsUploaded( HttpJob* job )
+{
+    if ( job->error() == HttpJob::Canceled )
+        return;
+    if ( job->error() )
+        QMessageBox::critical( this, tr( "Error" ), tr( "Could not upload the time sheets: %1" ).arg( job->errorString() ) );
+}
+
 void TimeTrackingWindow::slotCheckForUpdatesAutomatic()
 {
     // do not display message error when auto-checking
@@ -645,6 +791,7 @@ void TimeTrackingWindow::maybeIdle( IdleDetector* detector )
         const auto periods = detector->idlePeriods();
         const IdleDetector::IdlePeriod period = periods.last();
 
+        const EventBatch batch( DATAMODEL );
         Q_FOREACH ( EventId eventId, activeEvents ) {
             Event event = DATAMODEL->eventForId( eventId );
             if ( event.isValid() ) {
@@ -33,6 +33,7 @@
 
 #include "CharmWindow.h"
 #include "Charm/WeeklySummary.h"
+#include "Charm/Reports/WeeklyTimesheetBatch.h"
 #include "BillDialog.h"
 
 class HttpJob;
@@ -43,6 +44,7 @@ class IdleDetector;
 class ReportConfigurationDialog;
 class WeeklyTimesheetConfigurationDialog;
 class MonthlyTimesheetConfigurationDialog;
+class PeriodTimesheetConfigurationDialog;
 class ActivityReportConfigurationDialog;
 
 class TimeTrackingWindow : public CharmWindow,
@@ -70,6 +72,7 @@ public:
     void taskAboutToBeAdded( TaskId parent, int pos ) override;
     void taskAdded( TaskId id ) override;
     void taskModified( TaskId id ) override;
+    void taskParentAboutToChange( TaskId task, TaskId oldParent, TaskId newParent ) override;
     void taskParentChanged( TaskId task, TaskId oldParent, TaskId newParent ) override;
     void taskAboutToBeDeleted( TaskId ) override;
     void taskDeleted( TaskId id ) override;
@@ -79,6 +82,9 @@ public:
     void eventModified( EventId id, Event discardedEvent ) override;
     void eventAboutToBeDeleted( EventId id ) override;
     void eventDeleted( EventId id ) override;
+    void eventsAdded( const EventIdList& ids ) override;
+    void eventsModified( const EventIdList& ids ) override;
+    void eventsDeleted( const EventIdList& ids ) override;
     void eventActivated( EventId id ) override;
     void eventDeactivated( EventId id ) override;
 
@@ -90,6 +96,8 @@ public Q_SLOTS:
     void slotActivityReport();
     void slotWeeklyTimesheetReport();
     void slotMonthlyTimesheetReport();
+    void slotQuarterlyTimesheetReport();
+    void slotYearlyTimesheetReport();
     void slotExportToXml();
     void slotImportFromXml();
     void slotSyncTasks( VerboseMode mode = Verbose );
@@ -110,9 +118,11 @@ private Q_SLOTS:
     void slotSelectTasksToShow();
     void slotWeeklyTimesheetPreview( int result );
     void slotMonthlyTimesheetPreview( int result );
+    void slotPeriodTimesheetPreview( int result );
     void slotActivityReportPreview( int result );
     void slotCheckUploadedTimesheets();
     void slotBillGone( int result );
+    void slotTimesheetsUploaded( HttpJob* );
     void slotCheckForUpdatesAutomatic();
     void slotCheckForUpdates( CheckForUpdatesJob::JobData );
     void slotSyncTasksAutomatic();
@@ -127,7 +137,12 @@ Q_SIGNALS:
 private:
     void resetWeeklyTimesheetDialog();
     void resetMonthlyTimesheetDialog();
+    void resetPeriodTimesheetDialog( PeriodTimesheetConfigurationDialog* dialog );
+    void uploadMissingTimesheets();
+    void uploadTimesheets( const WeeklyTimesheetUploadList& uploads );
     void showPreview( ReportConfigurationDialog*, int result );
+    /** Apply a change of the event's cell to the summaries. */
+    void updateSummaries( const Event& event );
     //ugly but private:
     void importTasksFromDeviceOrFile( QIODevice* device, const QString& filename, bool verbose = true );
     void startCheckForUpdates( VerboseMode mode = Silent );
@@ -135,9 +150,13 @@ private:
 
     WeeklyTimesheetConfigurationDialog* m_weeklyTimesheetDialog = nullptr;
     MonthlyTimesheetConfigurationDialog* m_monthlyTimesheetDialog = nullptr;
+    PeriodTimesheetConfigurationDialog* m_periodTimesheetDialog = nullptr;
     ActivityReportConfigurationDialog *m_activityReportDialog = nullptr;
     TimeTrackingView* m_summaryWidget;
     QVector<WeeklySummary> m_summaries;
+    TimeSpan m_summariesTimeSpan;
+    // kept between eventAboutToBeDeleted and eventDeleted:
+    Event m_deletedEvent;
     QTimer m_checkUploadedSheetsTimer;
     QTimer m_checkCharmReleaseVersionTimer;
     QTimer m_updateUserInfoAndTasksDefinitionsTimer;
@@ -22,15 +22,111 @@
 */
 
 #include "Timesheet.h"
+#include "Reports/HtmlReportWriter.h"
 
+#include <QAbstractButton>
+#include <QCheckBox>
 #include <QFileDialog>
+#include <QLabel>
 #include <QMessageBox>
 #include <QSettings>
+#include <QTextStream>
 
+#include "SelectTaskDialog.h"
 #include "ViewHelpers.h"
 
 #include "CharmCMake.h"
 
+TimeSheetConfigurationDialog::TimeSheetConfigurationDialog( QWidget* parent )
+    : ReportConfigurationDialog( parent )
+{
+}
+
+TimeSheetConfigurationDialog::~TimeSheetConfigurationDialog()
+{
+}
+
+void TimeSheetConfigurationDialog::setTaskWidgets( QCheckBox* subTasksOnly, QLabel* taskName,
+                                                   QAbstractButton* selectTask, QCheckBox* activeOnly )
+{
+    m_checkBoxSubTasksOnly = subTasksOnly;
+    m_labelTaskName = taskName;
+    m_checkBoxActiveOnly = activeOnly;
+    connect( selectTask, SIGNAL(clicked()),
+             SLOT(slotSelectTask()) );
+    connect( m_checkBoxSubTasksOnly, SIGNAL(toggled(bool)),
+             SLOT(slotCheckboxSubtasksOnlyChecked(bool)) );
+    slotCheckboxSubtasksOnlyChecked( m_checkBoxSubTasksOnly->isChecked() );
+
+    // load settings:
+    QSettings settings;
+    if ( settings.contains( MetaKey_TimesheetActiveOnly ) ) {
+        m_checkBoxActiveOnly->setChecked( settings.value( MetaKey_TimesheetActiveOnly ).toBool() );
+    } else {
+        m_checkBoxActiveOnly->setChecked( true );
+    }
+}
+
+bool TimeSheetConfigurationDialog::activeTasksOnly() const
+{
+    return m_checkBoxActiveOnly->isChecked();
+}
+
+void TimeSheetConfigurationDialog::accept()
+{
+    // save settings:
+    QSettings settings;
+    settings.setValue( MetaKey_TimesheetActiveOnly,
+                       m_checkBoxActiveOnly->isChecked() );
+    settings.setValue( MetaKey_TimesheetRootTask,
+                       m_rootTask );
+
+    QDialog::accept();
+}
+
+void TimeSheetConfigurationDialog::showEvent( QShowEvent* )
+{
+    QSettings settings;
+
+    // we only want to do this once a backend is loaded, and we ignore
+    // the saved root task if it does not exist anymore
+    if ( settings.contains( MetaKey_TimesheetRootTask ) ) {
+        TaskId root = settings.value( MetaKey_TimesheetRootTask ).toInt();
+        const TaskTreeItem& item = DATAMODEL->taskTreeItem( root );
+        if ( item.isValid() ) {
+            m_rootTask = root;
+            m_labelTaskName->setText( DATAMODEL->fullTaskName( item.task() ) );
+            m_checkBoxSubTasksOnly->setChecked( true );
+        }
+    }
+}
+
+void TimeSheetConfigurationDialog::slotCheckboxSubtasksOnlyChecked( bool checked )
+{
+    if ( checked && m_rootTask == 0 ) {
+        slotSelectTask();
+    }
+
+    if ( ! checked ) {
+        m_rootTask = 0;
+        m_labelTaskName->setText( tr( "(All Tasks)" ) );
+    }
+}
+
+void TimeSheetConfigurationDialog::slotSelectTask()
+{
+    SelectTaskDialog dialog( this );
+    dialog.setNonTrackableSelectable();
+    if ( dialog.exec() ) {
+        m_rootTask = dialog.selectedTask();
+        const TaskTreeItem& item = DATAMODEL->taskTreeItem( m_rootTask );
+        m_labelTaskName->setText( DATAMODEL->fullTaskName( item.task() ) );
+    } else {
+        if ( m_rootTask == 0 )
+            m_checkBoxSubTasksOnly->setChecked( false );
+    }
+}
+
 TimeSheetReport::TimeSheetReport( QWidget* parent )
     : ReportPreviewWindow( parent )
 {
@@ -121,3 +217,100 @@ QString TimeSheetReport::getFileName( const QString& filter )
     }
     return filename;
 }
+
+void TimeSheetReport::generateTimeSheet( const TaskPivot::Buckets& buckets, const Layout& layout )
+{
+    const TaskId root = rootTask();
+    const bool activeOnly = activeTasksOnly();
+    const int taskPaddingLength = CONFIGURATION.taskPaddingLength;
+    const Configuration::DurationFormat durationFormat = CONFIGURATION.durationFormat;
+    generateReport( [=]( const CharmDataModelSnapshot& snapshot, ReportGenerator::Control& control ) {
+        // for every task, the seconds for every bucket:
+        TaskPivot pivot( buckets );
+        pivot.setRootTask( root );
+        pivot.compute( snapshot );
+        const int columns = pivot.columnCount();
+
+        // headline first:
+        HtmlReportWriter writer;
+
+        // create the caption:
+        writer.textElement( QStringLiteral("h1"), layout.heading );
+        writer.textElement( QStringLiteral("h3"), layout.caption );
+        writer.link( QStringLiteral("Previous"), layout.previousLink );
+        writer.link( QStringLiteral("Next"), layout.nextLink );
+        writer.emptyElement( QStringLiteral("br") );
+
+        // now for a table
+        // retrieve the information for the report:
+        TimeSheetInfoList timeSheetInfo = TimeSheetInfo::fromPivot( snapshot, pivot, activeOnly );
+        if ( root == 0 && ! timeSheetInfo.isEmpty() )
+            timeSheetInfo.removeAt( 0 ); // the virtual root item, the totals are below
+
+        writer.beginTable();
+        Q_FOREACH( const QStringList& headerRow, layout.headerRows ) {
+            writer.beginRow( QStringLiteral("header_row") );
+            Q_FOREACH( const QString& text, headerRow )
+                writer.headerCell( text );
+            writer.endElement();
+        }
+
+        const HtmlReportWriter::Attributes centered = { { QStringLiteral("align"), QStringLiteral("center") } };
+        for ( int i = 0; i < timeSheetInfo.size(); ++i )
+        {
+            if ( control.isCanceled() )
+                return QString();
+            control.setProgress( i, timeSheetInfo.size() );
+            const TimeSheetInfo& info = timeSheetInfo[i];
+            writer.beginRow( i % 2 ? QStringLiteral("alternate_row") : QString() );
+            writer.cell( info.formattedTaskIdAndName( taskPaddingLength ), {
+                             { QStringLiteral("align"), QStringLiteral("left") },
+                             { QStringLiteral("style"), QStringLiteral( "text-indent: %1px;" )
+                                                        .arg( 9 * info.indentation ) } } );
+            for ( int column = 0; column < columns; ++column )
+                writer.cell( hoursAndMinutes( info.seconds[column], durationFormat ), centered );
+            writer.cell( hoursAndMinutes( info.total(), durationFormat ), centered );
+            if ( layout.secondsInDay > 0 )
+                writer.cell( QString::number( info.total() / layout.secondsInDay, 'f', 1 ), centered );
+            writer.endElement();
+        }
+
+        {   // Totals row, the subtree of the root:
+            const int total = pivot.subtreeTotal( 0 );
+            writer.beginRow( QStringLiteral("header_row") );
+            writer.headerCell( tr( "Total:" ) );
+            for ( int column = 0; column < columns; ++column )
+                writer.headerCell( hoursAndMinutes( pivot.subtreeSeconds( 0, column ), durationFormat ) );
+            writer.headerCell( hoursAndMinutes( total, durationFormat ) );
+            if ( layout.secondsInDay > 0 )
+                writer.headerCell( QString::number( total / layout.secondsInDay, 'f', 1 ) );
+            writer.endElement();
+        }
+
+        return writer.finish();
+    } );
+}
+
+QByteArray TimeSheetReport::timeSheetText( const TaskPivot::Buckets& buckets, const QString& caption,
+                                           const QString& totalLabel ) const
+{
+    const CharmDataModelSnapshot snapshot = DATAMODEL->snapshot();
+    TaskPivot pivot( buckets );
+    pivot.setRootTask( rootTask() );
+    pivot.compute( snapshot );
+    TimeSheetInfoList timeSheetInfo = TimeSheetInfo::fromPivot( snapshot, pivot, activeTasksOnly() );
+    if ( rootTask() == 0 && ! timeSheetInfo.isEmpty() )
+        timeSheetInfo.removeAt( 0 ); // the virtual root item
+
+    QByteArray output;
+    QTextStream stream( &output );
+    stream << caption << '\n';
+    stream << '\n';
+    Q_FOREACH( const TimeSheetInfo& info, timeSheetInfo )
+        stream << info.formattedTaskIdAndName( CONFIGURATION.taskPaddingLength ) << "\t" << hoursAndMinutes( info.total() ) << '\n';
+    stream << '\n';
+    stream << totalLabel << hoursAndMinutes( pivot.subtreeTotal( 0 ) ) << '\n';
+    stream.flush();
+
+    return output;
+}
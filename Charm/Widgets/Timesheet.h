@@ -26,9 +26,52 @@
 
 #include <Core/Task.h>
 
+#include "ReportConfigurationDialog.h"
 #include "ReportPreviewWindow.h"
+#include "Reports/TaskPivot.h"
 #include "Reports/TimesheetInfo.h"
 
+class QAbstractButton;
+class QCheckBox;
+class QLabel;
+
+/** Base class for the time sheet configuration dialogs, with the
+    root task and active tasks settings they all have. */
+class TimeSheetConfigurationDialog : public ReportConfigurationDialog
+{
+    Q_OBJECT
+
+public:
+    explicit TimeSheetConfigurationDialog( QWidget* parent );
+    ~TimeSheetConfigurationDialog() override;
+
+    void showEvent( QShowEvent* ) override;
+
+public Q_SLOTS:
+    void accept() override;
+
+protected:
+    /** Sets up the widgets to pick the root task and the active tasks
+        setting, to be called from the constructor. */
+    void setTaskWidgets( QCheckBox* subTasksOnly, QLabel* taskName,
+                         QAbstractButton* selectTask, QCheckBox* activeOnly );
+
+    inline TaskId rootTask() const
+        { return m_rootTask; }
+
+    bool activeTasksOnly() const;
+
+private Q_SLOTS:
+    void slotCheckboxSubtasksOnlyChecked( bool );
+    void slotSelectTask();
+
+private:
+    QCheckBox* m_checkBoxSubTasksOnly = nullptr;
+    QLabel* m_labelTaskName = nullptr;
+    QCheckBox* m_checkBoxActiveOnly = nullptr;
+    TaskId m_rootTask = {};
+};
+
 class TimeSheetReport : public ReportPreviewWindow
 {
     Q_OBJECT
@@ -63,18 +106,31 @@ protected:
     inline bool activeTasksOnly() const
         { return m_activeTasksOnly; }
 
-    inline const SecondsMap &secondsMap() const
-        { return m_secondsMap; }
-
     QString getFileName( const QString& filter );
 
+    /** The parts of a time sheet that are not the same for all of them. */
+    struct Layout {
+        QString heading;
+        QString caption;
+        QString previousLink;
+        QString nextLink;
+        /** The header rows, a cell for the task, every bucket and the total each. */
+        QList<QStringList> headerRows;
+        /** If set, a last column with the time in days of that many seconds. */
+        float secondsInDay = 0;
+    };
+
+    /** Renders the time sheet, one column per bucket of @p buckets,
+        on a worker thread. */
+    void generateTimeSheet( const TaskPivot::Buckets& buckets, const Layout& layout );
+    /** The text export, the total of every task under the caption. */
+    QByteArray timeSheetText( const TaskPivot::Buckets& buckets, const QString& caption,
+                              const QString& totalLabel ) const;
+
     void slotUpdate() override;
     void slotSaveToText() override;
     void slotSaveToXml() override;
 
-protected:
-    SecondsMap m_secondsMap;
-
 private:
     // properties of the report:
     QDate m_start;
@@ -22,6 +22,7 @@
 */
 
 #include "WeeklyTimesheet.h"
+#include "Reports/TaskPivot.h"
 #include "Reports/WeeklyTimesheetXmlWriter.h"
 
 #include <QCalendarWidget>
@@ -36,7 +37,6 @@
 #include "HttpClient/UploadTimesheetJob.h"
 #include "Widgets/HttpJobProgressDialog.h"
 
-#include "SelectTaskDialog.h"
 #include "ViewHelpers.h"
 
 #include "ui_WeeklyTimesheetConfigurationDialog.h"
@@ -48,19 +48,6 @@ namespace {
     static const int MAX_WEEK = 53;
     static const int MIN_YEAR = 1990;
     static const int DaysInWeek = 7;
-
-    enum TimeSheetTableColumns {
-        Column_Task,
-        Column_Monday,
-        Column_Tuesday,
-        Column_Wednesday,
-        Column_Thursday,
-        Column_Friday,
-        Column_Saturday,
-        Column_Sunday,
-        Column_Total,
-        NumberOfColumns
-    };
 }
 
 void addUploadedTimesheet(int year, int week)
@@ -108,7 +95,7 @@ WeeksByYear missingTimeSheets()
 /************************************************** WeeklyTimesheetConfigurationDialog */
 
 WeeklyTimesheetConfigurationDialog::WeeklyTimesheetConfigurationDialog( QWidget* parent )
-    : ReportConfigurationDialog( parent )
+    : TimeSheetConfigurationDialog( parent )
     , m_ui( new Ui::WeeklyTimesheetConfigurationDialog )
 {
     setWindowTitle( tr( "Weekly Timesheet" ) );
@@ -121,26 +108,15 @@ WeeklyTimesheetConfigurationDialog::WeeklyTimesheetConfigurationDialog( QWidget*
 
     connect( m_ui->comboBoxWeek, SIGNAL(currentIndexChanged(int)),
              SLOT(slotWeekComboItemSelected(int)) );
-    connect( m_ui->toolButtonSelectTask, SIGNAL(clicked()),
-             SLOT(slotSelectTask()) );
-    connect( m_ui->checkBoxSubTasksOnly, SIGNAL(toggled(bool)),
-             SLOT(slotCheckboxSubtasksOnlyChecked(bool)) );
     m_ui->comboBoxWeek->setCurrentIndex( 1 );
-    slotCheckboxSubtasksOnlyChecked( m_ui->checkBoxSubTasksOnly->isChecked() );
+    setTaskWidgets( m_ui->checkBoxSubTasksOnly, m_ui->labelTaskName,
+                    m_ui->toolButtonSelectTask, m_ui->checkBoxActiveOnly );
     new DateEntrySyncer( m_ui->spinBoxWeek, m_ui->spinBoxYear, m_ui->dateEditDay, 1, this );
 
     slotStandardTimeSpansChanged();
     connect( ApplicationCore::instance().dateChangeWatcher(),
              SIGNAL(dateChanged()),
              SLOT(slotStandardTimeSpansChanged()) );
-
-    // load settings:
-    QSettings settings;
-    if ( settings.contains( MetaKey_TimesheetActiveOnly ) ) {
-        m_ui->checkBoxActiveOnly->setChecked( settings.value( MetaKey_TimesheetActiveOnly ).toBool() );
-    } else {
-        m_ui->checkBoxActiveOnly->setChecked( true );
-    }
 }
 
 WeeklyTimesheetConfigurationDialog::~WeeklyTimesheetConfigurationDialog()
@@ -154,18 +130,6 @@ void WeeklyTimesheetConfigurationDialog::setDefaultWeek(int yearOfWeek, int week
     m_ui->comboBoxWeek->setCurrentIndex(4);
 }
 
-void WeeklyTimesheetConfigurationDialog::accept()
-{
-    // save settings:
-    QSettings settings;
-    settings.setValue( MetaKey_TimesheetActiveOnly,
-                       m_ui->checkBoxActiveOnly->isChecked() );
-    settings.setValue( MetaKey_TimesheetRootTask,
-                       m_rootTask );
-
-    QDialog::accept();
-}
-
 void WeeklyTimesheetConfigurationDialog::showReportPreviewDialog()
 {
     QDate start, end;
@@ -179,41 +143,11 @@ void WeeklyTimesheetConfigurationDialog::showReportPreviewDialog()
         start = m_weekInfo[index].timespan.first;
         end = m_weekInfo[index].timespan.second;
     }
-    bool activeOnly = m_ui->checkBoxActiveOnly->isChecked();
     auto report = new WeeklyTimeSheetReport();
-    report->setReportProperties( start, end, m_rootTask, activeOnly );
+    report->setReportProperties( start, end, rootTask(), activeTasksOnly() );
     report->show();
 }
 
-void WeeklyTimesheetConfigurationDialog::showEvent( QShowEvent* )
-{
-    QSettings settings;
-
-    // we only want to do this once a backend is loaded, and we ignore
-    // the saved root task if it does not exist anymore
-    if ( settings.contains( MetaKey_TimesheetRootTask ) ) {
-        TaskId root = settings.value( MetaKey_TimesheetRootTask ).toInt();
-        const TaskTreeItem& item = DATAMODEL->taskTreeItem( root );
-        if ( item.isValid() ) {
-            m_rootTask = root;
-            m_ui->labelTaskName->setText( DATAMODEL->fullTaskName( item.task() ) );
-            m_ui->checkBoxSubTasksOnly->setChecked( true );
-        }
-    }
-}
-
-void WeeklyTimesheetConfigurationDialog::slotCheckboxSubtasksOnlyChecked( bool checked )
-{
-    if ( checked && m_rootTask == 0 ) {
-        slotSelectTask();
-    }
-
-    if ( ! checked ) {
-        m_rootTask = 0;
-        m_ui->labelTaskName->setText( tr( "(All Tasks)" ) );
-    }
-}
-
 void WeeklyTimesheetConfigurationDialog::slotStandardTimeSpansChanged()
 {
     const TimeSpans timeSpans;
@@ -247,20 +181,6 @@ void WeeklyTimesheetConfigurationDialog::slotWeekComboItemSelected( int index )
     }
 }
 
-void WeeklyTimesheetConfigurationDialog::slotSelectTask()
-{
-    SelectTaskDialog dialog( this );
-    dialog.setNonTrackableSelectable();
-    if ( dialog.exec() ) {
-        m_rootTask = dialog.selectedTask();
-        const TaskTreeItem& item = DATAMODEL->taskTreeItem( m_rootTask );
-        m_ui->labelTaskName->setText( DATAMODEL->fullTaskName( item.task() ) );
-    } else {
-        if ( m_rootTask == 0 )
-            m_ui->checkBoxSubTasksOnly->setChecked( false );
-    }
-}
-
 /*************************************************************** WeeklyTimeSheetReport */
 // here begins ... the actual report:
 
@@ -321,196 +241,42 @@ QString WeeklyTimeSheetReport::suggestedFileName() const
     return tr( "WeeklyTimeSheet-%1-%2" ).arg( m_yearOfWeek ).arg( m_weekNumber, 2, 10, QLatin1Char('0') );
 }
 
-void WeeklyTimeSheetReport::update()
-{   // this creates the time sheet
-    // retrieve matching events:
-    const EventIdList matchingEvents = DATAMODEL->eventsThatStartInTimeFrame( startDate(), endDate() );
-
-    m_secondsMap.clear();
-
-    // for every task, make a vector that includes a number of seconds
-    // for every day of the week ( int seconds[7]), and store those in
-    // a map by their task id
-    Q_FOREACH( EventId id, matchingEvents ) {
-        const Event& event = DATAMODEL->eventForId( id );
-        QVector<int> seconds( DaysInWeek );
-        if ( m_secondsMap.contains( event.taskId() ) ) {
-            seconds = m_secondsMap.value(event.taskId());
-        }
-        // what day in the week is the event (normalized to vector indexes):
-        int dayOfWeek = event.startDateTime().date().dayOfWeek() - 1;
-        Q_ASSERT( dayOfWeek >= 0 && dayOfWeek < DaysInWeek );
-        seconds[dayOfWeek] += event.duration();
-        // store in minute map:
-        m_secondsMap[event.taskId()] = seconds;
-    }
-    // now the reporting:
-    // headline first:
-    QTextDocument report;
-    QDomDocument doc = createReportTemplate();
-    QDomElement root = doc.documentElement();
-    QDomElement body = root.firstChildElement( QStringLiteral("body") );
-
-    // create the caption:
-    {
-        QDomElement headline = doc.createElement( QStringLiteral("h1") );
-        QDomText text = doc.createTextNode( tr( "Weekly Time Sheet" ) );
-        headline.appendChild( text );
-        body.appendChild( headline );
-    }
-    {
-        QDomElement headline = doc.createElement( QStringLiteral("h3") );
-        QString content = tr( "Report for %1, Week %2 (%3 to %4)" )
-                          .arg( CONFIGURATION.user.name() )
-                          .arg( m_weekNumber, 2, 10, QLatin1Char('0') )
-                          .arg( startDate().toString( Qt::TextDate ) )
-                          .arg( endDate().addDays( -1 ).toString( Qt::TextDate ) );
-        QDomText text = doc.createTextNode( content );
-        headline.appendChild( text );
-        body.appendChild( headline );
-        QDomElement previousLink = doc.createElement( QStringLiteral("a") );
-        previousLink.setAttribute( QStringLiteral("href") , QStringLiteral("Previous") );
-        QDomText previousLinkText = doc.createTextNode( tr( "<Previous Week>" ) );
-        previousLink.appendChild( previousLinkText );
-        body.appendChild( previousLink );
-        QDomElement nextLink = doc.createElement( QStringLiteral("a") );
-        nextLink.setAttribute( QStringLiteral("href") , QStringLiteral("Next") );
-        QDomText nextLinkText = doc.createTextNode( tr( "<Next Week>" ) );
-        nextLink.appendChild( nextLinkText );
-        body.appendChild( nextLink );
-        QDomElement paragraph = doc.createElement( QStringLiteral("br") );
-        body.appendChild( paragraph );
-    }
-    {
-        // now for a table
-        // retrieve the information for the report:
-        // TimeSheetInfoList timeSheetInfo = taskWithSubTasks( rootTask(), secondsMap() );
-        TimeSheetInfoList timeSheetInfo = TimeSheetInfo::filteredTaskWithSubTasks(
-            TimeSheetInfo::taskWithSubTasks( DATAMODEL, DaysInWeek, rootTask(), secondsMap() ),
-            activeTasksOnly() );
-
-        QDomElement table = doc.createElement( QStringLiteral("table") );
-        table.setAttribute( QStringLiteral("width"), QStringLiteral("100%") );
-        table.setAttribute( QStringLiteral("align"), QStringLiteral("left") );
-        table.setAttribute( QStringLiteral("cellpadding"), QStringLiteral("3") );
-        table.setAttribute( QStringLiteral("cellspacing"), QStringLiteral("0") );
-        body.appendChild( table );
-
-        TimeSheetInfo totalsLine(DaysInWeek);
-        if ( ! timeSheetInfo.isEmpty() ) {
-            totalsLine = timeSheetInfo.first();
-            if( rootTask() == 0 ) {
-                timeSheetInfo.removeAt( 0 ); // there is always one, because there is always the root item
-            }
-        }
-
-        QDomElement headerRow = doc.createElement( QStringLiteral("tr") );
-        headerRow.setAttribute( QStringLiteral("class"), QStringLiteral("header_row") );
-        table.appendChild( headerRow );
-        QDomElement headerDayRow = doc.createElement( QStringLiteral("tr") );
-        headerDayRow.setAttribute( QStringLiteral("class"), QStringLiteral("header_row") );
-        table.appendChild( headerDayRow );
-
-        const QString Headlines[NumberOfColumns] = {
-            tr( "Task" ),
-            QDate::shortDayName( 1 ),
-            QDate::shortDayName( 2 ),
-            QDate::shortDayName( 3 ),
-            QDate::shortDayName( 4 ),
-            QDate::shortDayName( 5 ),
-            QDate::shortDayName( 6 ),
-            QDate::shortDayName( 7 ),
-            tr( "Total" )
-        };
-        const QString DayHeadlines[NumberOfColumns] = {
-            QString(),
-            tr( "%1" ).arg( startDate().day(), 2, 10, QLatin1Char('0') ),
-            tr( "%1" ).arg( startDate().addDays( 1 ).day(), 2, 10, QLatin1Char('0') ),
-            tr( "%1" ).arg( startDate().addDays( 2 ).day(), 2, 10, QLatin1Char('0') ),
-            tr( "%1" ).arg( startDate().addDays( 3 ).day(), 2, 10, QLatin1Char('0') ),
-            tr( "%1" ).arg( startDate().addDays( 4 ).day(), 2, 10, QLatin1Char('0') ),
-            tr( "%1" ).arg( startDate().addDays( 5 ).day(), 2, 10, QLatin1Char('0') ),
-            tr( "%1" ).arg( startDate().addDays( 6 ).day(), 2, 10, QLatin1Char('0') ),
-            QString()
-        };
-
-        for ( int i = 0; i < NumberOfColumns; ++i )
-        {
-            QDomElement header = doc.createElement( QStringLiteral("th") );
-            QDomText text = doc.createTextNode( Headlines[i] );
-            header.appendChild( text );
-            headerRow.appendChild( header );
-            QDomElement dayHeader = doc.createElement( QStringLiteral("th") );
-            QDomText dayText = doc.createTextNode( DayHeadlines[i] );
-            dayHeader.appendChild( dayText );
-            headerDayRow.appendChild( dayHeader );
-        }
-
-        for ( int i = 0; i < timeSheetInfo.size(); ++i )
-        {
-            QDomElement row = doc.createElement( QStringLiteral("tr") );
-            if (i % 2)
-                row.setAttribute( QStringLiteral("class"), QStringLiteral("alternate_row") );
-            table.appendChild( row );
-
-            QString texts[NumberOfColumns];
-            texts[Column_Task] = timeSheetInfo[i].formattedTaskIdAndName( CONFIGURATION.taskPaddingLength );
-            texts[Column_Monday] = hoursAndMinutes( timeSheetInfo[i].seconds[0] );
-            texts[Column_Tuesday] = hoursAndMinutes( timeSheetInfo[i].seconds[1] );
-            texts[Column_Wednesday] = hoursAndMinutes( timeSheetInfo[i].seconds[2] );
-            texts[Column_Thursday] = hoursAndMinutes( timeSheetInfo[i].seconds[3] );
-            texts[Column_Friday] = hoursAndMinutes( timeSheetInfo[i].seconds[4] );
-            texts[Column_Saturday] = hoursAndMinutes( timeSheetInfo[i].seconds[5] );
-            texts[Column_Sunday] = hoursAndMinutes( timeSheetInfo[i].seconds[6] );
-            texts[Column_Total] = hoursAndMinutes( timeSheetInfo[i].total() );
-
-            for ( int column = 0; column < NumberOfColumns; ++column )
-            {
-                QDomElement cell = doc.createElement( QStringLiteral("td") );
-                cell.setAttribute( QStringLiteral("align"), column == Column_Task ? QStringLiteral("left") : QStringLiteral("center") );
-
-                if ( column == Column_Task ) {
-                    QString style = QStringLiteral( "text-indent: %1px;" )
-                            .arg( 9 * timeSheetInfo[i].indentation );
-                    cell.setAttribute( QStringLiteral("style"), style );
-                }
+TaskPivot::Buckets WeeklyTimeSheetReport::days() const
+{
+    return TaskPivot::Buckets::custom( startDate(), endDate(), DaysInWeek, []( const QDate& day ) {
+        return day.dayOfWeek() - 1;
+    } );
+}
 
+QString WeeklyTimeSheetReport::caption() const
+{
+    return tr( "Report for %1, Week %2 (%3 to %4)" )
+           .arg( CONFIGURATION.user.name() )
+           .arg( m_weekNumber, 2, 10, QLatin1Char('0') )
+           .arg( startDate().toString( Qt::TextDate ) )
+           .arg( endDate().addDays( -1 ).toString( Qt::TextDate ) );
+}
 
-                QDomText text = doc.createTextNode( texts[column] );
-                cell.appendChild( text );
-                row.appendChild( cell );
-            }
-        }
-        // put the totals:
-        QString TotalsTexts[NumberOfColumns] = {
-            tr( "Total:" ),
-            hoursAndMinutes( totalsLine.seconds[0] ),
-            hoursAndMinutes( totalsLine.seconds[1] ),
-            hoursAndMinutes( totalsLine.seconds[2] ),
-            hoursAndMinutes( totalsLine.seconds[3] ),
-            hoursAndMinutes( totalsLine.seconds[4] ),
-            hoursAndMinutes( totalsLine.seconds[5] ),
-            hoursAndMinutes( totalsLine.seconds[6] ),
-            hoursAndMinutes( totalsLine.total() )
-        };
-        QDomElement totals = doc.createElement( QStringLiteral("tr") );
-        totals.setAttribute( QStringLiteral("class"), QStringLiteral("header_row") );
-        table.appendChild( totals );
-        for ( int i = 0; i < NumberOfColumns; ++i )
-        {
-            QDomElement cell = doc.createElement( QStringLiteral("th") );
-            QDomText text = doc.createTextNode( TotalsTexts[i] );
-            cell.appendChild( text );
-            totals.appendChild( cell );
-        }
+void WeeklyTimeSheetReport::update()
+{   // this creates the time sheet
+    // for every task, the seconds for every day of the week:
+    Layout layout;
+    layout.heading = tr( "Weekly Time Sheet" );
+    layout.caption = caption();
+    layout.previousLink = tr( "<Previous Week>" );
+    layout.nextLink = tr( "<Next Week>" );
+    QStringList header;
+    QStringList dayHeader;
+    header << tr( "Task" );
+    dayHeader << QString();
+    for ( int day = 0; day < DaysInWeek; ++day ) {
+        header << QDate::shortDayName( day + 1 );
+        dayHeader << tr( "%1" ).arg( startDate().addDays( day ).day(), 2, 10, QLatin1Char('0') );
     }
-
-    // NOTE: seems like the style sheet has to be set before the html
-    // code is pushed into the QTextDocument
-    report.setDefaultStyleSheet(Charm::reportStylesheet(palette()));
-
-    report.setHtml( doc.toString() );
-    setDocument( &report );
+    header << tr( "Total" );
+    dayHeader << QString();
+    layout.headerRows << header << dayHeader;
+    generateTimeSheet( days(), layout );
     uploadButton()->setEnabled(true);
 }
 
@@ -518,7 +284,8 @@ QByteArray WeeklyTimeSheetReport::saveToXml()
 {
     try {
         WeeklyTimesheetXmlWriter timesheet;
-        timesheet.setDataModel( DATAMODEL );
+        timesheet.setSnapshot( DATAMODEL->snapshot() );
+        timesheet.setUserName( CONFIGURATION.user.name() );
         timesheet.setYear( m_yearOfWeek );
         timesheet.setWeekNumber( m_weekNumber );
         timesheet.setRootTask( rootTask() );
@@ -539,35 +306,7 @@ QByteArray WeeklyTimeSheetReport::saveToXml()
 
 QByteArray WeeklyTimeSheetReport::saveToText()
 {
-    QByteArray output;
-    QTextStream stream( &output );
-    QString content = tr( "Report for %1, Week %2 (%3 to %4)" )
-                      .arg( CONFIGURATION.user.name() )
-                      .arg( m_weekNumber, 2, 10, QLatin1Char('0') )
-                      .arg( startDate().toString( Qt::TextDate ) )
-                      .arg( endDate().addDays( -1 ).toString( Qt::TextDate ) );
-    stream << content << '\n';
-    stream << '\n';
-    TimeSheetInfoList timeSheetInfo = TimeSheetInfo::filteredTaskWithSubTasks(
-        TimeSheetInfo::taskWithSubTasks( DATAMODEL, DaysInWeek, rootTask(), secondsMap() ),
-        activeTasksOnly() );
-
-    TimeSheetInfo totalsLine( DaysInWeek );
-    if ( ! timeSheetInfo.isEmpty() ) {
-        totalsLine = timeSheetInfo.first();
-        if( rootTask() == 0 ) {
-            timeSheetInfo.removeAt( 0 ); // there is always one, because there is always the root item
-        }
-    }
-
-    for (int i = 0; i < timeSheetInfo.size(); ++i ) {
-        stream << timeSheetInfo[i].formattedTaskIdAndName( CONFIGURATION.taskPaddingLength ) << "\t" << hoursAndMinutes( timeSheetInfo[i].total() ) << '\n';
-    }
-    stream << '\n';
-    stream << "Week total: " << hoursAndMinutes( totalsLine.total() ) << '\n';
-    stream.flush();
-
-    return output;
+    return timeSheetText( days(), caption(), QStringLiteral( "Week total: " ) );
 }
 
 void WeeklyTimeSheetReport::slotLinkClicked( const QUrl& which )
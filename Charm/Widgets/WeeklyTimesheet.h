@@ -28,7 +28,7 @@
 #include <Core/TimeSpans.h>
 
 #include "Timesheet.h"
-#include "ReportConfigurationDialog.h"
+#include "Reports/WeeklyTimesheetBatch.h"
 
 #include <QScopedPointer>
 
@@ -39,13 +39,12 @@ namespace Ui {
 class HttpJob;
 class QUrl;
 
-typedef QHash<int, QVector<int> > WeeksByYear;
 ///Set the timesheet for the @param week of the @param year as having been uploaded
 void addUploadedTimesheet(int year, int week);
 ///Get all missing timesheets
 WeeksByYear missingTimeSheets();
 
-class WeeklyTimesheetConfigurationDialog : public ReportConfigurationDialog
+class WeeklyTimesheetConfigurationDialog : public TimeSheetConfigurationDialog
 {
     Q_OBJECT
 
@@ -54,22 +53,15 @@ public:
     ~WeeklyTimesheetConfigurationDialog() override;
 
     void showReportPreviewDialog() override;
-    void showEvent( QShowEvent* ) override;
     void setDefaultWeek( int yearOfWeek, int week );
 
-public Q_SLOTS:
-    void accept() override;
-
 private Q_SLOTS:
-    void slotCheckboxSubtasksOnlyChecked( bool );
     void slotStandardTimeSpansChanged();
     void slotWeekComboItemSelected( int );
-    void slotSelectTask();
 
 private:
     QScopedPointer<Ui::WeeklyTimesheetConfigurationDialog> m_ui;
     QList<NamedTimeSpan> m_weekInfo;
-    TaskId m_rootTask = {};
 };
 
 class WeeklyTimeSheetReport : public TimeSheetReport
@@ -91,6 +83,8 @@ private Q_SLOTS:
     void slotLinkClicked( const QUrl& which );
 
 private:
+    TaskPivot::Buckets days() const;
+    QString caption() const;
     QString suggestedFileName() const override;
     void update() override;
     QByteArray saveToXml() override;
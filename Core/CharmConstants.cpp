@@ -101,9 +101,14 @@ static QString formatDecimal( double d ) {
 }
 
 QString hoursAndMinutes( int duration )
+{
+    return hoursAndMinutes( duration, CONFIGURATION.durationFormat );
+}
+
+QString hoursAndMinutes( int duration, Configuration::DurationFormat format )
 {
     if ( duration == 0 ) {
-        if ( CONFIGURATION.durationFormat == Configuration::Minutes )
+        if ( format == Configuration::Minutes )
             return QObject::tr( "00:00" );
         else
             return formatDecimal( 0.0 );
@@ -112,7 +117,7 @@ QString hoursAndMinutes( int duration )
     int hours = minutes / 60;
     minutes = minutes % 60;
 
-    if ( CONFIGURATION.durationFormat == Configuration::Minutes ) {
+    if ( format == Configuration::Minutes ) {
         QString text;
         QTextStream stream( &text );
         stream << qSetFieldWidth( 2 ) << qSetPadChar( QLatin1Char('0' ) )
@@ -111,5 +111,8 @@ void connectControllerAndModel( Controller*, CharmDataModel* );
 // helpers:
 /** A string containing hh:mm for the given duration of seconds. */
 QString hoursAndMinutes( int seconds );
+/** Same as above, in @p format instead of the configured one, for
+    reports that are generated off the GUI thread. */
+QString hoursAndMinutes( int seconds, Configuration::DurationFormat format );
 
 #endif
@@ -31,6 +31,8 @@
 #include "Configuration.h"
 
 #include <QList>
+#include <QPair>
+#include <QVector>
 #include <QtDebug>
 #include <QDateTime>
 #include <QSettings>
@@ -38,12 +40,15 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <queue>
 
 CharmDataModel::CharmDataModel()
     : QObject()
 {
     connect( &m_timer, SIGNAL(timeout()), SLOT(eventUpdateTimerEvent()) );
+    m_validityTimer.setSingleShot( true );
+    connect( &m_validityTimer, SIGNAL(timeout()), SLOT(validityTimerEvent()) );
 }
 
 CharmDataModel::~CharmDataModel()
@@ -79,20 +84,23 @@ void CharmDataModel::unregisterAdapter( CharmDataModelAdapterInterface* adapter
 
 void CharmDataModel::setAllTasks( const TaskList& tasks )
 {
-    clearTasks();
+    Q_ASSERT_X( Task::checkTaskList( tasks ).isEmpty(), Q_FUNC_INFO,
+                "The tasks have to form a tree and have unique task ids" );
 
-    Q_ASSERT( Task::checkForTreeness( tasks ) );
-    Q_ASSERT( Task::checkForUniqueTaskIds( tasks ) );
+    // after a sync or an import, usually only a few tasks have changed:
+    if ( ! m_tasks.empty() && applyTaskChanges( tasks ) )
+        return;
+
+    clearTasks();
 
     // fill the tasks into the map to TaskTreeItems
     for ( int i = 0; i < tasks.size(); ++i )
     {
-        const TaskTreeItem item( tasks[i], &m_rootItem );
         Q_ASSERT( ! taskExists( tasks[i].id() ) ); // the tasks form a tree and have unique task ids
-        m_tasks[ tasks[i].id() ] = item;
+        m_tasks.insert( std::make_pair( tasks[i].id(), TaskTreeItem( tasks[i] ) ) );
     }
 
-    // create parent-child-relationships:
+    // create parent-child-relationships (the items in the map do not move anymore):
     for ( TaskTreeItem::Map::iterator it = m_tasks.begin(); it != m_tasks.end(); ++it )
     {
         const Task& task = it->second.task();
@@ -104,6 +112,11 @@ void CharmDataModel::setAllTasks( const TaskList& tasks )
     determineTaskPaddingLength();
 
     m_nameCache.setAllTasks( tasks );
+    m_rollup.setAllTasks( tasks );
+    m_validity.setAllTasks( tasks, QDateTime::currentMSecsSinceEpoch() );
+    scheduleValidityTimer();
+    m_searchIndexPadding = -1;
+    tasksChanged();
 
     // notify adapters of changes
     for_each( m_adapters.begin(), m_adapters.end(),
@@ -112,6 +125,77 @@ void CharmDataModel::setAllTasks( const TaskList& tasks )
     emit resetGUIState();
 }
 
+bool CharmDataModel::applyTaskChanges( const TaskList& tasks )
+{
+    QSet<TaskId> ids;
+    ids.reserve( tasks.size() );
+    TaskList added;
+    TaskList modified;
+    Q_FOREACH( const Task& task, tasks ) {
+        ids.insert( task.id() );
+        const auto it = m_tasks.find( task.id() );
+        if ( it == m_tasks.end() ) {
+            added.append( task );
+        } else if ( it->second.task() != task ) {
+            modified.append( task );
+        }
+    }
+    TaskIdList deleted;
+    for ( auto it = m_tasks.begin(); it != m_tasks.end(); ++it ) {
+        if ( ! ids.contains( it->first ) )
+            deleted.append( it->first );
+    }
+
+    const int changes = added.size() + modified.size() + deleted.size();
+    if ( changes > int( m_tasks.size() ) / 2 )
+        return false; // rebuilding is cheaper
+
+    // The steps below may fail half way. The caller then rebuilds the
+    // tree from scratch, so the partially applied changes do no harm.
+
+    // add new tasks once their parents exist:
+    while ( ! added.isEmpty() ) {
+        TaskList pending;
+        Q_FOREACH( const Task& task, added ) {
+            if ( task.parent() <= 0 || taskExists( task.parent() ) ) {
+                addTask( task );
+            } else {
+                pending.append( task );
+            }
+        }
+        if ( pending.size() == added.size() )
+            return false; // orphans
+        added = pending;
+    }
+
+    Q_FOREACH( const Task& task, modified ) {
+        // moving a task below one of its current descendants would
+        // create a loop on the way:
+        if ( task.parent() > 0
+             && ( task.parent() == task.id() || isParentOf( task.id(), task.parent() ) ) )
+            return false;
+        modifyTask( task );
+    }
+
+    // the remaining children of deleted tasks are deleted as well, remove
+    // the deepest tasks first:
+    QVector<QPair<int, TaskId> > byDepth;
+    byDepth.reserve( deleted.size() );
+    Q_FOREACH( TaskId id, deleted ) {
+        int depth = 0;
+        for ( TaskId parent = getTask( id ).parent(); parent > 0; parent = getTask( parent ).parent() )
+            ++depth;
+        byDepth.append( qMakePair( depth, id ) );
+    }
+    std::sort( byDepth.begin(), byDepth.end(), std::greater<QPair<int, TaskId> >() );
+    for ( int i = 0; i < byDepth.size(); ++i ) {
+        const Task task = getTask( byDepth[i].second );
+        deleteTask( task );
+    }
+
+    return true;
+}
+
 void CharmDataModel::addTask( const Task& task )
 {
     Q_ASSERT_X( ! taskExists( task.id() ), Q_FUNC_INFO,
@@ -124,14 +208,16 @@ void CharmDataModel::addTask( const Task& task )
             adapter->taskAboutToBeAdded( parent.task().id(),
                                          parent.childCount() );
 
-        const TaskTreeItem item ( task );
-        m_tasks[ task.id() ] = item;
+        const auto it = m_tasks.insert( std::make_pair( task.id(), TaskTreeItem( task ) ) ).first;
         m_nameCache.addTask( task );
+        m_rollup.addTask( task );
+        m_validity.setTask( task, QDateTime::currentMSecsSinceEpoch() );
+        scheduleValidityTimer();
+        m_searchIndexOutdated.insert( task.id() );
 
-        // the item in the map has a different address, let's find it:
-        Q_ASSERT( taskExists( task.id() ) ); // we just put it in
-        const auto it = m_tasks.find( task.id() );
+        // only link the item that lives in the map, copies are not part of the tree:
         it->second.makeChildOf( parentItem( task ) );
+        tasksChanged();
 
         determineTaskPaddingLength();
 //        regenerateSmartNames();
@@ -155,21 +241,28 @@ void CharmDataModel::modifyTask( const Task& task )
     const TaskId oldParentId = it->second.task().parent();
     const bool parentChanged = task.parent() != oldParentId;
 
+    const bool nameChanged = task.name() != it->second.task().name();
+
     if ( parentChanged ) {
         Q_FOREACH( auto adapter, m_adapters )
-            adapter->taskParentChanged( task.id(), oldParentId, task.parent() );
+            adapter->taskParentAboutToChange( task.id(), oldParentId, task.parent() );
         m_tasks[ task.id() ].makeChildOf( parentItem( task ) );
     }
 
     m_tasks[ task.id() ].task() = task;
+    tasksChanged();
     m_nameCache.modifyTask( task );
+    m_rollup.modifyTask( task );
+    m_validity.setTask( task, QDateTime::currentMSecsSinceEpoch() );
+    scheduleValidityTimer();
+    m_searchIndexOutdated.insert( task.id() );
+    if ( parentChanged || nameChanged )
+        invalidateFullTaskNames( it->second );
 
-    if( parentChanged ) {
-        Q_FOREACH( auto adapter, m_adapters )
-            adapter->resetTasks();
-    } else {
-        Q_FOREACH( auto adapter, m_adapters )
-            adapter->taskModified( task.id() );
+    Q_FOREACH( auto adapter, m_adapters ) {
+        if ( parentChanged )
+            adapter->taskParentChanged( task.id(), oldParentId, task.parent() );
+        adapter->taskModified( task.id() );
     }
 }
 
@@ -186,12 +279,18 @@ void CharmDataModel::deleteTask( const Task& task )
 
     const auto it = m_tasks.find( task.id() );
     if ( it != m_tasks.end() ) {
-        TaskTreeItem tmpParent;
-        it->second.makeChildOf( tmpParent );
+        // the destructor unregisters the item with its parent:
         m_tasks.erase( it );
     }
+    m_fullTaskNames.remove( task.id() );
+    tasksChanged();
 
     m_nameCache.deleteTask( task );
+    m_rollup.deleteTask( task );
+    m_validity.removeTask( task.id() );
+    scheduleValidityTimer();
+    m_searchIndex.removeTask( task.id() );
+    m_searchIndexOutdated.remove( task.id() );
 
     Q_FOREACH( auto adapter, m_adapters )
         adapter->taskDeleted( task.id() );
@@ -199,15 +298,18 @@ void CharmDataModel::deleteTask( const Task& task )
 
 void CharmDataModel::clearTasks()
 {
-    // to clear the task list, all tasks have first to be changed to be children of the root item:
-    for ( TaskTreeItem::Map::iterator it = m_tasks.begin(); it != m_tasks.end(); ++it )
-    {
-        it->second.makeChildOf( m_rootItem );
-    }
+    // all items are discarded, so unlink the whole tree at once instead of
+    // removing the items one by one from their parents' lists of children:
+    m_rootItem.releaseSubtree();
 
     m_tasks.clear();
     m_nameCache.clearTasks();
-    m_rootItem = TaskTreeItem();
+    m_rollup.clearTasks();
+    m_validity.clear();
+    m_validityTimer.stop();
+    m_fullTaskNames.clear();
+    m_searchIndexPadding = -1;
+    tasksChanged();
 
     Q_FOREACH( auto adapter, m_adapters )
         adapter->resetTasks();
@@ -215,6 +317,10 @@ void CharmDataModel::clearTasks()
 
 void CharmDataModel::setAllEvents( const EventList& events )
 {
+    // after a sync or an import, usually only a few events have changed:
+    if ( ! m_events.empty() && applyEventChanges( events ) )
+        return;
+
     m_events.clear();
 
     for ( int i = 0; i < events.size(); ++i )
@@ -227,19 +333,86 @@ void CharmDataModel::setAllEvents( const EventList& events )
         }
     }
 
+    eventsChanged();
+    m_rollup.setAllEvents( m_events );
+    m_timeIndex.setAllEvents( m_events );
+
+    // the reset supersedes the changes collected so far:
+    m_batchAddedEvents.clear();
+    m_batchModifiedEvents.clear();
+    m_batchDeletedEvents.clear();
+
     Q_FOREACH( auto adapter, m_adapters )
         adapter->resetEvents();
 }
 
+bool CharmDataModel::applyEventChanges( const EventList& events )
+{
+    QSet<EventId> ids;
+    ids.reserve( events.size() );
+    EventList added;
+    EventList modified;
+    Q_FOREACH( const Event& event, events ) {
+        if ( ids.contains( event.id() ) ) {
+            qCritical() << "CharmDataModel::setAllEvents: duplicate event id"
+                        << event.id() << "ignored. THIS IS A BUG";
+            continue;
+        }
+        ids.insert( event.id() );
+        const auto it = m_events.find( event.id() );
+        if ( it == m_events.end() ) {
+            added.append( event );
+        } else if ( it->second != event ) {
+            modified.append( event );
+        }
+    }
+    EventIdList deleted;
+    for ( auto it = m_events.begin(); it != m_events.end(); ++it ) {
+        if ( ! ids.contains( it->first ) ) {
+            if ( m_activeEventIds.contains( it->first ) )
+                return false; // active events cannot be deleted
+            deleted.append( it->first );
+        }
+    }
+
+    const int changes = added.size() + modified.size() + deleted.size();
+    if ( changes > int( m_events.size() ) / 2 )
+        return false; // resetting is cheaper
+
+    const EventBatch batch( this );
+    Q_FOREACH( const Event& event, added )
+        addEvent( event );
+    Q_FOREACH( const Event& event, modified )
+        modifyEvent( event );
+    Q_FOREACH( EventId id, deleted ) {
+        const Event event = eventForId( id );
+        deleteEvent( event );
+    }
+    return true;
+}
+
 void CharmDataModel::addEvent( const Event& event )
 {
     Q_ASSERT_X( ! eventExists( event.id() ), Q_FUNC_INFO,
                 "New event must have a unique id" );
 
+    if ( m_eventBatchLevel > 0 ) {
+        m_events[ event.id() ] = event;
+        indexAddedEvent( event );
+        if ( m_batchDeletedEvents.remove( event.id() ) ) {
+            // the id was reused, the adapters still know the row:
+            m_batchModifiedEvents.insert( event.id() );
+        } else {
+            m_batchAddedEvents.insert( event.id() );
+        }
+        return;
+    }
+
     Q_FOREACH( auto adapter, m_adapters )
         adapter->eventAboutToBeAdded( event.id() );
 
     m_events[ event.id() ] = event;
+    indexAddedEvent( event );
 
     Q_FOREACH( auto adapter, m_adapters )
         adapter->eventAdded( event.id() );
@@ -253,6 +426,13 @@ void CharmDataModel::modifyEvent( const Event& newEvent )
     const Event oldEvent = eventForId( newEvent.id() );
 
     m_events[ newEvent.id() ] = newEvent;
+    indexModifiedEvent( newEvent );
+
+    if ( m_eventBatchLevel > 0 ) {
+        if ( ! m_batchAddedEvents.contains( newEvent.id() ) )
+            m_batchModifiedEvents.insert( newEvent.id() );
+        return;
+    }
 
     Q_FOREACH( auto adapter, m_adapters )
         adapter->eventModified( newEvent.id(), oldEvent );
@@ -265,12 +445,25 @@ void CharmDataModel::deleteEvent( const Event& event )
     Q_ASSERT_X( !m_activeEventIds.contains( event.id() ), Q_FUNC_INFO,
                 "Cannot delete an active event" );
 
+    if ( m_eventBatchLevel > 0 ) {
+        const EventId id = event.id();
+        m_events.erase( id );
+        indexDeletedEvent( id );
+        // events added in this batch were never announced:
+        if ( ! m_batchAddedEvents.remove( id ) ) {
+            m_batchModifiedEvents.remove( id );
+            m_batchDeletedEvents.insert( id );
+        }
+        return;
+    }
+
     Q_FOREACH( auto adapter, m_adapters )
         adapter->eventAboutToBeDeleted( event.id() );
 
     const auto it = m_events.find( event.id() );
     if ( it != m_events.end() )
         m_events.erase( it );
+    indexDeletedEvent( event.id() );
 
     Q_FOREACH( auto adapter, m_adapters )
         adapter->eventDeleted( event.id() );
@@ -279,11 +472,56 @@ void CharmDataModel::deleteEvent( const Event& event )
 void CharmDataModel::clearEvents()
 {
     m_events.clear();
+    eventsChanged();
+    m_rollup.clearEvents();
+    m_timeIndex.clearEvents();
+    m_batchAddedEvents.clear();
+    m_batchModifiedEvents.clear();
+    m_batchDeletedEvents.clear();
 
     Q_FOREACH( auto adapter, m_adapters )
         adapter->resetEvents();
 }
 
+void CharmDataModel::beginEventBatch()
+{
+    ++m_eventBatchLevel;
+}
+
+static EventIdList sortedEventIds( const QSet<EventId>& ids )
+{
+    EventIdList result;
+    result.reserve( ids.size() );
+    Q_FOREACH( EventId id, ids )
+        result.append( id );
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+void CharmDataModel::commitEventBatch()
+{
+    Q_ASSERT_X( m_eventBatchLevel > 0, Q_FUNC_INFO,
+                "commitEventBatch() without beginEventBatch()" );
+    if ( --m_eventBatchLevel > 0 )
+        return;
+
+    const EventIdList added = sortedEventIds( m_batchAddedEvents );
+    const EventIdList modified = sortedEventIds( m_batchModifiedEvents );
+    const EventIdList deleted = sortedEventIds( m_batchDeletedEvents );
+    m_batchAddedEvents.clear();
+    m_batchModifiedEvents.clear();
+    m_batchDeletedEvents.clear();
+
+    Q_FOREACH( auto adapter, m_adapters ) {
+        if ( ! deleted.isEmpty() )
+            adapter->eventsDeleted( deleted );
+        if ( ! added.isEmpty() )
+            adapter->eventsAdded( added );
+        if ( ! modified.isEmpty() )
+            adapter->eventsModified( modified );
+    }
+}
+
 const TaskTreeItem& CharmDataModel::taskTreeItem( TaskId id ) const
 {
     if ( id <= 0 ) return m_rootItem;
@@ -357,6 +595,8 @@ bool CharmDataModel::activateEvent( const Event& activeEvent )
     }
 
     m_activeEventIds << activeEvent.id();
+    // the snapshots copy the active events, the event data is unchanged:
+    m_generation.fetchAndAddOrdered( 1 );
     Q_FOREACH( auto adapter, m_adapters ) {
         adapter->eventActivated( activeEvent.id() );
     }
@@ -380,9 +620,10 @@ void CharmDataModel::determineTaskPaddingLength()
 
 TaskTreeItem& CharmDataModel::parentItem( const Task& task )
 {
-    TaskTreeItem& parent = m_tasks[ task.parent() ];
-    if ( parent.isValid() ) {
-        return parent;
+    const auto it = m_tasks.find( task.parent() );
+    // checks the task, not the item: during setAllTasks the parent might not be linked yet
+    if ( it != m_tasks.end() && it->second.task().isValid() ) {
+        return it->second;
     } else {
         return m_rootItem;
     }
@@ -464,6 +705,7 @@ void CharmDataModel::endEventRequested( const Task& task )
     Event& event = findEvent( eventId );
     Event old = event;
     event.setEndDateTime( QDateTime::currentDateTime() );
+    indexModifiedEvent( event );
 
     emit requestEventModification( event, old );
 
@@ -485,6 +727,7 @@ void CharmDataModel::endAllEventsRequested()
         Event& event = findEvent( eventId );
         Event old = event;
         event.setEndDateTime( currentDateTime );
+        indexModifiedEvent( event );
 
         emit requestEventModification( event, old );
     }
@@ -507,17 +750,56 @@ void CharmDataModel::eventUpdateTimerEvent()
     updateToolTip();
 }
 
+void CharmDataModel::scheduleValidityTimer()
+{
+    const qint64 next = m_validity.nextChange();
+    if ( next == std::numeric_limits<qint64>::max() ) {
+        m_validityTimer.stop();
+        return;
+    }
+    // QTimer takes an int, far away boundaries are approached in steps:
+    const qint64 wait = next - QDateTime::currentMSecsSinceEpoch();
+    m_validityTimer.start( int( qBound( qint64( 0 ), wait, qint64( 24 * 60 * 60 * 1000 ) ) ) );
+}
+
+void CharmDataModel::validityTimerEvent()
+{
+    const TaskIdList changed = m_validity.advance( QDateTime::currentMSecsSinceEpoch() );
+    scheduleValidityTimer();
+    if ( changed.isEmpty() )
+        return;
+
+    // the tasks themselves did not change, but views that cache task
+    // derived data have to look at them again:
+    ++m_taskGeneration;
+    Q_FOREACH( TaskId id, changed ) {
+        Q_FOREACH( auto adapter, m_adapters )
+            adapter->taskModified( id );
+    }
+}
+
+bool CharmDataModel::isTaskCurrentlyValid( TaskId id ) const
+{
+    return m_validity.isCurrentlyValid( id );
+}
+
 QString CharmDataModel::fullTaskName( const Task& task ) const
 {
     if ( task.isValid() ) {
-        QString name = task.name().simplified();
-
-        if ( task.parent() != 0 ) {
-            const Task& parent = getTask( task.parent() );
-            if ( parent.isValid() ) {
-                name = fullTaskName( parent ) + QLatin1Char('/') + name;
-            }
+        // only the tasks stored in the model are cached, a modified copy
+        // of a task gets its name computed:
+        const Task& modelTask = getTask( task.id() );
+        if ( modelTask.id() != task.id() || modelTask.parent() != task.parent()
+             || modelTask.name() != task.name() ) {
+            return buildFullTaskName( task );
         }
+
+        const auto it = m_fullTaskNames.constFind( task.id() );
+        if ( it != m_fullTaskNames.constEnd() )
+            return it.value();
+
+        const QString name = buildFullTaskName( task );
+        m_fullTaskNames.insert( task.id(), name );
         return name;
     } else {
         // qWarning() << "CharmReport::tasknameWithParents: WARNING: invalid task"
@@ -526,11 +808,44 @@ QString CharmDataModel::fullTaskName( const Task& task ) const
     }
 }
 
+QString CharmDataModel::buildFullTaskName( const Task& task ) const
+{
+    QString name = task.name().simplified();
+
+    if ( task.parent() != 0 ) {
+        const Task& parent = getTask( task.parent() );
+        if ( parent.isValid() ) {
+            // the parent is a task of the model, so its name is cached:
+            name = fullTaskName( parent ) + QLatin1Char('/') + name;
+        }
+    }
+    return name;
+}
+
+void CharmDataModel::invalidateFullTaskNames( const TaskTreeItem& item )
+{
+    // the full names of all tasks below item contain its name:
+    m_fullTaskNames.remove( item.task().id() );
+    m_searchIndexOutdated.insert( item.task().id() );
+    for ( int i = 0; i < item.childCount(); ++i )
+        invalidateFullTaskNames( item.child( i ) );
+}
+
 QString CharmDataModel::smartTaskName( const Task & task ) const
 {
     return m_nameCache.smartName( task.id() );
 }
 
+const DurationRollup& CharmDataModel::durationRollup() const
+{
+    return m_rollup;
+}
+
+const EventTimeIndex& CharmDataModel::eventTimeIndex() const
+{
+    return m_timeIndex;
+}
+
 QString CharmDataModel::eventsString() const
 {
     QStringList eStrList;
@@ -556,6 +871,28 @@ QString CharmDataModel::taskIdAndFullNameString(TaskId id) const
             .arg( fullTaskName( getTask( id ) ) );
 }
 
+TaskIdList CharmDataModel::searchTasks( const QString& text ) const
+{
+    // the texts contain the padded ids, a new padding changes all of them:
+    if ( m_searchIndexPadding != CONFIGURATION.taskPaddingLength ) {
+        m_searchIndex.clear();
+        m_searchIndexOutdated.clear();
+        for ( auto it = m_tasks.begin(); it != m_tasks.end(); ++it )
+            m_searchIndexOutdated.insert( it->first );
+        m_searchIndexPadding = CONFIGURATION.taskPaddingLength;
+    }
+    Q_FOREACH( TaskId id, m_searchIndexOutdated ) {
+        const Task& task = getTask( id );
+        if ( task.isValid() ) {
+            m_searchIndex.setText( id, taskIdAndFullNameString( id )
+                                   + QLatin1Char( ' ' ) + task.comment() );
+        }
+    }
+    m_searchIndexOutdated.clear();
+
+    return m_searchIndex.find( text );
+}
+
 QString CharmDataModel::taskIdAndSmartNameString(TaskId id) const
 {
     return QStringLiteral("%1 %2")
@@ -626,20 +963,11 @@ int CharmDataModel::activeEventCount() const
 EventIdList CharmDataModel::eventsThatStartInTimeFrame( const QDate& start,
                                                         const QDate& end ) const
 {
-    // do the comparisons in UTC, which is much faster as we only need to convert
-    // start and end date then
-    const QDateTime startUTC = QDateTime(start, QTime(0, 0, 0)).toUTC();
-    const QDateTime endUTC = QDateTime(end, QTime(0, 0, 0)).toUTC();
-    EventIdList events;
-    EventMap::const_iterator it;
-    for ( it = m_events.begin();
-          it != m_events.end(); ++it ) {
-        const Event& event( it->second );
-        if ( event.startDateTime(Qt::UTC) >= startUTC && event.startDateTime(Qt::UTC) < endUTC ) {
-            events << event.id();
-        }
-    }
-
+    if ( !end.isValid() )
+        return EventIdList();
+    // the time index only visits the days in the time frame:
+    EventIdList events = m_timeIndex.eventsStartingBetween( start, end );
+    std::sort( events.begin(), events.end() );
     return events;
 }
 
@@ -743,9 +1071,115 @@ TaskIdList CharmDataModel::mostRecentlyUsedTasks() const
     return mru;
 }
 
+void CharmDataModel::tasksChanged()
+{
+    m_snapshotTasks.reset();
+    m_generation.fetchAndAddOrdered( 1 );
+    ++m_taskGeneration;
+}
+
+void CharmDataModel::eventsChanged()
+{
+    m_snapshotEventsOutdated = true;
+    m_changedEventDays.clear();
+    m_generation.fetchAndAddOrdered( 1 );
+}
+
+void CharmDataModel::indexAddedEvent( const Event& event )
+{
+    m_rollup.addEvent( event );
+    m_timeIndex.addEvent( event );
+    eventDayChanged( event.startDateTime().date() );
+}
+
+void CharmDataModel::indexModifiedEvent( const Event& event )
+{
+    // the event may move to another day:
+    eventDayChanged( m_timeIndex.dayOf( event.id() ) );
+    m_rollup.modifyEvent( event );
+    m_timeIndex.modifyEvent( event );
+    eventDayChanged( event.startDateTime().date() );
+}
+
+void CharmDataModel::indexDeletedEvent( EventId id )
+{
+    eventDayChanged( m_timeIndex.dayOf( id ) );
+    m_rollup.deleteEvent( id );
+    m_timeIndex.deleteEvent( id );
+}
+
+void CharmDataModel::eventDayChanged( const QDate& day )
+{
+    if ( !m_snapshotEventsOutdated )
+        m_changedEventDays.insert( day );
+    m_generation.fetchAndAddOrdered( 1 );
+}
+
+quint64 CharmDataModel::generation() const
+{
+    return m_generation.load();
+}
+
+quint64 CharmDataModel::taskGeneration() const
+{
+    return m_taskGeneration;
+}
+
+CharmDataModelSnapshot CharmDataModel::snapshot() const
+{
+    // only the parts that changed since the last snapshot are copied:
+    if ( !m_snapshotTasks ) {
+        QSharedPointer<CharmDataModelSnapshot::Tasks> tasks( new CharmDataModelSnapshot::Tasks );
+        tasks->list = getAllTasks();
+        tasks->byId.reserve( tasks->list.size() );
+        Q_FOREACH( const Task& task, tasks->list ) {
+            tasks->byId.insert( task.id(), task );
+            // parents come first, tasks without a valid parent are top level tasks:
+            const TaskId parent = tasks->byId.contains( task.parent() ) ? task.parent() : 0;
+            tasks->children[parent].append( task.id() );
+        }
+        m_snapshotTasks = tasks;
+    }
+    if ( m_snapshotEventsOutdated ) {
+        QMap<QDate, QSharedPointer<EventMap> > days;
+        for ( auto it = m_events.begin(); it != m_events.end(); ++it ) {
+            QSharedPointer<EventMap>& day = days[ it->second.startDateTime().date() ];
+            if ( !day )
+                day.reset( new EventMap );
+            day->insert( day->end(), *it );
+        }
+        m_snapshotEventDays.clear();
+        for ( auto it = days.constBegin(); it != days.constEnd(); ++it )
+            m_snapshotEventDays.insert( it.key(), it.value() );
+        m_snapshotEventsOutdated = false;
+    } else {
+        // a running event only changes the events of the day it started on:
+        Q_FOREACH( const QDate& day, m_changedEventDays ) {
+            const EventIdList ids = m_timeIndex.eventsStartingOn( day );
+            if ( ids.isEmpty() ) {
+                m_snapshotEventDays.remove( day );
+                continue;
+            }
+            QSharedPointer<EventMap> events( new EventMap );
+            Q_FOREACH( EventId id, ids )
+                events->insert( *m_events.find( id ) );
+            m_snapshotEventDays.insert( day, events );
+        }
+    }
+    m_changedEventDays.clear();
+
+    CharmDataModelSnapshot snapshot;
+    snapshot.m_generation = generation();
+    snapshot.m_tasks = m_snapshotTasks;
+    snapshot.m_eventDays = m_snapshotEventDays;
+    snapshot.m_timeIndex = m_timeIndex;
+    snapshot.m_activeEventIds = m_activeEventIds;
+    return snapshot;
+}
+
 bool CharmDataModel::operator==( const CharmDataModel& other ) const
 {
-    // not compared: m_timer, m_adapters
+    // not compared: m_timer, m_validityTimer, m_adapters
     if( &other == this ) {
         return true;
     }
@@ -759,6 +1193,8 @@ CharmDataModel* CharmDataModel::clone() const
     auto c = new CharmDataModel();
     c->setAllTasks( getAllTasks() );
     c->m_events = m_events;
+    c->m_rollup.setAllEvents( c->m_events );
+    c->m_timeIndex.setAllEvents( c->m_events );
     c->m_activeEventIds = m_activeEventIds;
     return c;
 }
@@ -27,7 +27,11 @@
 #ifndef CHARMDATAMODEL_H
 #define CHARMDATAMODEL_H
 
+#include <QAtomicInteger>
+#include <QHash>
 #include <QObject>
+#include <QSet>
+#include <QSharedPointer>
 #include <QTimer>
 
 #include "Task.h"
@@ -36,7 +40,12 @@
 #include "TimeSpans.h"
 #include "TaskTreeItem.h"
 #include "CharmDataModelAdapterInterface.h"
+#include "CharmDataModelSnapshot.h"
 #include "SmartNameCache.h"
+#include "DurationRollup.h"
+#include "EventTimeIndex.h"
+#include "TaskSearchIndex.h"
+#include "TaskValiditySchedule.h"
 
 class QAbstractItemModel;
 
@@ -93,6 +102,10 @@ public:
     /** True if task is in the subtree below parent.
      * parent is not element of the subtree, and thus not it's own child. */
     bool isParentOf( TaskId parent, TaskId task ) const;
+    /** Same as Task::isCurrentlyValid(), but kept as state that is updated
+        when the next validity boundary of any task passes. Adapters get a
+        taskModified() call for the tasks that changed. */
+    bool isTaskCurrentlyValid( TaskId id ) const;
 
     // handling of active events:
     /** Is an event active for the task with this id? */
@@ -115,14 +128,25 @@ public:
       * Only tasks that have been used so far will be taken into account, so the list might be empty. */
     TaskIdList mostRecentlyUsedTasks() const;
 
-    /** Create a full task name from the specified TaskId. */
+    /** Create a full task name from the specified TaskId.
+        The names of the tasks in the model are cached, and the cache
+        is invalidated for the affected subtree when a task is renamed
+        or moved. */
     QString fullTaskName( const Task& ) const;
 
     /** Create a "smart" task name (name and shortest path that makes the name unique) from the specified TaskId. */
     QString smartTaskName( const Task& ) const;
 
+    /** The seconds recorded per task and day, see DurationRollup. */
+    const DurationRollup& durationRollup() const;
+    /** The events by the day they start on, see EventTimeIndex. */
+    const EventTimeIndex& eventTimeIndex() const;
+
     /** Get the task id and full name as a single string. */
     QString taskIdAndFullNameString(TaskId id) const;
+    /** The tasks whose id, full name or comment contain the words of
+        @p text, sorted by id. See TaskSearchIndex. */
+    TaskIdList searchTasks( const QString& text ) const;
 
     /** Get the task id and name as a single string. */
     QString taskIdAndNameString(TaskId id) const;
@@ -130,6 +154,27 @@ public:
     /** Get the task id and smart name as a single string. */
     QString taskIdAndSmartNameString(TaskId id) const;
 
+    /** Start collecting event changes.
+        Until the matching commitEventBatch(), added, modified and
+        deleted events are applied to the model right away, but the
+        adapters are not notified about them. Batches may be nested. */
+    void beginEventBatch();
+    /** Finish a batch started with beginEventBatch().
+        When the outermost batch is committed, every adapter receives at
+        most one eventsAdded(), eventsModified() and eventsDeleted() call
+        with the coalesced changes. */
+    void commitEventBatch();
+
+    /** Create a read-only copy of the current tasks and events.
+        Must be called from the thread the model lives in, the snapshot
+        can then be used from any thread. */
+    CharmDataModelSnapshot snapshot() const;
+    /** Incremented whenever tasks or events change.
+        May be called from any thread. */
+    quint64 generation() const;
+    /** Incremented whenever tasks change, lets views cache task derived data. */
+    quint64 taskGeneration() const;
+
     bool operator==( const CharmDataModel& other ) const;
 
 Q_SIGNALS:
@@ -155,7 +200,24 @@ public Q_SLOTS:
 
 private:
     void determineTaskPaddingLength();
+    /** Turn the current tasks into the given ones with individual
+        add, modify and delete operations.
+        Returns false if the model needs to be rebuilt instead. */
+    bool applyTaskChanges( const TaskList& tasks );
+    /** Same as applyTaskChanges() for the events, in one batch. */
+    bool applyEventChanges( const EventList& events );
+    QString buildFullTaskName( const Task& ) const;
+    void invalidateFullTaskNames( const TaskTreeItem& item );
     bool eventExists( EventId id );
+    void tasksChanged();
+    void scheduleValidityTimer();
+    void eventsChanged();
+    /** Update the rollup and the time index, and mark the days of the
+        event as changed for the next snapshot. */
+    void indexAddedEvent( const Event& event );
+    void indexModifiedEvent( const Event& event );
+    void indexDeletedEvent( EventId id );
+    void eventDayChanged( const QDate& day );
 
     Task& findTask( TaskId id );
     Event& findEvent( EventId id );
@@ -172,16 +234,62 @@ private:
     EventIdList m_activeEventIds;
     // adapters are notified when the model changes
     CharmDataModelAdapterList m_adapters;
+    // event changes collected while a batch is open:
+    int m_eventBatchLevel = 0;
+    QSet<EventId> m_batchAddedEvents;
+    QSet<EventId> m_batchModifiedEvents;
+    QSet<EventId> m_batchDeletedEvents;
 
     // event update timer:
     QTimer m_timer;
     SmartNameCache m_nameCache;
+    DurationRollup m_rollup;
+    EventTimeIndex m_timeIndex;
+    TaskValiditySchedule m_validity;
+    // fires at the next validity boundary:
+    QTimer m_validityTimer;
+    // full task names by task id, filled on demand:
+    mutable QHash<TaskId, QString> m_fullTaskNames;
+    // the search index is brought up to date on the next search:
+    mutable TaskSearchIndex m_searchIndex;
+    mutable QSet<TaskId> m_searchIndexOutdated;
+    mutable int m_searchIndexPadding = -1;
+    // snapshot parts, shared until the tasks or the events of a day change:
+    QAtomicInteger<quint64> m_generation;
+    quint64 m_taskGeneration = 0;
+    mutable QSharedPointer<const CharmDataModelSnapshot::Tasks> m_snapshotTasks;
+    mutable CharmDataModelSnapshot::EventDays m_snapshotEventDays;
+    mutable bool m_snapshotEventsOutdated = true;
+    mutable QSet<QDate> m_changedEventDays;
 
 private Q_SLOTS:
     void eventUpdateTimerEvent();
+    void validityTimerEvent();
 
 private:
     // functions only used for testing:
     CharmDataModel* clone() const;
 };
+
+/** EventBatch collects the event changes of the model for its lifetime.
+    The adapters are notified once when it goes out of scope. */
+class EventBatch
+{
+public:
+    explicit EventBatch( CharmDataModel* model )
+        : m_model( model )
+    {
+        m_model->beginEventBatch();
+    }
+
+    ~EventBatch()
+    {
+        m_model->commitEventBatch();
+    }
+
+private:
+    Q_DISABLE_COPY( EventBatch )
+    CharmDataModel* m_model;
+};
+
 #endif
@@ -38,6 +38,8 @@ public:
     virtual void taskAboutToBeAdded( TaskId parent, int pos ) = 0;
     virtual void taskAdded( TaskId id ) = 0;
     virtual void taskModified( TaskId id ) = 0;
+    // the task is moved to the end of the children of newParent:
+    virtual void taskParentAboutToChange( TaskId task, TaskId oldParent, TaskId newParent ) = 0;
     virtual void taskParentChanged( TaskId task, TaskId oldParent, TaskId newParent ) = 0;
     virtual void taskAboutToBeDeleted( TaskId ) = 0;
     virtual void taskDeleted( TaskId id ) = 0;
@@ -49,6 +51,11 @@ public:
     virtual void eventModified( EventId id, Event discardedEvent ) = 0;
     virtual void eventAboutToBeDeleted( EventId id ) = 0;
     virtual void eventDeleted( EventId id ) = 0;
+    // batched changes, see CharmDataModel::beginEventBatch(). When these
+    // are called, the model already reflects the changes:
+    virtual void eventsAdded( const EventIdList& ids ) = 0;
+    virtual void eventsModified( const EventIdList& ids ) = 0;
+    virtual void eventsDeleted( const EventIdList& ids ) = 0;
 
     virtual void eventActivated( EventId id ) = 0;
     virtual void eventDeactivated( EventId id ) = 0;
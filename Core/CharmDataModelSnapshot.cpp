@@ -0,0 +1,101 @@
+/*
+  CharmDataModelSnapshot.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "CharmDataModelSnapshot.h"
+
+#include <algorithm>
+
+CharmDataModelSnapshot::CharmDataModelSnapshot()
+    : m_tasks( new Tasks )
+{
+}
+
+quint64 CharmDataModelSnapshot::generation() const
+{
+    return m_generation;
+}
+
+const Task& CharmDataModelSnapshot::getTask( TaskId id ) const
+{
+    static const Task InvalidTask;
+    const auto it = m_tasks->byId.constFind( id );
+    return it == m_tasks->byId.constEnd() ? InvalidTask : it.value();
+}
+
+const TaskList& CharmDataModelSnapshot::getAllTasks() const
+{
+    return m_tasks->list;
+}
+
+QString CharmDataModelSnapshot::fullTaskName( TaskId id ) const
+{
+    const Task& task = getTask( id );
+    QString name = task.name().simplified();
+    for ( TaskId parent = task.parent(); parent > 0; ) {
+        const Task& parentTask = getTask( parent );
+        if ( !parentTask.isValid() )
+            break;
+        name = parentTask.name().simplified() + QLatin1Char('/') + name;
+        parent = parentTask.parent();
+    }
+    return name;
+}
+
+bool CharmDataModelSnapshot::isParentOf( TaskId parent, TaskId task ) const
+{
+    if ( task == parent ) return false; // a task is not it's own child
+    for ( TaskId id = getTask( task ).parent(); id > 0; id = getTask( id ).parent() ) {
+        if ( id == parent )
+            return true;
+    }
+    return false;
+}
+
+TaskIdList CharmDataModelSnapshot::childIds( TaskId id ) const
+{
+    return m_tasks->children.value( id );
+}
+
+const Event& CharmDataModelSnapshot::eventForId( EventId id ) const
+{
+    static const Event InvalidEvent;
+    const auto day = m_eventDays.constFind( m_timeIndex.dayOf( id ) );
+    if ( day == m_eventDays.constEnd() )
+        return InvalidEvent;
+    const auto it = day.value()->find( id );
+    return it == day.value()->end() ? InvalidEvent : it->second;
+}
+
+EventIdList CharmDataModelSnapshot::eventsThatStartInTimeFrame( const QDate& start,
+                                                                const QDate& end ) const
+{
+    if ( !end.isValid() )
+        return EventIdList();
+    EventIdList events = m_timeIndex.eventsStartingBetween( start, end );
+    std::sort( events.begin(), events.end() );
+    return events;
+}
+
+EventIdList CharmDataModelSnapshot::activeEvents() const
+{
+    return m_activeEventIds;
+}
@@ -0,0 +1,90 @@
+/*
+  CharmDataModelSnapshot.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef CHARMDATAMODELSNAPSHOT_H
+#define CHARMDATAMODELSNAPSHOT_H
+
+#include <QDate>
+#include <QHash>
+#include <QMap>
+#include <QSharedPointer>
+
+#include "Task.h"
+#include "Event.h"
+#include "EventTimeIndex.h"
+
+/** CharmDataModelSnapshot is an immutable copy of the tasks and events
+    of a CharmDataModel at one point in time.
+    Snapshots are created with CharmDataModel::snapshot() on the GUI
+    thread, and can then be copied to and read from any thread without
+    locking. The task data and the events of every day are shared
+    between snapshots, and only copied again when the tasks or the
+    events of that day changed.
+    Compare generation() with CharmDataModel::generation() to find out
+    whether a snapshot is outdated.
+*/
+class CharmDataModelSnapshot
+{
+public:
+    /** An empty snapshot of generation 0. */
+    CharmDataModelSnapshot();
+
+    quint64 generation() const;
+
+    /** Retrieve a task for the given task id, or an invalid task. */
+    const Task& getTask( TaskId id ) const;
+    /** All tasks, parents before their children. */
+    const TaskList& getAllTasks() const;
+    /** The task names of the path to the task, separated by slashes. */
+    QString fullTaskName( TaskId id ) const;
+    /** True if task is in the subtree below parent. */
+    bool isParentOf( TaskId parent, TaskId task ) const;
+    /** The ids of the direct children of the task, the top level
+        tasks for task id 0. */
+    TaskIdList childIds( TaskId id ) const;
+
+    /** Retrieve an event for the given event id, or an invalid event. */
+    const Event& eventForId( EventId id ) const;
+    /** Same as CharmDataModel::eventsThatStartInTimeFrame(), only
+        visits the days in the time frame. */
+    EventIdList eventsThatStartInTimeFrame( const QDate& start, const QDate& end ) const;
+    EventIdList activeEvents() const;
+
+private:
+    friend class CharmDataModel;
+
+    struct Tasks {
+        TaskList list;
+        QHash<TaskId, Task> byId;
+        QHash<TaskId, TaskIdList> children;
+    };
+    /** The events by the local day they start on. */
+    typedef QMap<QDate, QSharedPointer<const EventMap> > EventDays;
+
+    quint64 m_generation = 0;
+    QSharedPointer<const Tasks> m_tasks;
+    EventDays m_eventDays;
+    EventTimeIndex m_timeIndex;
+    EventIdList m_activeEventIds;
+};
+
+#endif
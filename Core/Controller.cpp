@@ -171,11 +171,14 @@ void Controller::stateChanged( State previous, State next )
     {   // yes, it is that simple:
         TaskList tasks = m_storage->getAllTasks();
         // tell the view about the existing tasks;
-        if ( ! Task::checkForUniqueTaskIds( tasks ) ) {
+        const TaskListProblems problems = Task::checkTaskList( tasks );
+        if ( ! problems.isEmpty() )
+            qWarning() << "Controller::stateChanged: invalid task list:" << problems.toString();
+        if ( ! problems.duplicateIds.isEmpty() ) {
             throw CharmException( tr( "The Charm database is corrupted, it contains duplicate task ids. "
                                       "Please have it looked after by a professional." ) );
         }
-        if ( ! Task::checkForTreeness( tasks ) ) {
+        if ( ! problems.isEmpty() ) {
             throw CharmException( tr( "The Charm database is corrupted, the tasks do not form a tree. "
                                       "Please have it looked after by a professional." ) );
         }
@@ -433,12 +436,7 @@ QString Controller::importDatabaseFromXml( const QDomDocument& document )
                 .arg( error );
     }
 
-    // FIXME needed?
-
-    // tell the model that the tasks and events have vanished:
-    emit allEvents( EventList() );
-    emit definedTasks( TaskList() );
-
+    // the model is updated on return, and only applies the differences
     return QString();
 }
 
@@ -0,0 +1,238 @@
+/*
+  DurationRollup.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "DurationRollup.h"
+
+#include <algorithm>
+
+void DurationRollup::setAllTasks( const TaskList& tasks )
+{
+    m_parents.clear();
+    m_parents.reserve( tasks.size() );
+    Q_FOREACH( const Task& task, tasks )
+        m_parents.insert( task.id(), task.parent() );
+    rebuild();
+}
+
+void DurationRollup::addTask( const Task& task )
+{
+    m_parents.insert( task.id(), task.parent() );
+    // events may have been recorded before the task was known:
+    if ( m_cells.contains( task.id() ) )
+        moveSubtree( task.id(), 0, task.parent() );
+}
+
+void DurationRollup::modifyTask( const Task& task )
+{
+    const TaskId oldParent = m_parents.value( task.id() );
+    if ( oldParent == task.parent() )
+        return;
+    moveSubtree( task.id(), oldParent, task.parent() );
+    m_parents.insert( task.id(), task.parent() );
+}
+
+void DurationRollup::deleteTask( const Task& task )
+{
+    // the events of the task remain, but do not count for its parents anymore:
+    if ( m_cells.contains( task.id() ) )
+        moveSubtree( task.id(), m_parents.value( task.id() ), 0 );
+    m_parents.remove( task.id() );
+}
+
+void DurationRollup::clearTasks()
+{
+    m_parents.clear();
+    rebuild();
+}
+
+void DurationRollup::setAllEvents( const EventMap& events )
+{
+    m_contributions.clear();
+    m_contributions.reserve( int( events.size() ) );
+    for ( auto it = events.begin(); it != events.end(); ++it )
+        m_contributions.insert( it->first, contributionFor( it->second ) );
+    rebuild();
+}
+
+void DurationRollup::addEvent( const Event& event )
+{
+    const Contribution contribution = contributionFor( event );
+    m_contributions.insert( event.id(), contribution );
+    apply( contribution, 1 );
+}
+
+void DurationRollup::modifyEvent( const Event& event )
+{
+    const auto it = m_contributions.find( event.id() );
+    if ( it == m_contributions.end() ) {
+        addEvent( event );
+        return;
+    }
+    apply( it.value(), -1 );
+    it.value() = contributionFor( event );
+    apply( it.value(), 1 );
+}
+
+void DurationRollup::deleteEvent( EventId id )
+{
+    const auto it = m_contributions.find( id );
+    if ( it == m_contributions.end() )
+        return;
+    apply( it.value(), -1 );
+    m_contributions.erase( it );
+}
+
+void DurationRollup::clearEvents()
+{
+    m_contributions.clear();
+    m_cells.clear();
+    m_tasksByDay.clear();
+}
+
+int DurationRollup::seconds( TaskId task, const QDate& day ) const
+{
+    const auto cells = m_cells.constFind( task );
+    if ( cells == m_cells.constEnd() )
+        return 0;
+    const auto cell = cells->constFind( day );
+    return cell == cells->constEnd() ? 0 : cell->seconds;
+}
+
+int DurationRollup::seconds( TaskId task, const QDate& start, const QDate& end ) const
+{
+    const auto cells = m_cells.constFind( task );
+    if ( cells == m_cells.constEnd() )
+        return 0;
+    int seconds = 0;
+    for ( auto it = cells->lowerBound( start ); it != cells->constEnd() && it.key() < end; ++it )
+        seconds += it->seconds;
+    return seconds;
+}
+
+int DurationRollup::subtreeSeconds( TaskId task, const QDate& day ) const
+{
+    const auto cells = m_cells.constFind( task );
+    if ( cells == m_cells.constEnd() )
+        return 0;
+    const auto cell = cells->constFind( day );
+    return cell == cells->constEnd() ? 0 : cell->subtreeSeconds;
+}
+
+int DurationRollup::subtreeSeconds( TaskId task, const QDate& start, const QDate& end ) const
+{
+    const auto cells = m_cells.constFind( task );
+    if ( cells == m_cells.constEnd() )
+        return 0;
+    int seconds = 0;
+    for ( auto it = cells->lowerBound( start ); it != cells->constEnd() && it.key() < end; ++it )
+        seconds += it->subtreeSeconds;
+    return seconds;
+}
+
+bool DurationRollup::hasEvents( TaskId task, const QDate& start, const QDate& end ) const
+{
+    const auto cells = m_cells.constFind( task );
+    if ( cells == m_cells.constEnd() )
+        return false;
+    for ( auto it = cells->lowerBound( start ); it != cells->constEnd() && it.key() < end; ++it ) {
+        if ( it->events > 0 )
+            return true;
+    }
+    return false;
+}
+
+TaskIdList DurationRollup::tasksWithEvents( const QDate& start, const QDate& end ) const
+{
+    QSet<TaskId> tasks;
+    for ( auto it = m_tasksByDay.lowerBound( start ); it != m_tasksByDay.constEnd() && it.key() < end; ++it )
+        tasks.unite( it.value() );
+    TaskIdList result;
+    result.reserve( tasks.size() );
+    Q_FOREACH( TaskId id, tasks )
+        result.append( id );
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+void DurationRollup::apply( const Contribution& contribution, int sign )
+{
+    Cell& cell = m_cells[contribution.task][contribution.day];
+    cell.seconds += sign * contribution.seconds;
+    cell.events += sign;
+    if ( sign > 0 && cell.events == 1 ) {
+        m_tasksByDay[contribution.day].insert( contribution.task );
+    } else if ( sign < 0 && cell.events == 0 ) {
+        const auto it = m_tasksByDay.find( contribution.day );
+        it->remove( contribution.task );
+        if ( it->isEmpty() )
+            m_tasksByDay.erase( it );
+    }
+    applyToPath( contribution.task, contribution.day, sign * contribution.seconds, sign );
+}
+
+void DurationRollup::applyToPath( TaskId task, const QDate& day, int seconds, int events )
+{
+    // the task, its ancestors and the root:
+    TaskId id = task;
+    Q_FOREVER {
+        Cells& cells = m_cells[id];
+        Cell& cell = cells[day];
+        cell.subtreeSeconds += seconds;
+        cell.subtreeEvents += events;
+        if ( cell.subtreeEvents == 0 ) {
+            cells.remove( day );
+            if ( cells.isEmpty() )
+                m_cells.remove( id );
+        }
+        if ( id == 0 )
+            break;
+        id = m_parents.value( id );
+    }
+}
+
+void DurationRollup::moveSubtree( TaskId task, TaskId oldParent, TaskId newParent )
+{
+    if ( oldParent == newParent )
+        return;
+    const Cells cells = m_cells.value( task );
+    for ( auto it = cells.constBegin(); it != cells.constEnd(); ++it ) {
+        applyToPath( oldParent, it.key(), -it->subtreeSeconds, -it->subtreeEvents );
+        applyToPath( newParent, it.key(), it->subtreeSeconds, it->subtreeEvents );
+    }
+}
+
+void DurationRollup::rebuild()
+{
+    m_cells.clear();
+    m_tasksByDay.clear();
+    for ( auto it = m_contributions.constBegin(); it != m_contributions.constEnd(); ++it )
+        apply( it.value(), 1 );
+}
+
+DurationRollup::Contribution DurationRollup::contributionFor( const Event& event )
+{
+    Contribution contribution;
+    contribution.task = event.taskId();
+    contribution.day = event.startDateTime().date();
+    contribution.seconds = event.duration();
+    return contribution;
+}
@@ -0,0 +1,116 @@
+/*
+  DurationRollup.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef DURATIONROLLUP_H
+#define DURATIONROLLUP_H
+
+#include <QDate>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+
+#include "Task.h"
+#include "Event.h"
+
+/** DurationRollup keeps the seconds recorded per task and local day.
+    Every event counts for the day it starts on, the same way the
+    reports assign events to days. Next to the seconds of the task's own
+    events, every cell holds the seconds of the task's subtree, so totals
+    including subtasks do not need to walk the tree. Task 0 is the
+    imaginary root and holds the totals of all tasks.
+    The rollup is updated incrementally by CharmDataModel: a changed event
+    touches the cells of its task and the task's ancestors only. Queries
+    for a day are a lookup, queries for a range visit the days in the
+    range.
+*/
+class DurationRollup {
+public:
+    void setAllTasks( const TaskList& tasks );
+    void addTask( const Task& task );
+    void modifyTask( const Task& task );
+    void deleteTask( const Task& task );
+    void clearTasks();
+
+    void setAllEvents( const EventMap& events );
+    void addEvent( const Event& event );
+    void modifyEvent( const Event& event );
+    void deleteEvent( EventId id );
+    void clearEvents();
+
+    /** Seconds of the events of the task that start on day. */
+    int seconds( TaskId task, const QDate& day ) const;
+    /** Seconds of the events of the task that start at or after start,
+        and before end. */
+    int seconds( TaskId task, const QDate& start, const QDate& end ) const;
+    /** Same as seconds(), including the events of all subtasks. */
+    int subtreeSeconds( TaskId task, const QDate& day ) const;
+    int subtreeSeconds( TaskId task, const QDate& start, const QDate& end ) const;
+    /** True if the task has own events starting in the range. */
+    bool hasEvents( TaskId task, const QDate& start, const QDate& end ) const;
+    /** The tasks that have events starting in the range, sorted by id. */
+    TaskIdList tasksWithEvents( const QDate& start, const QDate& end ) const;
+    /** Calls function( day, seconds ) for the days in the range on which
+        the task has own events, in the order of the days. */
+    template<typename Function>
+    void forEachDay( TaskId task, const QDate& start, const QDate& end, Function function ) const;
+
+private:
+    struct Cell {
+        int seconds = 0;
+        int events = 0;
+        int subtreeSeconds = 0;
+        int subtreeEvents = 0;
+    };
+    typedef QMap<QDate, Cell> Cells;
+
+    struct Contribution {
+        TaskId task = {};
+        QDate day;
+        int seconds = 0;
+    };
+
+    void apply( const Contribution& contribution, int sign );
+    void applyToPath( TaskId task, const QDate& day, int seconds, int events );
+    void moveSubtree( TaskId task, TaskId oldParent, TaskId newParent );
+    void rebuild();
+    static Contribution contributionFor( const Event& event );
+
+    QHash<TaskId, Cells> m_cells;
+    // tasks with own events, by day:
+    QMap<QDate, QSet<TaskId> > m_tasksByDay;
+    QHash<EventId, Contribution> m_contributions;
+    QHash<TaskId, TaskId> m_parents;
+};
+
+template<typename Function>
+void DurationRollup::forEachDay( TaskId task, const QDate& start, const QDate& end, Function function ) const
+{
+    const auto cells = m_cells.constFind( task );
+    if ( cells == m_cells.constEnd() )
+        return;
+    for ( auto it = cells->lowerBound( start ); it != cells->constEnd() && it.key() < end; ++it ) {
+        if ( it->events > 0 )
+            function( it.key(), it->seconds );
+    }
+}
+
+#endif
@@ -26,6 +26,7 @@
 
 #include <QDomElement>
 #include <QDomText>
+#include <QXmlStreamWriter>
 
 Event::Event()
 {
@@ -190,6 +191,23 @@ QDomElement Event::toXml( QDomDocument document ) const
     return element;
 }
 
+void Event::toXml( QXmlStreamWriter& writer ) const
+{
+    writer.writeStartElement( EventElement );
+    writer.writeAttribute( EventIdAttribute, QString::number( id() ) );
+    writer.writeAttribute( EventInstallationIdAttribute, QString::number( installationId() ) );
+    writer.writeAttribute( EventTaskIdAttribute, QString::number( taskId() ) );
+    writer.writeAttribute( EventUserIdAttribute, QString::number( userId() ) );
+    writer.writeAttribute( EventReportIdAttribute, QString::number( reportId() ) );
+    if ( m_start.isValid() )
+        writer.writeAttribute( EventStartAttribute, m_start.toString( Qt::ISODate ) );
+    if ( m_end.isValid() )
+        writer.writeAttribute( EventEndAttribute, m_end.toString( Qt::ISODate ) );
+    if ( !comment().isEmpty() )
+        writer.writeCharacters( comment() );
+    writer.writeEndElement();
+}
+
 QString Event::tagName()
 {
     static const QString tag( QStringLiteral( "event" ) );
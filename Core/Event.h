@@ -34,6 +34,8 @@
 
 #include "Task.h"
 
+class QXmlStreamWriter;
+
 typedef int EventId;
 
 /** An event is a recorded time for a task.
@@ -88,6 +90,8 @@ public:
     void dump() const;
 
     QDomElement toXml( QDomDocument ) const;
+    /** Writes the same element as toXml( QDomDocument ). */
+    void toXml( QXmlStreamWriter& writer ) const;
 
     static Event fromXml( const QDomElement&,  int databaseSchemaVersion = 1 );
     static QString tagName();
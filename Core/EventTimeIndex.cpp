@@ -0,0 +1,113 @@
+/*
+  EventTimeIndex.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "EventTimeIndex.h"
+
+void EventTimeIndex::setAllEvents( const EventMap& events )
+{
+    clearEvents();
+    m_days.reserve( int( events.size() ) );
+    for ( EventMap::const_iterator it = events.begin(); it != events.end(); ++it )
+        addEvent( it->second );
+}
+
+void EventTimeIndex::addEvent( const Event& event )
+{
+    const QDate day = event.startDateTime().date();
+    m_days.insert( event.id(), day );
+    m_eventsByDay[day].insert( event.id() );
+    m_longestSpan = qMax( m_longestSpan, spanInDays( event ) );
+}
+
+void EventTimeIndex::modifyEvent( const Event& event )
+{
+    const QDate day = event.startDateTime().date();
+    // only look up, so that shared copies stay shared:
+    const auto it = m_days.constFind( event.id() );
+    if ( it == m_days.constEnd() ) {
+        addEvent( event );
+        return;
+    }
+    if ( it.value() != day ) {
+        deleteEvent( event.id() );
+        addEvent( event );
+        return;
+    }
+    m_longestSpan = qMax( m_longestSpan, spanInDays( event ) );
+}
+
+void EventTimeIndex::deleteEvent( EventId id )
+{
+    const auto it = m_days.find( id );
+    if ( it == m_days.end() )
+        return;
+    const auto day = m_eventsByDay.find( it.value() );
+    Q_ASSERT( day != m_eventsByDay.end() );
+    day->remove( id );
+    if ( day->isEmpty() )
+        m_eventsByDay.erase( day );
+    m_days.erase( it );
+}
+
+void EventTimeIndex::clearEvents()
+{
+    m_eventsByDay.clear();
+    m_days.clear();
+    m_longestSpan = 0;
+}
+
+EventIdList EventTimeIndex::eventsStartingBetween( const QDate& start, const QDate& end ) const
+{
+    EventIdList ids;
+    auto it = start.isValid() ? m_eventsByDay.lowerBound( start ) : m_eventsByDay.begin();
+    for ( ; it != m_eventsByDay.end(); ++it ) {
+        if ( end.isValid() && it.key() >= end )
+            break;
+        Q_FOREACH( EventId id, it.value() )
+            ids.append( id );
+    }
+    return ids;
+}
+
+EventIdList EventTimeIndex::eventsStartingOn( const QDate& day ) const
+{
+    return m_eventsByDay.value( day ).toList();
+}
+
+QDate EventTimeIndex::dayOf( EventId id ) const
+{
+    return m_days.value( id );
+}
+
+int EventTimeIndex::longestSpanInDays() const
+{
+    return m_longestSpan;
+}
+
+int EventTimeIndex::spanInDays( const Event& event )
+{
+    const QDate start = event.startDateTime().date();
+    const QDate end = event.endDateTime().date();
+    if ( !start.isValid() || !end.isValid() )
+        return 0;
+    return qMax( 0, int( start.daysTo( end ) ) );
+}
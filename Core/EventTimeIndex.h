@@ -0,0 +1,66 @@
+/*
+  EventTimeIndex.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef EVENTTIMEINDEX_H
+#define EVENTTIMEINDEX_H
+
+#include <QDate>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+
+#include "Event.h"
+
+/** EventTimeIndex finds the events that start on a range of local days
+    without visiting the whole history. It is updated incrementally by
+    CharmDataModel.
+    It also keeps an upper bound of the number of days any event spans,
+    so that views that show events overlapping a range can look back far
+    enough. The bound only grows until the events are set or cleared.
+*/
+class EventTimeIndex {
+public:
+    void setAllEvents( const EventMap& events );
+    void addEvent( const Event& event );
+    void modifyEvent( const Event& event );
+    void deleteEvent( EventId id );
+    void clearEvents();
+
+    /** The events that start on a day at or after start, and before end.
+        An invalid date leaves that end of the range open. The ids are not
+        sorted. */
+    EventIdList eventsStartingBetween( const QDate& start, const QDate& end ) const;
+    /** The events that start on the given day, not sorted. */
+    EventIdList eventsStartingOn( const QDate& day ) const;
+    /** The day the event starts on, or an invalid date. */
+    QDate dayOf( EventId id ) const;
+    /** An upper bound of the days between start and end date of all events. */
+    int longestSpanInDays() const;
+
+private:
+    static int spanInDays( const Event& event );
+
+    QMap<QDate, QSet<EventId> > m_eventsByDay;
+    QHash<EventId, QDate> m_days;
+    int m_longestSpan = 0;
+};
+
+#endif
@@ -23,70 +23,120 @@
 
 #include "SmartNameCache.h"
 
+#include <QMap>
+#include <QVector>
 
+void SmartNameCache::setAllTasks( const TaskList& taskList )
+{
+    clearTasks();
+    Q_FOREACH( const Task& task, taskList )
+        insertTask( task );
+
+    QSet<QString> groups;
+    for ( auto it = m_tasksByGroup.constBegin(); it != m_tasksByGroup.constEnd(); ++it )
+        groups.insert( it.key() );
+    regenerateSmartNames( groups );
+}
 
-struct IdLessThan
+QString SmartNameCache::groupName( const Task& task )
 {
-    bool operator()( const Task& lhs, const Task& rhs ) const
-    {
-        return lhs.id() < rhs.id();
-    }
-};
+    // all intermediate names generated for a task end with its name, so
+    // two tasks can only collide if the last components of their names match
+    return task.name().section( QLatin1Char('/'), -1 );
+}
 
-void SmartNameCache::setAllTasks( const TaskList& taskList )
+void SmartNameCache::insertTask( const Task& task )
 {
-    m_tasks = taskList;
-    sortTasks();
-    regenerateSmartNames();
+    m_tasks.insert( task.id(), task );
+    m_tasksByGroup[groupName( task )].insert( task.id() );
+    m_childrenByParent.insert( task.parent(), task.id() );
 }
 
-void SmartNameCache::sortTasks()
+void SmartNameCache::removeTask( const Task& task )
 {
-    qSort( m_tasks.begin(), m_tasks.end(), IdLessThan() );
+    m_tasks.remove( task.id() );
+    const QString group = groupName( task );
+    const auto it = m_tasksByGroup.find( group );
+    if ( it != m_tasksByGroup.end() ) {
+        it.value().remove( task.id() );
+        if ( it.value().isEmpty() )
+            m_tasksByGroup.erase( it );
+    }
+    m_childrenByParent.remove( task.parent(), task.id() );
 }
 
-//single add/modify/delete rebuild the cache each time.
-//If necessary, this could be optimized by keeping the tasks in a "inverse" tree
-//with the task names below the root and their parents further down
+void SmartNameCache::collectSubtreeGroups( TaskId id, QSet<QString>& groups ) const
+{
+    // the smart names of all tasks below id may contain its name
+    const QList<TaskId> children = m_childrenByParent.values( id );
+    Q_FOREACH( const TaskId child, children ) {
+        groups.insert( groupName( findTask( child ) ) );
+        collectSubtreeGroups( child, groups );
+    }
+}
 
 void SmartNameCache::modifyTask( const Task& task )
 {
-    const TaskList::Iterator it = qBinaryFind( m_tasks.begin(), m_tasks.end(), Task( task.id(), QString() ), IdLessThan() );
-    if ( it != m_tasks.end() )
-        *it = task;
-    sortTasks();
-    regenerateSmartNames();
+    const auto it = m_tasks.constFind( task.id() );
+    if ( it == m_tasks.constEnd() )
+        return;
+
+    const Task old = it.value();
+    if ( old.name() == task.name() && old.parent() == task.parent() ) {
+        // nothing that the smart names are made of has changed
+        m_tasks.insert( task.id(), task );
+        return;
+    }
+
+    QSet<QString> groups;
+    groups << groupName( old ) << groupName( task );
+    removeTask( old );
+    insertTask( task );
+    collectSubtreeGroups( task.id(), groups );
+    regenerateSmartNames( groups );
 }
 
 void SmartNameCache::deleteTask( const Task& task )
 {
-    const auto it = qBinaryFind( m_tasks.begin(), m_tasks.end(), Task( task.id(), QString() ), IdLessThan() );
-    if ( it != m_tasks.end() ) {
-        m_tasks.erase( it );
-        regenerateSmartNames();
-    }
+    const auto it = m_tasks.constFind( task.id() );
+    if ( it == m_tasks.constEnd() )
+        return;
+
+    const Task old = it.value();
+    QSet<QString> groups;
+    groups << groupName( old );
+    removeTask( old );
+    m_smartTaskNamesById.remove( task.id() );
+    collectSubtreeGroups( task.id(), groups );
+    regenerateSmartNames( groups );
 }
 
 void SmartNameCache::clearTasks()
 {
     m_tasks.clear();
+    m_tasksByGroup.clear();
+    m_childrenByParent.clear();
     m_smartTaskNamesById.clear();
 }
 
 Task SmartNameCache::findTask( TaskId id ) const
 {
-    const auto it = qBinaryFind( m_tasks.begin(), m_tasks.end(), Task( id, QString() ), IdLessThan() );
-    if ( it != m_tasks.constEnd() )
-        return *it;
-    else
-        return Task();
+    return m_tasks.value( id );
 }
 
 void SmartNameCache::addTask( const Task& task )
 {
-    m_tasks.append( task );
-    sortTasks();
-    regenerateSmartNames();
+    if ( m_tasks.contains( task.id() ) ) {
+        modifyTask( task );
+        return;
+    }
+
+    QSet<QString> groups;
+    groups << groupName( task );
+    insertTask( task );
+    // tasks that were added before their parent:
+    collectSubtreeGroups( task.id(), groups );
+    regenerateSmartNames( groups );
 }
 
 QString SmartNameCache::smartName( const TaskId& id ) const
@@ -106,15 +156,26 @@ QString SmartNameCache::makeCombined( const Task& task ) const {
         return task.name();
 }
 
-void SmartNameCache::regenerateSmartNames()
+void SmartNameCache::regenerateSmartNames( const QSet<QString>& groups )
 {
-    m_smartTaskNamesById.clear();
+    Q_FOREACH( const QString& group, groups )
+        regenerateGroup( group );
+}
+
+void SmartNameCache::regenerateGroup( const QString& group )
+{
+    const auto groupIt = m_tasksByGroup.constFind( group );
+    if ( groupIt == m_tasksByGroup.constEnd() )
+        return;
+
     typedef QPair<TaskId, TaskId> TaskParentPair;
 
     QMap<QString, QVector<TaskParentPair> > byName;
 
-    Q_FOREACH( const Task& task, m_tasks )
+    Q_FOREACH( const TaskId id, groupIt.value() ) {
+        const Task task = findTask( id );
         byName[makeCombined(task)].append( qMakePair( task.id(), task.parent() ) );
+    }
 
     QSet<QString> cannotMakeUnique;
 
@@ -24,8 +24,20 @@
 #ifndef SMARTNAMECACHE_H
 #define SMARTNAMECACHE_H
 
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
+
 #include "Task.h"
 
+/** SmartNameCache provides the shortest "parent/name" path that makes a
+    task name unique.
+    Only tasks whose names end in the same component can ever end up with
+    the same smart name, so the tasks are grouped by the last component of
+    their names (the "inverse" tree, with the task names below the root
+    and their parents further down). A change to a task only regenerates
+    the groups of the task itself and of the tasks below it.
+*/
 class SmartNameCache {
 public:
     void setAllTasks( const TaskList& taskList );
@@ -36,14 +48,20 @@ public:
     void clearTasks();
 
 private:
-    void regenerateSmartNames();
-    void sortTasks();
+    void insertTask( const Task& task );
+    void removeTask( const Task& task );
+    void collectSubtreeGroups( TaskId id, QSet<QString>& groups ) const;
+    void regenerateSmartNames( const QSet<QString>& groups );
+    void regenerateGroup( const QString& group );
     Task findTask( TaskId id ) const;
     QString makeCombined( const Task& task ) const;
+    static QString groupName( const Task& task );
 
 private:
-    QMap<TaskId, QString> m_smartTaskNamesById;
-    TaskList m_tasks;
+    QHash<TaskId, QString> m_smartTaskNamesById;
+    QHash<TaskId, Task> m_tasks;
+    QHash<QString, QSet<TaskId> > m_tasksByGroup;
+    QMultiHash<TaskId, TaskId> m_childrenByParent;
 };
 
 #endif
@@ -27,9 +27,12 @@
 #include "CharmConstants.h"
 #include "CharmExceptions.h"
 
+#include <QHash>
+#include <QSet>
+#include <QStringList>
 #include <QtDebug>
+#include <QXmlStreamWriter>
 
-#include <set>
 #include <algorithm>
 
 Task::Task()
@@ -204,6 +207,22 @@ QDomElement Task::toXml(QDomDocument document) const
     return element;
 }
 
+void Task::toXml( QXmlStreamWriter& writer ) const
+{
+    writer.writeStartElement( tagName() );
+    writer.writeAttribute( TaskIdElement, QString::number( id() ) );
+    writer.writeAttribute( TaskParentId, QString::number( parent() ) );
+    writer.writeAttribute( TaskSubscribed, QString::number( subscribed() ? 1 : 0 ) );
+    writer.writeAttribute( TaskTrackable, QString::number( trackable() ? 1 : 0 ) );
+    if ( validFrom().isValid() )
+        writer.writeAttribute( TaskValidFrom, validFrom().toString( Qt::ISODate ) );
+    if ( validUntil().isValid() )
+        writer.writeAttribute( TaskValidUntil, validUntil().toString( Qt::ISODate ) );
+    if ( !name().isEmpty() )
+        writer.writeCharacters( name() );
+    writer.writeEndElement();
+}
+
 Task Task::fromXml(const QDomElement& element, int databaseSchemaVersion)
 {   // in case any task object creates trouble with
     // serialization/deserialization, add an object of it to
@@ -289,99 +308,119 @@ void Task::setComment( const QString &comment )
     m_comment = comment;
 }
 
+bool TaskListProblems::isEmpty() const
+{
+    return invalidTasks == 0 && duplicateIds.isEmpty() && orphans.isEmpty() && cycles.isEmpty();
+}
+
+QString TaskListProblems::toString() const
+{
+    const auto idsToString = []( const TaskIdList& ids, const QString& separator ) {
+        QStringList strings;
+        Q_FOREACH( TaskId id, ids )
+            strings << QString::number( id );
+        return strings.join( separator );
+    };
+
+    QStringList parts;
+    if ( invalidTasks > 0 )
+        parts << QStringLiteral( "%1 invalid task(s)" ).arg( invalidTasks );
+    if ( ! duplicateIds.isEmpty() )
+        parts << QStringLiteral( "duplicate ids: " ) + idsToString( duplicateIds, QStringLiteral( ", " ) );
+    if ( ! orphans.isEmpty() )
+        parts << QStringLiteral( "orphans: " ) + idsToString( orphans, QStringLiteral( ", " ) );
+    Q_FOREACH( const TaskIdList& cycle, cycles )
+        parts << QStringLiteral( "cycle: " ) + idsToString( cycle, QStringLiteral( " -> " ) );
+    return parts.join( QStringLiteral( "; " ) );
+}
+
 bool Task::checkForUniqueTaskIds( const TaskList& tasks )
 {
-    std::set<TaskId> ids;
+    QSet<TaskId> ids;
+    ids.reserve( tasks.size() );
 
     for ( TaskList::const_iterator it = tasks.begin(); it != tasks.end(); ++it ) {
         ids.insert( ( *it ).id() );
     }
 
-    return static_cast<int>(ids.size()) == tasks.size();
+    return ids.size() == tasks.size();
 }
 
-/** collectTaskIds visits the task and all subtasks recursively, and
- * adds all visited task ids to visitedIds.
- * @returns false if any visited task id is already in visitedIds
- * @param id the parent task to traverse
- * @param visitedIds reference to a TaskId set that contains already
- * visited task ids
- * @param tasks the tasklist to process
+/** checkTaskList visits every task once: each task has exactly one
+ * parent, so following the parents from every task that has not been
+ * visited yet either ends at a toplevel task, at a missing parent, at
+ * a task that was checked before, or runs into the current path, which
+ * then is a cycle.
+ *
+ * @return the problems found, see TaskListProblems
+ * @param tasks the tasklist to verify
  */
-bool collectTaskIds( std::set<TaskId>& visitedIds, TaskId id, const TaskList& tasks )
+TaskListProblems Task::checkTaskList( const TaskList& tasks )
 {
-    bool foundSelf = false;
-    TaskIdList children;
+    TaskListProblems problems;
+    QHash<TaskId, TaskId> parents;
+    parents.reserve( tasks.size() );
 
-    // find children and the task itself (the parameter tasks is not sorted)
     for ( TaskList::const_iterator it = tasks.begin(); it != tasks.end(); ++it ) {
-        if ( ( *it ).parent() == id ) {
-            children << ( *it ).id();
-        }
-        if ( ( *it ).id() == id ) {
-            // just checking that it really exists...
-            if ( std::find( visitedIds.begin(), visitedIds.end(), id ) != visitedIds.end() ) {
-                return false;
-            } else {
-                if ( ( *it ).isValid() ) {
-                    visitedIds.insert( id );
-                    foundSelf = true;
-                } else {
-                    return false;
-                }
-            }
+        if ( ! ( *it ).isValid() ) {
+            ++problems.invalidTasks;
+        } else if ( parents.contains( ( *it ).id() ) ) {
+            problems.duplicateIds << ( *it ).id();
+        } else {
+            parents.insert( ( *it ).id(), ( *it ).parent() );
         }
     }
 
-    if ( !foundSelf ) {
-        return false;
-    }
-
-    Q_FOREACH( const TaskId i, children ) {
-        collectTaskIds( visitedIds, i, tasks );
+    enum State { OnPath = 1, Checked };
+    QHash<TaskId, int> states;
+    states.reserve( parents.size() );
+    TaskIdList path;
+    // walk in list order, so that the cycles are reported the same way every time:
+    for ( TaskList::const_iterator it = tasks.begin(); it != tasks.end(); ++it ) {
+        TaskId id = ( *it ).id();
+        path.clear();
+        while ( id != 0 && ! states.contains( id ) ) {
+            states.insert( id, OnPath );
+            path << id;
+            const TaskId parent = parents.value( id );
+            if ( parent == 0 )
+                break;
+            if ( ! parents.contains( parent ) ) {
+                problems.orphans << id;
+                break;
+            }
+            if ( states.value( parent ) == OnPath ) {
+                // the path ran into itself, everything from parent on is the cycle:
+                problems.cycles << path.mid( path.indexOf( parent ) );
+                break;
+            }
+            id = parent;
+        }
+        Q_FOREACH( TaskId visited, path )
+            states.insert( visited, Checked );
     }
 
-    return true;
+    std::sort( problems.duplicateIds.begin(), problems.duplicateIds.end() );
+    problems.duplicateIds.erase( std::unique( problems.duplicateIds.begin(), problems.duplicateIds.end() ),
+                                 problems.duplicateIds.end() );
+    std::sort( problems.orphans.begin(), problems.orphans.end() );
+    return problems;
 }
 
-
 /** checkForTreeness checks a task list against cycles in the
  * parent-child relationship, and for orphans (tasks where the parent
- * task does not exist). If the task list contains invalid tasks,
- * false is returned as well.
+ * task does not exist). If the task list contains invalid tasks or
+ * duplicate task ids, false is returned as well.
  *
  * @return false, if cycles in the task tree or orphans have been found
  * @param tasks the tasklist to verify
  */
 bool Task::checkForTreeness( const TaskList& tasks )
 {
-    std::set<TaskId> ids;
-
-    for ( TaskList::const_iterator it = tasks.begin(); it != tasks.end(); ++it ) {
-        if ( ! ( *it ).isValid() ) {
-            return false;
-        }
-        if ( ( *it ).parent() == 0 ) {
-            if ( ! collectTaskIds( ids, ( *it ).id(), tasks ) ) {
-                return false;
-            }
-        }
-    }
-
-    // the count of ids now must be equal to the count of tasks,
-    // otherwise tasks contains elements that are not in the subtrees
-    // of toplevel elements
-    if ( ids.size() != static_cast<unsigned>( tasks.size() ) ) {
+    const TaskListProblems problems = checkTaskList( tasks );
 #ifndef NDEBUG
-        Q_FOREACH( const Task& task, tasks ) {
-            if ( find( ids.begin(), ids.end(), task.id() ) == ids.end() ) {
-                qDebug() << "Orphan task:";
-                task.dump();
-            }
-        }
+    if ( ! problems.isEmpty() )
+        qDebug() << "Task list is not a tree:" << problems.toString();
 #endif
-        return false;
-    }
-
-    return true;
+    return problems.isEmpty();
 }
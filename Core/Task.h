@@ -34,6 +34,8 @@
 #include <QDomDocument>
 #include <QDateTime>
 
+class QXmlStreamWriter;
+
 typedef int TaskId;
 Q_DECLARE_METATYPE( TaskId )
 
@@ -43,6 +45,22 @@ class Task;
 typedef QList<Task> TaskList;
 typedef QList<TaskId> TaskIdList;
 
+/** The reasons why a task list does not form a tree, see Task::checkTaskList(). */
+struct TaskListProblems {
+    /** The number of tasks with an invalid id. */
+    int invalidTasks = 0;
+    /** Ids that occur more than once, sorted. */
+    TaskIdList duplicateIds;
+    /** Tasks whose parent is not in the list, sorted. */
+    TaskIdList orphans;
+    /** Every cycle, as the task ids in the order of the parent links. */
+    QList<TaskIdList> cycles;
+
+    bool isEmpty() const;
+    /** A description for log files and developer facing error messages. */
+    QString toString() const;
+};
+
 /** A task is a category under which events are filed.
     It has a unique identifier and a name. */
 class Task {
@@ -94,6 +112,8 @@ public:
     static QString taskListTagName();
 
     QDomElement toXml( QDomDocument ) const;
+    /** Writes the same element as toXml( QDomDocument ). */
+    void toXml( QXmlStreamWriter& writer ) const;
 
     static Task fromXml( const QDomElement&, int databaseSchemaVersion = 1 );
 
@@ -105,6 +125,8 @@ public:
 
     static bool checkForTreeness( const TaskList& tasks );
 
+    static TaskListProblems checkTaskList( const TaskList& tasks );
+
     static bool lowerTaskId( const Task& left, const Task& right );
 
 private:
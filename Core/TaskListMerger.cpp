@@ -96,12 +96,15 @@ void TaskListMerger::calculateResults() const
 
     // one last check: if tasks where modified through the new task
     // lists, maybe local-only tasks have become orphans?
-    if ( ! Task::checkForUniqueTaskIds( m_results ) ) {
-        throw InvalidTaskListException( QObject::tr( "the merged task list is invalid, it contains duplicate task ids" ) );
+    const TaskListProblems problems = Task::checkTaskList( m_results );
+    if ( ! problems.duplicateIds.isEmpty() ) {
+        throw InvalidTaskListException( QObject::tr( "the merged task list is invalid, it contains duplicate task ids" )
+                                        + QLatin1String( " (" ) + problems.toString() + QLatin1Char( ')' ) );
     }
 
-    if ( ! Task::checkForTreeness( m_results ) ) {
-        throw InvalidTaskListException( QObject::tr( "the merged tasks database is not a directed graph, this is seriously bad, go fix it" ) );
+    if ( ! problems.isEmpty() ) {
+        throw InvalidTaskListException( QObject::tr( "the merged tasks database is not a directed graph, this is seriously bad, go fix it" )
+                                        + QLatin1String( " (" ) + problems.toString() + QLatin1Char( ')' ) );
     }
 
     m_resultsValid = true;
@@ -109,12 +112,15 @@ void TaskListMerger::calculateResults() const
 
 void TaskListMerger::verifyTaskList( const TaskList& tasks )
 {
-    if ( ! Task::checkForUniqueTaskIds( tasks ) ) {
-        throw InvalidTaskListException( QObject::tr( "task list contains duplicate task ids" ) );
+    const TaskListProblems problems = Task::checkTaskList( tasks );
+    if ( ! problems.duplicateIds.isEmpty() ) {
+        throw InvalidTaskListException( QObject::tr( "task list contains duplicate task ids" )
+                                        + QLatin1String( " (" ) + problems.toString() + QLatin1Char( ')' ) );
     }
 
-    if ( ! Task::checkForTreeness( tasks ) ) {
-        throw InvalidTaskListException( QObject::tr( "task list is not a directed graph, this is seriously bad, go fix it" ) );
+    if ( ! problems.isEmpty() ) {
+        throw InvalidTaskListException( QObject::tr( "task list is not a directed graph, this is seriously bad, go fix it" )
+                                        + QLatin1String( " (" ) + problems.toString() + QLatin1Char( ')' ) );
     }
 }
 
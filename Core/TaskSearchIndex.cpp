@@ -0,0 +1,209 @@
+/*
+  TaskSearchIndex.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "TaskSearchIndex.h"
+
+#include <QRegExp>
+#include <QRegularExpression>
+
+#include <algorithm>
+
+void TaskSearchIndex::setText( TaskId id, const QString& text )
+{
+    const QString lowerText = text.toLower();
+    const auto it = m_texts.constFind( id );
+    if ( it != m_texts.constEnd() && it.value() == lowerText )
+        return;
+    removeTask( id );
+    m_texts.insert( id, lowerText );
+    Q_FOREACH( quint64 trigram, trigramsOf( lowerText ) )
+        m_tasksByTrigram[trigram].insert( id );
+    m_lastResultValid = false;
+}
+
+void TaskSearchIndex::removeTask( TaskId id )
+{
+    const auto it = m_texts.find( id );
+    if ( it == m_texts.end() )
+        return;
+    Q_FOREACH( quint64 trigram, trigramsOf( it.value() ) ) {
+        const auto tasks = m_tasksByTrigram.find( trigram );
+        Q_ASSERT( tasks != m_tasksByTrigram.end() );
+        tasks->remove( id );
+        if ( tasks->isEmpty() )
+            m_tasksByTrigram.erase( tasks );
+    }
+    m_texts.erase( it );
+    m_lastResultValid = false;
+}
+
+void TaskSearchIndex::clear()
+{
+    m_texts.clear();
+    m_tasksByTrigram.clear();
+    m_lastResultValid = false;
+}
+
+bool TaskSearchIndex::contains( TaskId id ) const
+{
+    return m_texts.contains( id );
+}
+
+TaskIdList TaskSearchIndex::find( const QString& query ) const
+{
+    const QStringList terms = termsOf( query );
+    // the parts of the words outside of wildcards, the words themselves
+    // if there are none:
+    QStringList literals;
+    QString pattern;
+    Q_FOREACH( const QString& term, terms ) {
+        if ( !pattern.isEmpty() )
+            pattern += QLatin1String( ".*" );
+        pattern += wildcardPattern( term, &literals );
+    }
+    const bool wildcards = literals != terms;
+
+    TaskIdList result;
+    if ( wildcards ) {
+        // the candidates contain the literal parts, the expression checks the rest:
+        const QRegularExpression expression( pattern, QRegularExpression::DotMatchesEverythingOption );
+        Q_FOREACH( TaskId id, candidatesFor( literals ) ) {
+            if ( expression.match( m_texts.value( id ) ).hasMatch() )
+                result.append( id );
+        }
+    } else {
+        const TaskIdList candidates = m_lastResultValid && refines( terms, m_lastTerms )
+            ? m_lastResult : candidatesFor( terms );
+        Q_FOREACH( TaskId id, candidates ) {
+            if ( matches( m_texts.value( id ), terms ) )
+                result.append( id );
+        }
+    }
+    std::sort( result.begin(), result.end() );
+
+    // a query with wildcards is not refined by the next one:
+    m_lastTerms = terms;
+    m_lastResult = result;
+    m_lastResultValid = !wildcards;
+    return result;
+}
+
+QStringList TaskSearchIndex::termsOf( const QString& query )
+{
+    // the filters used to treat the words as wildcard patterns:
+    static const QRegExp Separators( QStringLiteral( "[\\s\\*]+" ) );
+    return query.toLower().split( Separators, QString::SkipEmptyParts );
+}
+
+bool TaskSearchIndex::matches( const QString& text, const QStringList& terms )
+{
+    int position = 0;
+    Q_FOREACH( const QString& term, terms ) {
+        position = text.indexOf( term, position );
+        if ( position < 0 )
+            return false;
+        position += term.length();
+    }
+    return true;
+}
+
+bool TaskSearchIndex::refines( const QStringList& terms, const QStringList& previous )
+{
+    // every match of terms is a match of previous if each previous term
+    // is part of the term at the same position:
+    if ( terms.size() < previous.size() )
+        return false;
+    for ( int i = 0; i < previous.size(); ++i ) {
+        if ( ! terms[i].contains( previous[i] ) )
+            return false;
+    }
+    return true;
+}
+
+QString TaskSearchIndex::wildcardPattern( const QString& term, QStringList* literals )
+{
+    QString pattern;
+    QString literal;
+    const auto endLiteral = [&]() {
+        if ( literal.isEmpty() )
+            return;
+        literals->append( literal );
+        pattern += QRegularExpression::escape( literal );
+        literal.clear();
+    };
+    for ( int i = 0; i < term.length(); ++i ) {
+        if ( term[i] == QLatin1Char( '?' ) ) {
+            endLiteral();
+            pattern += QLatin1Char( '.' );
+            continue;
+        }
+        if ( term[i] == QLatin1Char( '[' ) ) {
+            // a leading ^ negates the set, a leading ] is part of it:
+            int start = i + 1;
+            if ( start < term.length() && term[start] == QLatin1Char( '^' ) )
+                ++start;
+            const int end = term.indexOf( QLatin1Char( ']' ), start + 1 );
+            if ( end > 0 ) {
+                endLiteral();
+                QString set = term.mid( i + 1, end - i - 1 );
+                set.replace( QLatin1Char( '\\' ), QLatin1String( "\\\\" ) );
+                pattern += QLatin1Char( '[' ) + set + QLatin1Char( ']' );
+                i = end;
+                continue;
+            }
+        }
+        // an unmatched [ is a plain character:
+        literal += term[i];
+    }
+    endLiteral();
+    return pattern;
+}
+
+QSet<quint64> TaskSearchIndex::trigramsOf( const QString& text )
+{
+    QSet<quint64> trigrams;
+    for ( int i = 0; i + 3 <= text.length(); ++i ) {
+        trigrams.insert( ( quint64( text[i].unicode() ) << 32 )
+                         | ( quint64( text[i + 1].unicode() ) << 16 )
+                         | quint64( text[i + 2].unicode() ) );
+    }
+    return trigrams;
+}
+
+TaskIdList TaskSearchIndex::candidatesFor( const QStringList& literals ) const
+{
+    // the tasks containing the rarest trigram of the query:
+    const QSet<TaskId>* rarest = nullptr;
+    Q_FOREACH( const QString& literal, literals ) {
+        Q_FOREACH( quint64 trigram, trigramsOf( literal ) ) {
+            const auto it = m_tasksByTrigram.constFind( trigram );
+            if ( it == m_tasksByTrigram.constEnd() )
+                return TaskIdList();
+            if ( rarest == nullptr || it->size() < rarest->size() )
+                rarest = &it.value();
+        }
+    }
+    if ( rarest != nullptr )
+        return rarest->toList();
+    // only short words, check all tasks:
+    return m_texts.keys();
+}
@@ -0,0 +1,69 @@
+/*
+  TaskSearchIndex.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TASKSEARCHINDEX_H
+#define TASKSEARCHINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "Task.h"
+
+/** TaskSearchIndex finds tasks by the words of a search text.
+    Every task has a text (for example its id, full name and comment). A
+    task matches if all words of the query occur in its text, in the
+    given order and ignoring case. Like in the wildcard filters used
+    before, words may contain ? for any character and [...] for a set
+    of characters.
+    Candidates are found through an index of the three character
+    sequences of the texts. Queries that extend the previous query, as
+    they do while the user types, only check the previous result.
+*/
+class TaskSearchIndex {
+public:
+    void setText( TaskId id, const QString& text );
+    void removeTask( TaskId id );
+    void clear();
+    bool contains( TaskId id ) const;
+
+    /** The matching tasks, sorted by id. An empty query matches all tasks. */
+    TaskIdList find( const QString& query ) const;
+
+private:
+    static QStringList termsOf( const QString& query );
+    static bool matches( const QString& text, const QStringList& terms );
+    static bool refines( const QStringList& terms, const QStringList& previous );
+    static QString wildcardPattern( const QString& term, QStringList* literals );
+    static QSet<quint64> trigramsOf( const QString& text );
+    TaskIdList candidatesFor( const QStringList& literals ) const;
+
+    // the texts, in lower case:
+    QHash<TaskId, QString> m_texts;
+    QHash<quint64, QSet<TaskId> > m_tasksByTrigram;
+    // the last query and its result:
+    mutable QStringList m_lastTerms;
+    mutable TaskIdList m_lastResult;
+    mutable bool m_lastResultValid = false;
+};
+
+#endif
@@ -31,55 +31,50 @@ TaskTreeItem::TaskTreeItem()
 }
 
 TaskTreeItem::TaskTreeItem( const Task& task, TaskTreeItem* parent )
-    : m_parent( parent )
-    , m_task( task )
+    : m_task( task )
 {
-    if ( m_parent ) {
-        m_parent->m_children.append( this );
+    if ( parent ) {
+        makeChildOf( *parent );
     }
 }
 
 TaskTreeItem::TaskTreeItem( const TaskTreeItem& other )
+    : m_task( other.m_task )
 {
-    if( this != &other ) {
-        *this = other;
-    }
 }
 
 TaskTreeItem& TaskTreeItem::operator=( const TaskTreeItem& other )
 {
+    // only the task is assigned, the position in the tree stays the same
     if( this != &other ) {
-        m_children = other.m_children;
-        m_parent = other.m_parent;
         m_task = other.m_task;
-        if ( m_parent ) {
-            m_parent->m_children.append( this );
-        }
     }
     return *this;
 }
 
 TaskTreeItem::~TaskTreeItem()
 {
+    Q_FOREACH( TaskTreeItem* child, m_children ) {
+        child->m_parent = nullptr;
+        child->m_row = -1;
+    }
     if ( m_parent ) {
-        m_parent->m_children.removeAt( row() );
+        removeFromParent();
     }
 }
 
 void TaskTreeItem::makeChildOf( TaskTreeItem& parent )
 {
     if ( m_parent != &parent ) {
-        Q_ASSERT( ! parent.m_children.contains( this ) ); // that would be wrong
-
         // if there is an existing parent, unregister with it:
         // parent can only be zero if there never was a parent so far
-        if ( m_parent != 0 ) {
-            m_parent->m_children.removeAt( row() );
-            m_parent = nullptr;
+        if ( m_parent != nullptr ) {
+            removeFromParent();
         }
 
         // register with the new parent
         m_parent = &parent;
+        m_row = parent.m_children.size();
         parent.m_children.append( this );
     } else {
         // hm, should this be allowed?
@@ -87,6 +82,31 @@ void TaskTreeItem::makeChildOf( TaskTreeItem& parent )
     }
 }
 
+void TaskTreeItem::releaseSubtree()
+{
+    Q_FOREACH( TaskTreeItem* child, m_children ) {
+        child->releaseSubtree();
+    }
+    m_children.clear();
+    m_parent = nullptr;
+    m_row = -1;
+}
+
+void TaskTreeItem::removeFromParent()
+{
+    Q_ASSERT( m_parent != nullptr );
+    PointerList& siblings = m_parent->m_children;
+    Q_ASSERT_X( m_row >= 0 && m_row < siblings.size() && siblings.at( m_row ) == this,
+                Q_FUNC_INFO, "Internal error - cannot find myself in my parents family" );
+    siblings.remove( m_row );
+    // the siblings after this item moved up by one:
+    for ( int i = m_row; i < siblings.size(); ++i ) {
+        siblings[i]->m_row = i;
+    }
+    m_parent = nullptr;
+    m_row = -1;
+}
+
 Task& TaskTreeItem::task()
 {
     return m_task;
@@ -99,7 +119,7 @@ const Task& TaskTreeItem::task() const
 
 bool TaskTreeItem::isValid() const
 {
-    return m_parent != 0 && m_task.isValid();
+    return m_parent != nullptr && m_task.isValid();
 }
 
 const TaskTreeItem& TaskTreeItem::child( int row ) const
@@ -117,10 +137,9 @@ const TaskTreeItem& TaskTreeItem::child( int row ) const
 int TaskTreeItem::row() const
 {
     if ( m_parent ) {
-        int row = m_parent->m_children.indexOf( this );
-        Q_ASSERT_X( row != -1, Q_FUNC_INFO,
+        Q_ASSERT_X( m_row != -1, Q_FUNC_INFO,
                     "Internal error - cannot find myself in my parents family" );
-        return row;
+        return m_row;
     } else {
         Q_ASSERT_X( false, Q_FUNC_INFO,
                     "Calling row() on an invalid item" );
@@ -133,22 +152,27 @@ int TaskTreeItem::childCount() const
     return m_children.size();
 }
 
-TaskList TaskTreeItem::children() const
+static void appendSubtree( const TaskTreeItem& item, TaskList& tasks )
 {
-    TaskList tasks;
-    for ( int i = 0; i < m_children.size(); ++i )
+    for ( int i = 0; i < item.childCount(); ++i )
     {
-        tasks << m_children[i]->task()
-              << m_children[i]->children();
+        const TaskTreeItem& child = item.child( i );
+        tasks << child.task();
+        appendSubtree( child, tasks );
     }
+}
 
+TaskList TaskTreeItem::children() const
+{
+    TaskList tasks;
+    appendSubtree( *this, tasks );
     return tasks;
 }
 
 TaskIdList TaskTreeItem::childIds() const
 {
     TaskIdList idList;
-    // get the list of children, and sort by task id:
+    idList.reserve( m_children.size() );
     Q_FOREACH( const TaskTreeItem* item, m_children ) {
         idList.append( item->task().id() );
     }
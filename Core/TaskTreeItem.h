@@ -25,7 +25,7 @@
 #ifndef TASKTREEITEM_H
 #define TASKTREEITEM_H
 
-#include <QList>
+#include <QVector>
 
 #include "Task.h"
 
@@ -39,12 +39,17 @@
     Every TaskTreeItem keeps a list of children.
     Every TaskTreeItem also has a position in it's parents list of
     children. This integer position can be retrieved by calling row on
-    the item.
+    the item. The position is cached in the item and kept up to date
+    when siblings are added or removed, so row() does not need to
+    search the parent's list of children.
+    Copying a TaskTreeItem copies the task only, the copy is not part
+    of the tree. Items that are linked into the tree must not move in
+    memory, which is why the model keeps them in a node based map.
 */
 class TaskTreeItem
 {
 public:
-    typedef QList<const TaskTreeItem*> ConstPointerList;
+    typedef QVector<TaskTreeItem*> PointerList;
     typedef std::map<TaskId, TaskTreeItem> Map;
 
     TaskTreeItem();
@@ -57,6 +62,11 @@ public:
 
     void makeChildOf( TaskTreeItem& parent );
 
+    /** Unlink this item and its whole subtree without updating the
+        parents' lists of children. Only use this if all items of the
+        tree are about to be discarded. */
+    void releaseSubtree();
+
     bool isValid() const;
 
     Task& task();
@@ -76,8 +86,11 @@ public:
     TaskIdList childIds() const;
 
 private:
+    void removeFromParent();
+
     TaskTreeItem* m_parent = nullptr;
-    ConstPointerList m_children;
+    PointerList m_children;
+    int m_row = -1;
     Task m_task;
 };
 
@@ -0,0 +1,132 @@
+/*
+  TaskValiditySchedule.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TaskValiditySchedule.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+    // the validity of the task at the given time, and when it changes next:
+    bool validityAt( const Task& task, qint64 now, qint64* nextChange )
+    {
+        *nextChange = std::numeric_limits<qint64>::max();
+        if ( ! task.isValid() )
+            return false;
+        bool valid = true;
+        if ( task.validFrom().isValid() ) {
+            const qint64 from = task.validFrom().toMSecsSinceEpoch();
+            // validFrom itself is excluded, see Task::isCurrentlyValid():
+            if ( from >= now ) {
+                valid = false;
+                *nextChange = from + 1;
+            }
+        }
+        if ( task.validUntil().isValid() ) {
+            const qint64 until = task.validUntil().toMSecsSinceEpoch();
+            if ( until <= now )
+                valid = false;
+            else
+                *nextChange = qMin( *nextChange, until );
+        }
+        return valid;
+    }
+}
+
+void TaskValiditySchedule::setAllTasks( const TaskList& tasks, qint64 now )
+{
+    clear();
+    m_tasks.reserve( tasks.size() );
+    Q_FOREACH( const Task& task, tasks )
+        setTask( task, now );
+}
+
+void TaskValiditySchedule::setTask( const Task& task, qint64 now )
+{
+    unschedule( task.id() );
+    m_tasks.insert( task.id(), task );
+    qint64 nextChange;
+    if ( validityAt( task, now, &nextChange ) )
+        m_validTasks.insert( task.id() );
+    else
+        m_validTasks.remove( task.id() );
+    schedule( task.id(), nextChange );
+}
+
+void TaskValiditySchedule::removeTask( TaskId id )
+{
+    unschedule( id );
+    m_tasks.remove( id );
+    m_validTasks.remove( id );
+}
+
+void TaskValiditySchedule::clear()
+{
+    m_tasks.clear();
+    m_validTasks.clear();
+    m_queue.clear();
+    m_scheduled.clear();
+}
+
+bool TaskValiditySchedule::isCurrentlyValid( TaskId id ) const
+{
+    return m_validTasks.contains( id );
+}
+
+qint64 TaskValiditySchedule::nextChange() const
+{
+    if ( m_queue.isEmpty() )
+        return std::numeric_limits<qint64>::max();
+    return m_queue.firstKey();
+}
+
+TaskIdList TaskValiditySchedule::advance( qint64 now )
+{
+    TaskIdList changed;
+    while ( ! m_queue.isEmpty() && m_queue.firstKey() <= now ) {
+        const TaskId id = m_queue.first();
+        const bool wasValid = m_validTasks.contains( id );
+        setTask( m_tasks.value( id ), now );
+        if ( m_validTasks.contains( id ) != wasValid )
+            changed.append( id );
+    }
+    std::sort( changed.begin(), changed.end() );
+    return changed;
+}
+
+void TaskValiditySchedule::schedule( TaskId id, qint64 when )
+{
+    if ( when == std::numeric_limits<qint64>::max() )
+        return;
+    m_queue.insert( when, id );
+    m_scheduled.insert( id, when );
+}
+
+void TaskValiditySchedule::unschedule( TaskId id )
+{
+    const auto it = m_scheduled.find( id );
+    if ( it == m_scheduled.end() )
+        return;
+    m_queue.remove( it.value(), id );
+    m_scheduled.erase( it );
+}
@@ -0,0 +1,66 @@
+/*
+  TaskValiditySchedule.h
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TASKVALIDITYSCHEDULE_H
+#define TASKVALIDITYSCHEDULE_H
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+
+#include "Task.h"
+
+/** TaskValiditySchedule keeps track of which tasks are currently valid.
+    The state is computed once per task, and the next validFrom or
+    validUntil boundary of every task is queued, so that advance() only
+    has to look at the tasks whose validity actually changes.
+    All times are milliseconds since the epoch, see
+    QDateTime::currentMSecsSinceEpoch().
+*/
+class TaskValiditySchedule {
+public:
+    void setAllTasks( const TaskList& tasks, qint64 now );
+    /** Add or update the task. */
+    void setTask( const Task& task, qint64 now );
+    void removeTask( TaskId id );
+    void clear();
+
+    /** The state as of the last call to setTask() or advance(). */
+    bool isCurrentlyValid( TaskId id ) const;
+    /** The time when the next task changes its validity, or the maximum
+        qint64 value if none will. */
+    qint64 nextChange() const;
+    /** Update all tasks whose boundary passed at @p now.
+        Returns the ids of the tasks that changed, sorted. */
+    TaskIdList advance( qint64 now );
+
+private:
+    void schedule( TaskId id, qint64 when );
+    void unschedule( TaskId id );
+
+    QHash<TaskId, Task> m_tasks;
+    QSet<TaskId> m_validTasks;
+    // the queue of upcoming boundaries, and the queued time per task:
+    QMultiMap<qint64, TaskId> m_queue;
+    QHash<TaskId, qint64> m_scheduled;
+};
+
+#endif
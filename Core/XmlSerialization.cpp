@@ -29,6 +29,7 @@
 
 #include <QDateTime>
 #include <QFile>
+#include <QXmlStreamWriter>
 
 static QHash<QString,QString> readMetadata( const QDomElement& metadata ) {
     QHash<QString,QString> l;
@@ -52,7 +53,7 @@ namespace XmlSerialization {
         return QStringLiteral("type");
     }
 
-    QDomDocument createXmlTemplate( const QString &docClass )
+    QDomDocument createXmlTemplate( const QString& docClass, const QString& userName )
     {
         QDomDocument doc( reportTagName() );
 
@@ -67,7 +68,7 @@ namespace XmlSerialization {
             root.appendChild( metadata );
             QDomElement username = doc.createElement( QStringLiteral("username") );
             metadata.appendChild( username );
-            QDomText text = doc.createTextNode( Configuration::instance().user.name() );
+            QDomText text = doc.createTextNode( userName );
             username.appendChild( text );
             QDomElement creationTime = doc.createElement( QStringLiteral("creation-time") );
             metadata.appendChild( creationTime );
@@ -83,6 +84,22 @@ namespace XmlSerialization {
         return doc;
     }
 
+    void writeXmlTemplateStart( QXmlStreamWriter& writer, const QString& docClass, const QString& userName )
+    {
+        // no XML declaration, QDomDocument::toByteArray() did not write one either:
+        writer.writeDTD( QStringLiteral("<!DOCTYPE %1>").arg( reportTagName() ) );
+
+        // root element:
+        writer.writeStartElement( reportTagName() );
+        writer.writeAttribute( reportTypeAttribute(), docClass );
+
+        // metadata:
+        writer.writeStartElement( QStringLiteral("metadata") );
+        writer.writeTextElement( QStringLiteral("username"), userName );
+        writer.writeTextElement( QStringLiteral("creation-time"),
+                                 QDateTime::currentDateTimeUtc().toString( Qt::ISODate ) );
+    }
+
     QDomElement reportElement( const QDomDocument& document )
     {
         QDomElement root = document.documentElement();
@@ -121,7 +138,7 @@ QString TaskExport::reportType()
 
 void TaskExport::writeTo( const QString& filename, const TaskList& tasks )
 {
-    QDomDocument document = XmlSerialization::createXmlTemplate( reportType() );
+    QDomDocument document = XmlSerialization::createXmlTemplate( reportType(), Configuration::instance().user.name() );
     QDomElement report = XmlSerialization::reportElement( document );
 
     // write tasks
@@ -31,9 +31,18 @@
 
 #include "Task.h"
 
+class QXmlStreamWriter;
+
 namespace XmlSerialization {
 
-    QDomDocument createXmlTemplate(const QString &docClass );
+    /** The user name is passed in instead of read from the
+        configuration, so that reports can be written on any thread. */
+    QDomDocument createXmlTemplate( const QString& docClass, const QString& userName );
+
+    /** Streaming version of createXmlTemplate(). Leaves the metadata
+        element open, the caller adds its own metadata, closes it and
+        writes the report element. */
+    void writeXmlTemplateStart( QXmlStreamWriter& writer, const QString& docClass, const QString& userName );
 
     QDomElement reportElement( const QDomDocument& doc );
 
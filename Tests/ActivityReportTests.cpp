@@ -0,0 +1,170 @@
+/*
+  ActivityReportTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ActivityReportTests.h"
+#include "Charm/Widgets/ActivityReport.h"
+
+#include "Core/CharmConstants.h"
+#include "Core/CharmDataModel.h"
+
+#include <QRegularExpression>
+#include <QSignalSpy>
+#include <QtTest/QtTest>
+
+#include <algorithm>
+
+namespace {
+    // the durations (in seconds) and event numbers of the rows of one page:
+    int pageSeconds( const QString& page, QList<int>* eventNumbers )
+    {
+        const QRegularExpression comment( QStringLiteral("<pre>event (\\d+)</pre>") );
+        for ( auto it = comment.globalMatch( page ); it.hasNext(); )
+            eventNumbers->append( it.next().captured( 1 ).toInt() );
+
+        const QRegularExpression duration( QStringLiteral("\\((\\d+):(\\d\\d)\\) -- \\[") );
+        int seconds = 0;
+        for ( auto it = duration.globalMatch( page ); it.hasNext(); ) {
+            const QRegularExpressionMatch match = it.next();
+            seconds += match.captured( 1 ).toInt() * 3600 + match.captured( 2 ).toInt() * 60;
+        }
+        return seconds;
+    }
+
+    // the total in the caption of the first page, in seconds:
+    int totalSeconds( const QString& page )
+    {
+        const QRegularExpressionMatch total = QRegularExpression( QStringLiteral("Total: (\\d+):(\\d\\d)") ).match( page );
+        if ( !total.hasMatch() )
+            return -1;
+        return total.captured( 1 ).toInt() * 3600 + total.captured( 2 ).toInt() * 60;
+    }
+}
+
+void ActivityReportTests::testPages()
+{
+    CONFIGURATION.durationFormat = Configuration::Minutes;
+
+    // more events than fit on two pages, of 1 to 7 minutes each, not
+    // in the order of their start times:
+    const int EventCount = 1234;
+    CharmDataModel model;
+    model.setAllTasks( TaskList() << Task( 1, QStringLiteral("One") ) );
+    const QDateTime firstStart( QDate( 2026, 1, 5 ), QTime( 8, 0 ) );
+    EventList events;
+    int expectedSeconds = 0;
+    for ( int i = 0; i < EventCount; ++i ) {
+        Event event;
+        event.setId( i + 1 );
+        event.setTaskId( 1 );
+        event.setStartDateTime( firstStart.addSecs( ( i * 7 ) % EventCount * 600 ) );
+        event.setEndDateTime( event.startDateTime().addSecs( ( i % 7 + 1 ) * 60 ) );
+        event.setComment( QStringLiteral("event %1").arg( i + 1 ) );
+        expectedSeconds += event.duration();
+        events << event;
+    }
+    model.setAllEvents( events );
+
+    ReportGenerator generator;
+    QSignalSpy finished( &generator, SIGNAL(finished(QString,int)) );
+    generator.start( model.snapshot(), ActivityReport::reportJob( &model, QDate( 2026, 1, 1 ), QDate( 2026, 2, 1 ),
+                                                                  QSet<TaskId>(), QSet<TaskId>(), QStringLiteral("Month") ) );
+    QVERIFY( finished.wait() );
+    QCOMPARE( finished.first().at( 1 ).toInt(), 2 );
+    // the other pages are written when they are asked for:
+    const QStringList pages = QStringList() << finished.first().first().toString()
+                                            << generator.page( 1 ) << generator.page( 2 );
+    QVERIFY( generator.page( 3 ).isEmpty() );
+
+    // every event is on exactly one page:
+    QList<int> eventNumbers;
+    QList<int> eventsPerPage;
+    int seconds = 0;
+    Q_FOREACH( const QString& page, pages ) {
+        const int before = eventNumbers.size();
+        seconds += pageSeconds( page, &eventNumbers );
+        eventsPerPage << eventNumbers.size() - before;
+    }
+    QCOMPARE( eventsPerPage, QList<int>() << 500 << 500 << 234 );
+    std::sort( eventNumbers.begin(), eventNumbers.end() );
+    QList<int> expectedNumbers;
+    for ( int i = 1; i <= EventCount; ++i )
+        expectedNumbers << i;
+    QCOMPARE( eventNumbers, expectedNumbers );
+
+    // the total on the first page, computed up front, is the sum over all pages:
+    QCOMPARE( seconds, expectedSeconds );
+    QCOMPARE( totalSeconds( pages.first() ), seconds );
+}
+
+void ActivityReportTests::testTotal_data()
+{
+    QTest::addColumn<QSet<TaskId> >( "rootTasks" );
+    QTest::addColumn<QSet<TaskId> >( "rootExcludeTasks" );
+    QTest::addColumn<int>( "hours" );
+
+    // 1 has the child 2, which has the child 3, 4 is a top level task:
+    QTest::newRow( "all" ) << QSet<TaskId>() << QSet<TaskId>() << 4;
+    QTest::newRow( "subtree" ) << ( QSet<TaskId>() << 1 ) << QSet<TaskId>() << 3;
+    QTest::newRow( "nested roots" ) << ( QSet<TaskId>() << 1 << 2 ) << QSet<TaskId>() << 3;
+    QTest::newRow( "excluded subtree" ) << QSet<TaskId>() << ( QSet<TaskId>() << 2 ) << 2;
+    QTest::newRow( "excluded below root" ) << ( QSet<TaskId>() << 1 << 4 ) << ( QSet<TaskId>() << 3 ) << 3;
+    QTest::newRow( "nested excludes" ) << ( QSet<TaskId>() << 1 ) << ( QSet<TaskId>() << 2 << 3 ) << 1;
+    QTest::newRow( "excluded root" ) << ( QSet<TaskId>() << 2 << 4 ) << ( QSet<TaskId>() << 1 ) << 1;
+}
+
+void ActivityReportTests::testTotal()
+{
+    QFETCH( QSet<TaskId>, rootTasks );
+    QFETCH( QSet<TaskId>, rootExcludeTasks );
+    QFETCH( int, hours );
+
+    CONFIGURATION.durationFormat = Configuration::Minutes;
+    CharmDataModel model;
+    model.setAllTasks( TaskList() << Task( 1, QStringLiteral("One") ) << Task( 2, QStringLiteral("Two"), 1 )
+                                  << Task( 3, QStringLiteral("Three"), 2 ) << Task( 4, QStringLiteral("Four") ) );
+    // one hour for every task:
+    EventList events;
+    for ( int i = 1; i <= 4; ++i ) {
+        Event event;
+        event.setId( i );
+        event.setTaskId( i );
+        event.setStartDateTime( QDateTime( QDate( 2026, 1, 5 ), QTime( 8 + i, 0 ) ) );
+        event.setEndDateTime( event.startDateTime().addSecs( 3600 ) );
+        events << event;
+    }
+    model.setAllEvents( events );
+
+    ReportGenerator generator;
+    QSignalSpy finished( &generator, SIGNAL(finished(QString,int)) );
+    generator.start( model.snapshot(), ActivityReport::reportJob( &model, QDate( 2026, 1, 1 ), QDate( 2026, 2, 1 ),
+                                                                  rootTasks, rootExcludeTasks, QStringLiteral("Month") ) );
+    QVERIFY( finished.wait() );
+    const QString page = finished.first().first().toString();
+    QCOMPARE( totalSeconds( page ), hours * 3600 );
+    // the rollup agrees with the events in the report:
+    QList<int> eventNumbers;
+    QCOMPARE( pageSeconds( page, &eventNumbers ), hours * 3600 );
+}
+
+QTEST_MAIN( ActivityReportTests )
+
+#include "moc_ActivityReportTests.cpp"
@@ -27,10 +27,57 @@
 #include "Core/Task.h"
 #include "Core/TaskTreeItem.h"
 #include "Core/CharmDataModel.h"
+#include "Charm/TaskModelAdapter.h"
 
+#include <QSignalSpy>
 #include <QtDebug>
 #include <QtTest/QtTest>
 
+namespace {
+/** Records the notifications of a model. */
+class AdapterRecorder : public CharmDataModelAdapterInterface
+{
+public:
+    void resetTasks() override { ++taskResets; }
+    void taskAboutToBeAdded( TaskId, int ) override {}
+    void taskAdded( TaskId ) override {}
+    void taskModified( TaskId ) override {}
+    void taskParentAboutToChange( TaskId, TaskId, TaskId ) override {}
+    void taskParentChanged( TaskId, TaskId, TaskId ) override {}
+    void taskAboutToBeDeleted( TaskId ) override {}
+    void taskDeleted( TaskId ) override {}
+
+    void resetEvents() override { ++eventResets; }
+    void eventAboutToBeAdded( EventId ) override {}
+    void eventAdded( EventId ) override { ++singleNotifications; }
+    void eventModified( EventId, Event ) override { ++singleNotifications; }
+    void eventAboutToBeDeleted( EventId ) override {}
+    void eventDeleted( EventId ) override { ++singleNotifications; }
+    void eventsAdded( const EventIdList& ids ) override { added << ids; }
+    void eventsModified( const EventIdList& ids ) override { modified << ids; }
+    void eventsDeleted( const EventIdList& ids ) override { deleted << ids; }
+
+    void eventActivated( EventId ) override {}
+    void eventDeactivated( EventId ) override {}
+
+    int taskResets = 0;
+    int eventResets = 0;
+    int singleNotifications = 0;
+    QList<EventIdList> added;
+    QList<EventIdList> modified;
+    QList<EventIdList> deleted;
+};
+
+Event makeEvent( EventId id, const QString& comment = QString() )
+{
+    Event event;
+    event.setId( id );
+    event.setTaskId( 1 );
+    event.setComment( comment );
+    return event;
+}
+}
+
 CharmDataModelTests::CharmDataModelTests()
     : QObject()
 {
@@ -176,6 +223,335 @@ void CharmDataModelTests::modifyTaskTest()
     QVERIFY( model.taskTreeItem( 0 ).childCount() == 0 );
 }
 
+void CharmDataModelTests::taskTreeRowsTest()
+{
+    CharmDataModel model;
+    Task parent( 1, QStringLiteral("Parent") );
+    TaskList tasks;
+    tasks << parent;
+    for ( int i = 2; i < 7; ++i )
+        tasks << Task( i, QStringLiteral("Child %1").arg( i ), parent.id() );
+    model.setAllTasks( tasks );
+
+    const TaskTreeItem& parentItem = model.taskTreeItem( parent.id() );
+    QCOMPARE( parentItem.childCount(), 5 );
+    for ( int i = 0; i < parentItem.childCount(); ++i ) {
+        QCOMPARE( parentItem.child( i ).row(), i );
+        QCOMPARE( parentItem.child( i ).task().id(), i + 2 );
+    }
+
+    // removing a task in the middle moves up the following siblings:
+    model.deleteTask( tasks[2] ); // task 3
+    QCOMPARE( parentItem.childCount(), 4 );
+    QCOMPARE( model.taskTreeItem( 2 ).row(), 0 );
+    QCOMPARE( model.taskTreeItem( 4 ).row(), 1 );
+    QCOMPARE( model.taskTreeItem( 6 ).row(), 3 );
+
+    // re-parenting appends to the new parent and closes the gap in the old one:
+    Task moved( tasks[3] ); // task 4
+    moved.setParent( 0 );
+    model.modifyTask( moved );
+    QCOMPARE( parentItem.childCount(), 3 );
+    QCOMPARE( model.taskTreeItem( 5 ).row(), 1 );
+    QCOMPARE( model.taskTreeItem( 0 ).childCount(), 2 );
+    QCOMPARE( model.taskTreeItem( 4 ).row(), 1 );
+
+    model.clearTasks();
+    QCOMPARE( model.taskTreeItem( 0 ).childCount(), 0 );
+}
+
+void CharmDataModelTests::taskMoveTest()
+{
+    CharmDataModel model;
+    model.setAllTasks( TaskList() << Task( 1, QStringLiteral("One") )
+                                  << Task( 2, QStringLiteral("Two") )
+                                  << Task( 3, QStringLiteral("Three"), 1 )
+                                  << Task( 4, QStringLiteral("Four"), 1 ) );
+    TaskModelAdapter adapter( &model );
+    QSignalSpy aboutToBeMoved( &adapter, SIGNAL(rowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)) );
+    QSignalSpy moved( &adapter, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)) );
+    QSignalSpy aboutToBeReset( &adapter, SIGNAL(modelAboutToBeReset()) );
+    QSignalSpy reset( &adapter, SIGNAL(modelReset()) );
+
+    // re-parenting a task moves its row, it is appended to the new parent:
+    Task task = model.getTask( 3 );
+    task.setParent( 2 );
+    model.modifyTask( task );
+    QCOMPARE( aboutToBeMoved.count(), 1 );
+    QCOMPARE( moved.count(), 1 );
+    const QList<QVariant> arguments = moved.takeFirst();
+    QCOMPARE( arguments.at( 0 ).value<QModelIndex>(), adapter.indexForTaskId( 1 ) );
+    QCOMPARE( arguments.at( 1 ).toInt(), 0 );
+    QCOMPARE( arguments.at( 2 ).toInt(), 0 );
+    QCOMPARE( arguments.at( 3 ).value<QModelIndex>(), adapter.indexForTaskId( 2 ) );
+    QCOMPARE( arguments.at( 4 ).toInt(), 0 );
+    QCOMPARE( adapter.indexForTaskId( 3 ).parent(), adapter.indexForTaskId( 2 ) );
+    QCOMPARE( adapter.indexForTaskId( 4 ).row(), 0 );
+    QCOMPARE( adapter.rowCount( adapter.indexForTaskId( 1 ) ), 1 );
+    QCOMPARE( aboutToBeReset.count(), 0 );
+    QCOMPARE( reset.count(), 0 );
+
+    // a move the views refuse, like a task below its own child, falls
+    // back to a reset (the data model itself never does this, so the
+    // adapter is notified directly):
+    adapter.taskParentAboutToChange( 2, 0, 3 );
+    adapter.taskParentChanged( 2, 0, 3 );
+    QCOMPARE( aboutToBeMoved.count(), 1 );
+    QCOMPARE( moved.count(), 0 );
+    QCOMPARE( aboutToBeReset.count(), 1 );
+    QCOMPARE( reset.count(), 1 );
+}
+
+void CharmDataModelTests::taskDisplayCacheTest()
+{
+    CharmDataModel model;
+    model.setAllTasks( TaskList() << Task( 1, QStringLiteral("One") )
+                                  << Task( 2, QStringLiteral("Two"), 1 )
+                                  << Task( 3, QStringLiteral("Three") ) );
+    TaskModelAdapter adapter( &model );
+    Q_FOREACH( TaskId id, TaskIdList() << 1 << 2 << 3 ) {
+        adapter.data( adapter.indexForTaskId( id ), Qt::DisplayRole );
+        adapter.data( adapter.indexForTaskId( id ), TasksViewRole_Filter );
+    }
+    QCOMPARE( adapter.m_displayData.size(), 3 );
+
+    // an edited task shows its new data, and so do the full names below it:
+    Task renamed = model.getTask( 1 );
+    renamed.setName( QStringLiteral("Uno") );
+    model.modifyTask( renamed );
+    QVERIFY( adapter.data( adapter.indexForTaskId( 1 ), Qt::DisplayRole ).toString().endsWith( QLatin1String("Uno") ) );
+    QVERIFY( adapter.m_displayData.value( 2 ).idAndFullName.isNull() );
+    QVERIFY( adapter.data( adapter.indexForTaskId( 2 ), TasksViewRole_Filter ).toString().contains( QLatin1String("Uno") ) );
+    QVERIFY( adapter.data( adapter.indexForTaskId( 1 ), TasksViewRole_Filter ).toString().contains( QLatin1String("Uno") ) );
+
+    // an unrelated edit keeps the data of the other tasks:
+    Task other = model.getTask( 3 );
+    other.setName( QStringLiteral("Tres") );
+    model.modifyTask( other );
+    QVERIFY( !adapter.m_displayData.contains( 3 ) );
+    QVERIFY( !adapter.m_displayData.value( 1 ).idAndName.isNull() );
+    QVERIFY( !adapter.m_displayData.value( 1 ).idAndFullName.isNull() );
+    QVERIFY( !adapter.m_displayData.value( 2 ).idAndName.isNull() );
+    QVERIFY( !adapter.m_displayData.value( 2 ).idAndFullName.isNull() );
+    QVERIFY( adapter.data( adapter.indexForTaskId( 3 ), Qt::DisplayRole ).toString().endsWith( QLatin1String("Tres") ) );
+}
+
+void CharmDataModelTests::fullTaskNameTest()
+{
+    CharmDataModel model;
+    Task projects( 1, QStringLiteral("Projects") );
+    Task charm( 2, QStringLiteral("Charm"), projects.id() );
+    Task development( 3, QStringLiteral("Development"), charm.id() );
+    Task customers( 4, QStringLiteral("Customers") );
+    model.setAllTasks( TaskList() << projects << charm << development << customers );
+    QCOMPARE( model.fullTaskName( development ), QStringLiteral("Projects/Charm/Development") );
+
+    // renaming a task changes the names of its subtree:
+    Task renamed( charm );
+    renamed.setName( QStringLiteral("Charm 2") );
+    model.modifyTask( renamed );
+    QCOMPARE( model.fullTaskName( model.getTask( development.id() ) ), QStringLiteral("Projects/Charm 2/Development") );
+
+    // so does moving it:
+    renamed.setParent( customers.id() );
+    model.modifyTask( renamed );
+    QCOMPARE( model.fullTaskName( model.getTask( development.id() ) ), QStringLiteral("Customers/Charm 2/Development") );
+    QCOMPARE( model.fullTaskName( model.getTask( projects.id() ) ), QStringLiteral("Projects") );
+
+    // tasks that differ from the ones in the model are not taken from the cache:
+    Task preview( development );
+    preview.setName( QStringLiteral("Testing") );
+    QCOMPARE( model.fullTaskName( preview ), QStringLiteral("Customers/Charm 2/Testing") );
+}
+
+void CharmDataModelTests::eventBatchTest()
+{
+    CharmDataModel model;
+    model.setAllEvents( EventList() << makeEvent( 1 ) << makeEvent( 2 ) << makeEvent( 3 ) );
+    AdapterRecorder recorder;
+    model.registerAdapter( &recorder );
+
+    model.beginEventBatch();
+    model.addEvent( makeEvent( 5 ) );
+    model.addEvent( makeEvent( 4 ) );
+    model.modifyEvent( makeEvent( 4, QStringLiteral("added, then modified") ) );
+    model.addEvent( makeEvent( 6 ) );
+    model.deleteEvent( makeEvent( 6 ) ); // added, then deleted
+    model.modifyEvent( makeEvent( 1, QStringLiteral("modified") ) );
+    model.modifyEvent( makeEvent( 2, QStringLiteral("modified, then deleted") ) );
+    model.deleteEvent( makeEvent( 2 ) );
+    {
+        // nested batches are delivered with the outermost one:
+        const EventBatch batch( &model );
+        model.deleteEvent( makeEvent( 3 ) );
+    }
+    QCOMPARE( recorder.deleted.size(), 0 );
+    model.commitEventBatch();
+
+    // the model itself was updated right away:
+    QCOMPARE( int( model.eventMap().size() ), 3 );
+    QCOMPARE( model.eventForId( 4 ).comment(), QStringLiteral("added, then modified") );
+
+    QCOMPARE( recorder.singleNotifications, 0 );
+    QCOMPARE( recorder.added, QList<EventIdList>() << ( EventIdList() << 4 << 5 ) );
+    QCOMPARE( recorder.modified, QList<EventIdList>() << ( EventIdList() << 1 ) );
+    QCOMPARE( recorder.deleted, QList<EventIdList>() << ( EventIdList() << 2 << 3 ) );
+
+    // without a batch, the adapters are notified per event:
+    model.modifyEvent( makeEvent( 1 ) );
+    QCOMPARE( recorder.singleNotifications, 1 );
+    QCOMPARE( recorder.modified.size(), 1 );
+
+    model.unregisterAdapter( &recorder );
+}
+
+void CharmDataModelTests::setAllTasksUpdateTest()
+{
+    CharmDataModel model;
+    TaskList tasks;
+    for ( int i = 1; i <= 20; ++i )
+        tasks << Task( i, QStringLiteral("Task %1").arg( i ), i > 16 ? 16 : 0 );
+    model.setAllTasks( tasks );
+    AdapterRecorder recorder;
+    model.registerAdapter( &recorder );
+
+    // rename 1, delete 16 but keep its child 17 below the new task 21,
+    // delete its other children:
+    TaskList changed = tasks.mid( 0, 15 );
+    changed[0].setName( QStringLiteral("Renamed") );
+    changed << Task( 21, QStringLiteral("Task 21"), 2 )
+            << Task( 17, QStringLiteral("Task 17"), 21 );
+    model.setAllTasks( changed );
+
+    QCOMPARE( recorder.taskResets, 0 );
+    CharmDataModel reference;
+    reference.setAllTasks( changed );
+    QVERIFY( model.getAllTasks() == reference.getAllTasks() );
+    QCOMPARE( model.taskTreeItem( 21 ).childCount(), 1 );
+    QCOMPARE( model.fullTaskName( model.getTask( 17 ) ), QStringLiteral("Task 2/Task 21/Task 17") );
+    QCOMPARE( model.smartTaskName( model.getTask( 1 ) ), reference.smartTaskName( reference.getTask( 1 ) ) );
+    QCOMPARE( model.smartTaskName( model.getTask( 17 ) ), reference.smartTaskName( reference.getTask( 17 ) ) );
+
+    // replacing (nearly) everything rebuilds the model:
+    model.setAllTasks( TaskList() << Task( 30, QStringLiteral("Task 30") ) );
+    QCOMPARE( recorder.taskResets, 1 );
+    QCOMPARE( model.getAllTasks().size(), 1 );
+
+    model.unregisterAdapter( &recorder );
+}
+
+void CharmDataModelTests::setAllEventsUpdateTest()
+{
+    CharmDataModel model;
+    EventList events;
+    for ( int i = 1; i <= 6; ++i )
+        events << makeEvent( i );
+    model.setAllEvents( events );
+    AdapterRecorder recorder;
+    model.registerAdapter( &recorder );
+    QCOMPARE( recorder.eventResets, 1 ); // registerAdapter resets the adapter
+
+    events.removeAt( 2 ); // event 3
+    events[0].setComment( QStringLiteral("modified") );
+    events << makeEvent( 7 );
+    model.setAllEvents( events );
+
+    QCOMPARE( recorder.eventResets, 1 );
+    QCOMPARE( recorder.singleNotifications, 0 );
+    QCOMPARE( recorder.added, QList<EventIdList>() << ( EventIdList() << 7 ) );
+    QCOMPARE( recorder.modified, QList<EventIdList>() << ( EventIdList() << 1 ) );
+    QCOMPARE( recorder.deleted, QList<EventIdList>() << ( EventIdList() << 3 ) );
+    QCOMPARE( int( model.eventMap().size() ), 6 );
+    QCOMPARE( model.eventForId( 1 ).comment(), QStringLiteral("modified") );
+
+    model.unregisterAdapter( &recorder );
+}
+
+void CharmDataModelTests::snapshotTest()
+{
+    CharmDataModel model;
+    Task parent( 1, QStringLiteral("Parent") );
+    Task child( 2, QStringLiteral("Child"), parent.id() );
+    model.setAllTasks( TaskList() << parent << child );
+    // the events start on different days:
+    const QDate day( 2026, 3, 2 );
+    Event event1 = makeEvent( 1 );
+    event1.setStartDateTime( QDateTime( day, QTime( 9, 0 ) ) );
+    event1.setEndDateTime( QDateTime( day, QTime( 10, 0 ) ) );
+    Event event2 = makeEvent( 2 );
+    event2.setStartDateTime( QDateTime( day.addDays( 1 ), QTime( 9, 0 ) ) );
+    event2.setEndDateTime( QDateTime( day.addDays( 1 ), QTime( 10, 0 ) ) );
+    model.setAllEvents( EventList() << event1 << event2 );
+
+    const CharmDataModelSnapshot first = model.snapshot();
+    QCOMPARE( first.generation(), model.generation() );
+    QCOMPARE( first.getAllTasks().size(), 2 );
+    QCOMPARE( first.fullTaskName( child.id() ), QStringLiteral("Parent/Child") );
+    QVERIFY( first.isParentOf( parent.id(), child.id() ) );
+    QCOMPARE( first.childIds( 0 ), TaskIdList() << parent.id() );
+    QCOMPARE( first.childIds( parent.id() ), TaskIdList() << child.id() );
+    QVERIFY( first.childIds( child.id() ).isEmpty() );
+    QCOMPARE( first.eventsThatStartInTimeFrame( day, day.addDays( 2 ) ), EventIdList() << 1 << 2 );
+    QCOMPARE( first.eventsThatStartInTimeFrame( day.addDays( 1 ), day.addDays( 2 ) ), EventIdList() << 2 );
+    QVERIFY( !first.eventForId( 3 ).isValid() );
+
+    // without changes, the data is shared:
+    const CharmDataModelSnapshot second = model.snapshot();
+    QVERIFY( &second.eventForId( 1 ) == &first.eventForId( 1 ) );
+    QVERIFY( &second.getAllTasks() == &first.getAllTasks() );
+
+    // changes do not affect existing snapshots, and unchanged parts stay shared:
+    Event modified = event1;
+    modified.setComment( QStringLiteral("modified") );
+    model.modifyEvent( modified );
+    QVERIFY( first.generation() != model.generation() );
+    QCOMPARE( first.eventForId( 1 ).comment(), QString() );
+    const CharmDataModelSnapshot third = model.snapshot();
+    QCOMPARE( third.eventForId( 1 ).comment(), QStringLiteral("modified") );
+    QVERIFY( &third.eventForId( 2 ) == &first.eventForId( 2 ) );
+    QVERIFY( &third.getAllTasks() == &first.getAllTasks() );
+
+    // moving an event to another day updates both days:
+    Event moved = event2;
+    moved.setStartDateTime( QDateTime( day.addDays( 5 ), QTime( 9, 0 ) ) );
+    moved.setEndDateTime( QDateTime( day.addDays( 5 ), QTime( 10, 0 ) ) );
+    model.modifyEvent( moved );
+    const CharmDataModelSnapshot fourth = model.snapshot();
+    QCOMPARE( fourth.eventsThatStartInTimeFrame( day, day.addDays( 2 ) ), EventIdList() << 1 );
+    QCOMPARE( fourth.eventForId( 2 ).startDateTime(), moved.startDateTime() );
+    QVERIFY( &fourth.eventForId( 1 ) == &third.eventForId( 1 ) );
+    QCOMPARE( third.eventsThatStartInTimeFrame( day, day.addDays( 2 ) ), EventIdList() << 1 << 2 );
+
+    model.deleteTask( child );
+    QCOMPARE( first.getAllTasks().size(), 2 );
+    QCOMPARE( model.snapshot().getAllTasks().size(), 1 );
+}
+
+void CharmDataModelTests::setAllTasksBenchmark_data()
+{
+    QTest::addColumn<int>( "count" );
+    QTest::newRow( "1000 siblings" ) << 1000;
+    QTest::newRow( "10000 siblings" ) << 10000;
+    QTest::newRow( "50000 siblings" ) << 50000;
+}
+
+void CharmDataModelTests::setAllTasksBenchmark()
+{
+    QFETCH( int, count );
+
+    // a wide, flat tree like a customer project list:
+    TaskList tasks;
+    tasks << Task( 1, QStringLiteral("Customers") );
+    for ( int i = 2; i <= count; ++i )
+        tasks << Task( i, QString::number( i ), 1 );
+
+    CharmDataModel model;
+    QBENCHMARK {
+        model.setAllTasks( tasks );
+        model.clearTasks();
+    }
+}
+
 void CharmDataModelTests::cleanupTestCase ()
 {
     m_referenceModel->clearTasks();
@@ -40,6 +40,16 @@ private Q_SLOTS:
     void createAndDestroyTest();
     void addAndRemoveTasksTest();
     void modifyTaskTest();
+    void taskTreeRowsTest();
+    void taskMoveTest();
+    void taskDisplayCacheTest();
+    void fullTaskNameTest();
+    void eventBatchTest();
+    void setAllTasksUpdateTest();
+    void setAllEventsUpdateTest();
+    void snapshotTest();
+    void setAllTasksBenchmark_data();
+    void setAllTasksBenchmark();
     void cleanupTestCase();
 
 private:
@@ -0,0 +1,146 @@
+/*
+  DurationRollupTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "DurationRollupTests.h"
+#include "Core/DurationRollup.h"
+
+#include <QtTest/QtTest>
+
+namespace {
+const QDate Monday( 2016, 5, 2 );
+
+Event makeEvent( EventId id, TaskId task, const QDate& day, int seconds )
+{
+    Event event;
+    event.setId( id );
+    event.setTaskId( task );
+    const QDateTime start( day, QTime( 10, 0 ) );
+    event.setStartDateTime( start );
+    event.setEndDateTime( start.addSecs( seconds ) );
+    return event;
+}
+
+TaskList makeTasks()
+{
+    // 1 - 2 - 3, and 4 as a second top level task:
+    return TaskList() << Task( 1, QStringLiteral("1") )
+                      << Task( 2, QStringLiteral("2"), 1 )
+                      << Task( 3, QStringLiteral("3"), 2 )
+                      << Task( 4, QStringLiteral("4") );
+}
+
+void compare( const DurationRollup& actual, const DurationRollup& expected )
+{
+    for ( TaskId task = 0; task <= 4; ++task ) {
+        for ( QDate day = Monday; day < Monday.addDays( 7 ); day = day.addDays( 1 ) ) {
+            QCOMPARE( actual.seconds( task, day ), expected.seconds( task, day ) );
+            QCOMPARE( actual.subtreeSeconds( task, day ), expected.subtreeSeconds( task, day ) );
+        }
+    }
+    QCOMPARE( actual.tasksWithEvents( Monday, Monday.addDays( 7 ) ),
+              expected.tasksWithEvents( Monday, Monday.addDays( 7 ) ) );
+}
+}
+
+void DurationRollupTests::testTotals()
+{
+    DurationRollup rollup;
+    rollup.setAllTasks( makeTasks() );
+    EventMap events;
+    events[1] = makeEvent( 1, 3, Monday, 3600 );
+    events[2] = makeEvent( 2, 3, Monday, 1800 );
+    events[3] = makeEvent( 3, 2, Monday.addDays( 1 ), 600 );
+    events[4] = makeEvent( 4, 4, Monday.addDays( 2 ), 60 );
+    events[5] = makeEvent( 5, 4, Monday.addDays( 7 ), 60 ); // next week
+    rollup.setAllEvents( events );
+
+    QCOMPARE( rollup.seconds( 3, Monday ), 5400 );
+    QCOMPARE( rollup.seconds( 2, Monday ), 0 );
+    QCOMPARE( rollup.subtreeSeconds( 2, Monday ), 5400 );
+    QCOMPARE( rollup.subtreeSeconds( 1, Monday, Monday.addDays( 7 ) ), 6000 );
+    QCOMPARE( rollup.subtreeSeconds( 0, Monday, Monday.addDays( 7 ) ), 6060 );
+    QCOMPARE( rollup.seconds( 4, Monday, Monday.addDays( 8 ) ), 120 );
+    QCOMPARE( rollup.tasksWithEvents( Monday, Monday.addDays( 7 ) ), TaskIdList() << 2 << 3 << 4 );
+    QCOMPARE( rollup.tasksWithEvents( Monday.addDays( 1 ), Monday.addDays( 2 ) ), TaskIdList() << 2 );
+
+    // only the days with own events, the next week is not in the range:
+    QList<QPair<QDate, int> > days;
+    rollup.forEachDay( 4, Monday, Monday.addDays( 7 ), [&days]( const QDate& day, int seconds ) {
+        days << qMakePair( day, seconds );
+    } );
+    QCOMPARE( days, QList<QPair<QDate, int> >() << qMakePair( Monday.addDays( 2 ), 60 ) );
+    days.clear();
+    rollup.forEachDay( 2, Monday, Monday.addDays( 7 ), [&days]( const QDate& day, int seconds ) {
+        days << qMakePair( day, seconds );
+    } );
+    QCOMPARE( days, QList<QPair<QDate, int> >() << qMakePair( Monday.addDays( 1 ), 600 ) );
+
+    // zero length events count as well:
+    rollup.addEvent( makeEvent( 6, 1, Monday.addDays( 3 ), 0 ) );
+    QCOMPARE( rollup.tasksWithEvents( Monday.addDays( 3 ), Monday.addDays( 4 ) ), TaskIdList() << 1 );
+}
+
+void DurationRollupTests::testIncrementalUpdates()
+{
+    TaskList tasks = makeTasks();
+    EventMap events;
+    events[1] = makeEvent( 1, 3, Monday, 3600 );
+    events[2] = makeEvent( 2, 2, Monday.addDays( 1 ), 600 );
+    events[3] = makeEvent( 3, 4, Monday.addDays( 2 ), 60 );
+
+    DurationRollup rollup;
+    rollup.setAllTasks( tasks );
+    rollup.setAllEvents( events );
+
+    // a running event grows, another one moves to a different task and day:
+    events[1] = makeEvent( 1, 3, Monday, 3700 );
+    rollup.modifyEvent( events[1] );
+    events[2] = makeEvent( 2, 4, Monday.addDays( 4 ), 600 );
+    rollup.modifyEvent( events[2] );
+    events[4] = makeEvent( 4, 1, Monday.addDays( 5 ), 120 );
+    rollup.addEvent( events[4] );
+    events.erase( 3 );
+    rollup.deleteEvent( 3 );
+
+    // re-parent 3 below 4:
+    tasks[2].setParent( 4 );
+    rollup.modifyTask( tasks[2] );
+
+    DurationRollup expected;
+    expected.setAllTasks( tasks );
+    expected.setAllEvents( events );
+    compare( rollup, expected );
+    QCOMPARE( rollup.subtreeSeconds( 4, Monday ), 3700 );
+    QCOMPARE( rollup.subtreeSeconds( 1, Monday ), 0 );
+
+    // deleting a task removes its seconds from its parents:
+    rollup.deleteTask( tasks[2] );
+    tasks.removeAt( 2 );
+    expected.setAllTasks( tasks );
+    compare( rollup, expected );
+    QCOMPARE( rollup.seconds( 3, Monday ), 3700 );
+    QCOMPARE( rollup.subtreeSeconds( 4, Monday ), 0 );
+}
+
+QTEST_MAIN( DurationRollupTests )
+
+#include "moc_DurationRollupTests.cpp"
@@ -306,6 +306,163 @@ void EventModelFilterTests::checkEventSpanOver2Days()
     m_referenceModel->clearEvents();
 }
 
+void EventModelFilterTests::checkIndexForEventAfterRemovals()
+{
+    m_eventModelFilter->setFilterStartDate( m_everSpan.timespan.first );
+    m_eventModelFilter->setFilterEndDate( m_everSpan.timespan.second );
+
+    const QDateTime time = QDateTime::currentDateTime().addDays( -1 );
+    EventList events;
+    for ( int i = 1; i <= 10; ++i ) {
+        Event event;
+        event.setId( i );
+        event.setComment( QStringLiteral("event%1").arg( i ) );
+        event.setTaskId( 1000 );
+        event.setStartDateTime( time.addSecs( i * 60 ) );
+        event.setEndDateTime( time.addSecs( i * 60 + 30 ) );
+        events << event;
+    }
+    m_referenceModel->setAllEvents( events );
+
+    // remove single events, and a batch, from the middle:
+    m_referenceModel->deleteEvent( events[2] );
+    m_referenceModel->deleteEvent( events[3] );
+    {
+        EventBatch batch( m_referenceModel );
+        m_referenceModel->deleteEvent( events[6] );
+        m_referenceModel->deleteEvent( events[7] );
+    }
+    Event added = events[0];
+    added.setId( 11 );
+    m_referenceModel->addEvent( added );
+    Event modified = events[8];
+    modified.setComment( QStringLiteral("modified") );
+    m_referenceModel->modifyEvent( modified );
+    events << added;
+
+    QCOMPARE( m_eventModelFilter->events().count(), 7 );
+    Q_FOREACH( const Event& event, events ) {
+        const QModelIndex index = m_eventModelFilter->indexForEvent( event );
+        if ( event.id() == 3 || event.id() == 4 || event.id() == 7 || event.id() == 8 ) {
+            QVERIFY( !index.isValid() );
+        } else {
+            QVERIFY( index.isValid() );
+            QCOMPARE( m_eventModelFilter->eventForIndex( index ).id(), event.id() );
+        }
+    }
+
+    m_referenceModel->clearEvents();
+}
+
+void EventModelFilterTests::checkBatchRemovals()
+{
+    m_eventModelFilter->setFilterStartDate( m_everSpan.timespan.first );
+    m_eventModelFilter->setFilterEndDate( m_everSpan.timespan.second );
+
+    const QDateTime time = QDateTime::currentDateTime().addDays( -1 );
+    EventList events;
+    for ( int i = 1; i <= 10; ++i ) {
+        Event event;
+        event.setId( i );
+        event.setTaskId( 1000 );
+        event.setStartDateTime( time.addSecs( i * 60 ) );
+        event.setEndDateTime( time.addSecs( i * 60 + 30 ) );
+        events << event;
+    }
+    m_referenceModel->setAllEvents( events );
+
+    // rows 1-3 and 6-7 go away, one removal per range:
+    QSignalSpy spy( m_eventModelFilter, SIGNAL(rowsRemoved(QModelIndex,int,int)) );
+    {
+        EventBatch batch( m_referenceModel );
+        m_referenceModel->deleteEvent( events[6] );
+        m_referenceModel->deleteEvent( events[2] );
+        m_referenceModel->deleteEvent( events[1] );
+        m_referenceModel->deleteEvent( events[7] );
+        m_referenceModel->deleteEvent( events[3] );
+    }
+    QCOMPARE( spy.count(), 2 );
+    QCOMPARE( spy.at( 0 ).at( 1 ).toInt(), 6 );
+    QCOMPARE( spy.at( 0 ).at( 2 ).toInt(), 7 );
+    QCOMPARE( spy.at( 1 ).at( 1 ).toInt(), 1 );
+    QCOMPARE( spy.at( 1 ).at( 2 ).toInt(), 3 );
+
+    QCOMPARE( m_eventModelFilter->rowCount(), 5 );
+    QCOMPARE( m_eventModelFilter->totalDuration(), 5 * 30 );
+    const QList<int> remaining = QList<int>() << 0 << 4 << 5 << 8 << 9;
+    for ( int row = 0; row < remaining.size(); ++row ) {
+        const Event& event = events[remaining[row]];
+        QCOMPARE( m_eventModelFilter->indexForEvent( event ).row(), row );
+    }
+
+    m_referenceModel->clearEvents();
+}
+
+static Event eventAt( EventId id, const QDate& date, const QTime& time )
+{
+    Event event;
+    event.setId( id );
+    event.setComment( QStringLiteral("event%1").arg( id ) );
+    event.setTaskId( 1000 );
+    event.setStartDateTime( QDateTime( date, time ) );
+    event.setEndDateTime( QDateTime( date, time ).addSecs( 1800 ) );
+    return event;
+}
+
+static QList<EventId> eventIds( const QList<Event>& events )
+{
+    QList<EventId> ids;
+    Q_FOREACH( const Event& event, events )
+        ids << event.id();
+    return ids;
+}
+
+void EventModelFilterTests::checkIncrementalUpdates()
+{
+    m_eventModelFilter->setFilterDates( m_todaySpan.timespan.first, m_todaySpan.timespan.second );
+
+    const QDate today = m_todaySpan.timespan.first;
+    const QDate yesterday = m_yesterdaySpan.timespan.first;
+    EventList events;
+    events << eventAt( 1, today, QTime( 10, 0 ) )
+           << eventAt( 2, yesterday, QTime( 10, 0 ) )
+           << eventAt( 3, today, QTime( 8, 0 ) );
+    m_referenceModel->setAllEvents( events );
+    QCOMPARE( eventIds( m_eventModelFilter->events() ), QList<EventId>() << 3 << 1 );
+
+    // moved into the time frame, between the other two:
+    m_referenceModel->modifyEvent( eventAt( 2, today, QTime( 9, 0 ) ) );
+    QCOMPARE( eventIds( m_eventModelFilter->events() ), QList<EventId>() << 3 << 2 << 1 );
+
+    QCOMPARE( m_eventModelFilter->totalDuration(), 3 * 1800 );
+
+    // moved to the front, and longer:
+    Event longer = eventAt( 1, today, QTime( 7, 0 ) );
+    longer.setEndDateTime( longer.startDateTime().addSecs( 3600 ) );
+    m_referenceModel->modifyEvent( longer );
+    QCOMPARE( eventIds( m_eventModelFilter->events() ), QList<EventId>() << 1 << 3 << 2 );
+    QCOMPARE( m_eventModelFilter->totalDuration(), 3600 + 2 * 1800 );
+
+    // moved out of the time frame:
+    m_referenceModel->modifyEvent( eventAt( 3, yesterday, QTime( 8, 0 ) ) );
+    QCOMPARE( eventIds( m_eventModelFilter->events() ), QList<EventId>() << 1 << 2 );
+    QCOMPARE( m_eventModelFilter->totalDuration(), 3600 + 1800 );
+
+    // added, and filtered by task:
+    Event other = eventAt( 4, today, QTime( 8, 0 ) );
+    other.setTaskId( 2000 );
+    m_referenceModel->addEvent( other );
+    QCOMPARE( eventIds( m_eventModelFilter->events() ), QList<EventId>() << 1 << 4 << 2 );
+    m_eventModelFilter->setFilterTaskId( 2000 );
+    QCOMPARE( eventIds( m_eventModelFilter->events() ), QList<EventId>() << 4 );
+    QCOMPARE( m_eventModelFilter->totalDuration(), 1800 );
+    m_eventModelFilter->setFilterTaskId( TaskId() );
+
+    m_referenceModel->clearEvents();
+    QCOMPARE( m_eventModelFilter->rowCount(), 0 );
+    QCOMPARE( m_eventModelFilter->totalDuration(), 0 );
+}
+
 QTEST_MAIN( EventModelFilterTests )
 
 #include "moc_EventModelFilterTests.cpp"
@@ -46,6 +46,9 @@ private Q_SLOTS:
     void checkDaysFilter();
     void checkEventSpanOver2Weeks();
     void checkEventSpanOver2Days();
+    void checkIndexForEventAfterRemovals();
+    void checkBatchRemovals();
+    void checkIncrementalUpdates();
 
 private:
     CharmDataModel* m_referenceModel = nullptr;
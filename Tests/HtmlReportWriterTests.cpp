@@ -0,0 +1,64 @@
+/*
+  HtmlReportWriterTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "HtmlReportWriterTests.h"
+#include "Charm/Reports/HtmlReportWriter.h"
+
+#include <QtTest/QtTest>
+
+void HtmlReportWriterTests::testDocument()
+{
+    HtmlReportWriter writer;
+    writer.textElement( QStringLiteral("h1"), QStringLiteral("Report") );
+    writer.emptyElement( QStringLiteral("br") );
+    writer.beginTable();
+    writer.beginRow( QStringLiteral("header_row") );
+    writer.headerCell( QStringLiteral("Task") );
+    writer.endElement();
+    writer.beginRow();
+    writer.cell( QStringLiteral("1:00"), { { QStringLiteral("align"), QStringLiteral("center") } } );
+    // the table and the document are closed by finish():
+
+    QCOMPARE( writer.finish(),
+              QStringLiteral("<!DOCTYPE html>\n"
+                             "<html xmlns=\"http://www.w3.org/1999/xhtml\"><head/><body>"
+                             "<h1>Report</h1><br/>"
+                             "<table width=\"100%\" align=\"left\" cellpadding=\"3\" cellspacing=\"0\">"
+                             "<tr class=\"header_row\"><th>Task</th></tr>"
+                             "<tr><td align=\"center\">1:00</td></tr>"
+                             "</table></body></html>") );
+}
+
+void HtmlReportWriterTests::testEscaping()
+{
+    HtmlReportWriter writer;
+    writer.link( QStringLiteral("a\"b"), QStringLiteral("<Previous Week>") );
+    writer.textElement( QStringLiteral("pre"), QStringLiteral("Fish & Chips\n  <b>") );
+
+    const QString html = writer.finish();
+    QVERIFY( html.contains( QStringLiteral("<a href=\"a&quot;b\">&lt;Previous Week&gt;</a>") ) );
+    QVERIFY( html.contains( QStringLiteral("<pre>Fish &amp; Chips\n  &lt;b&gt;</pre>") ) );
+}
+
+QTEST_MAIN( HtmlReportWriterTests )
+
+#include "moc_HtmlReportWriterTests.cpp"
@@ -0,0 +1,118 @@
+/*
+  ReportGeneratorTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "ReportGeneratorTests.h"
+#include "Charm/Reports/ReportGenerator.h"
+
+#include <QSignalSpy>
+#include <QThread>
+#include <QtTest/QtTest>
+
+namespace {
+    // a job that only returns once it is canceled:
+    QString waitForCancel( const CharmDataModelSnapshot&, ReportGenerator::Control& control )
+    {
+        while ( ! control.isCanceled() )
+            QThread::msleep( 1 );
+        return QStringLiteral("canceled");
+    }
+}
+
+void ReportGeneratorTests::testFinished()
+{
+    ReportGenerator generator;
+    QSignalSpy progress( &generator, SIGNAL(progress(int)) );
+    QSignalSpy finished( &generator, SIGNAL(finished(QString,int)) );
+
+    generator.start( CharmDataModelSnapshot(), []( const CharmDataModelSnapshot&, ReportGenerator::Control& control ) {
+        control.setProgress( 1, 2 );
+        control.setProgress( 1, 2 ); // unchanged, not reported again
+        return QStringLiteral("<p>report</p>");
+    } );
+    QVERIFY( generator.isRunning() );
+    QVERIFY( finished.wait() );
+    QCOMPARE( finished.count(), 1 );
+    QCOMPARE( finished.first().first().toString(), QStringLiteral("<p>report</p>") );
+    QCOMPARE( finished.first().at( 1 ).toInt(), 0 );
+    QCOMPARE( progress.count(), 1 );
+    QCOMPARE( progress.first().first().toInt(), 50 );
+    QVERIFY( ! generator.isRunning() );
+}
+
+void ReportGeneratorTests::testPages()
+{
+    ReportGenerator generator;
+    QSignalSpy finished( &generator, SIGNAL(finished(QString,int)) );
+
+    QAtomicInt written;
+    generator.start( CharmDataModelSnapshot(), [&written]( const CharmDataModelSnapshot&, ReportGenerator::Control& control ) {
+        control.setMorePages( 2, [&written]( int page ) {
+            written.ref();
+            return QStringLiteral("<p>page %1</p>").arg( page );
+        } );
+        return QStringLiteral("<p>first</p>");
+    } );
+    QVERIFY( finished.wait() );
+    QCOMPARE( finished.first().first().toString(), QStringLiteral("<p>first</p>") );
+    QCOMPARE( finished.first().at( 1 ).toInt(), 2 );
+    // the pages are only written when they are asked for:
+    QCOMPARE( written.load(), 0 );
+    QCOMPARE( generator.page( 2 ), QStringLiteral("<p>page 2</p>") );
+    QCOMPARE( generator.page( 1 ), QStringLiteral("<p>page 1</p>") );
+    QCOMPARE( written.load(), 2 );
+    QVERIFY( generator.page( 0 ).isEmpty() );
+    QVERIFY( generator.page( 3 ).isEmpty() );
+}
+
+void ReportGeneratorTests::testNewerRequestCancels()
+{
+    ReportGenerator generator;
+    QSignalSpy finished( &generator, SIGNAL(finished(QString,int)) );
+
+    generator.start( CharmDataModelSnapshot(), waitForCancel );
+    generator.start( CharmDataModelSnapshot(), []( const CharmDataModelSnapshot&, ReportGenerator::Control& ) {
+        return QStringLiteral("second");
+    } );
+    QVERIFY( finished.wait() );
+    QTest::qWait( 50 );
+    // the result of the canceled request is dropped:
+    QCOMPARE( finished.count(), 1 );
+    QCOMPARE( finished.first().first().toString(), QStringLiteral("second") );
+
+    generator.start( CharmDataModelSnapshot(), waitForCancel );
+    generator.cancel();
+    QVERIFY( ! generator.isRunning() );
+    QVERIFY( ! finished.wait( 100 ) );
+}
+
+void ReportGeneratorTests::testDestructorCancels()
+{
+    QScopedPointer<ReportGenerator> generator( new ReportGenerator );
+    generator->start( CharmDataModelSnapshot(), waitForCancel );
+    // returns once the job noticed the cancellation:
+    generator.reset();
+}
+
+QTEST_MAIN( ReportGeneratorTests )
+
+#include "moc_ReportGeneratorTests.cpp"
@@ -49,6 +49,86 @@ void SmartNameCacheTests::testCache()
     QCOMPARE( cache.smartName( lotsofcakeDevelopment.id() ), QLatin1String("Lotsofcake/Development") );
 }
 
+// returns the result instead of comparing in here, so that the test
+// stops at the first mismatch:
+static bool compareWithRegeneratedCache( const SmartNameCache& cache, const TaskList& tasks )
+{
+    SmartNameCache reference;
+    reference.setAllTasks( tasks );
+    Q_FOREACH( const Task& task, tasks ) {
+        if ( cache.smartName( task.id() ) != reference.smartName( task.id() ) ) {
+            qWarning() << "Task" << task.id() << ":" << cache.smartName( task.id() )
+                       << "expected" << reference.smartName( task.id() );
+            return false;
+        }
+    }
+    return true;
+}
+
+void SmartNameCacheTests::testIncrementalUpdates()
+{
+    SmartNameCache cache;
+    TaskList tasks;
+    tasks << Task( 1, QStringLiteral("Projects") )
+          << Task( 2, QStringLiteral("Charm"), 1 )
+          << Task( 3, QStringLiteral("Development"), 2 )
+          << Task( 4, QStringLiteral("Lotsofcake"), 1 )
+          << Task( 5, QStringLiteral("Development"), 4 )
+          << Task( 6, QStringLiteral("Customers") );
+
+    Q_FOREACH( const Task& task, tasks )
+        cache.addTask( task );
+    QVERIFY( compareWithRegeneratedCache( cache, tasks ) );
+    QCOMPARE( cache.smartName( 5 ), QLatin1String("Lotsofcake/Development") );
+
+    // renaming a parent changes the names of the tasks below it:
+    tasks[3].setName( QStringLiteral("Charm") );
+    cache.modifyTask( tasks[3] );
+    QVERIFY( compareWithRegeneratedCache( cache, tasks ) );
+    QCOMPARE( cache.smartName( 3 ), QLatin1String("Projects/Charm/Development") );
+
+    // so does moving it:
+    tasks[3].setParent( 6 );
+    cache.modifyTask( tasks[3] );
+    QVERIFY( compareWithRegeneratedCache( cache, tasks ) );
+    QCOMPARE( cache.smartName( 5 ), QLatin1String("Customers/Charm/Development") );
+
+    // a task name that contains the separator can collide with a path:
+    tasks << Task( 7, QStringLiteral("Charm/Development") );
+    cache.addTask( tasks.last() );
+    QVERIFY( compareWithRegeneratedCache( cache, tasks ) );
+
+    // deleting a task removes its name and regenerates its group:
+    cache.deleteTask( tasks[4] );
+    tasks.removeAt( 4 );
+    QVERIFY( compareWithRegeneratedCache( cache, tasks ) );
+    QCOMPARE( cache.smartName( 5 ), QString() );
+}
+
+void SmartNameCacheTests::modifyTaskBenchmark()
+{
+    // 20000 tasks: 200 customers with 100 projects each, the
+    // projects are named alike for all customers
+    TaskList tasks;
+    TaskId id = 1;
+    for ( int customer = 0; customer < 200; ++customer ) {
+        const TaskId customerId = id++;
+        tasks << Task( customerId, QStringLiteral("Customer %1").arg( customer ) );
+        for ( int project = 0; project < 99; ++project )
+            tasks << Task( id++, QStringLiteral("Project %1").arg( project ), customerId );
+    }
+
+    SmartNameCache cache;
+    cache.setAllTasks( tasks );
+
+    Task task = tasks[1];
+    int counter = 0;
+    QBENCHMARK {
+        task.setName( QStringLiteral("Renamed %1").arg( ++counter ) );
+        cache.modifyTask( task );
+    }
+    QCOMPARE( cache.smartName( task.id() ), QStringLiteral("Customer 0/%1").arg( task.name() ) );
+}
 
 QTEST_MAIN( SmartNameCacheTests )
 
@@ -32,6 +32,8 @@ class SmartNameCacheTests : public QObject
 
 private Q_SLOTS:
     void testCache();
+    void testIncrementalUpdates();
+    void modifyTaskBenchmark();
 };
 
 #endif
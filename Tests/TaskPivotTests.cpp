@@ -0,0 +1,211 @@
+/*
+  TaskPivotTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "TaskPivotTests.h"
+#include "Charm/Reports/TaskPivot.h"
+
+#include "Core/CharmDataModel.h"
+#include "Core/CharmDataModelSnapshot.h"
+
+#include <QtTest/QtTest>
+
+#include <algorithm>
+
+namespace {
+    const QDate Monday( 2016, 5, 2 );
+
+    Event makeEvent( EventId id, TaskId task, const QDate& day, int seconds )
+    {
+        Event event;
+        event.setId( id );
+        event.setTaskId( task );
+        const QDateTime start( day, QTime( 10, 0 ) );
+        event.setStartDateTime( start );
+        event.setEndDateTime( start.addSecs( seconds ) );
+        return event;
+    }
+
+    //  1
+    //  +- 2
+    //  |  +- 4
+    //  +- 3
+    //  5
+    void setUpModel( CharmDataModel* model )
+    {
+        model->setAllTasks( TaskList()
+                            << Task( 1, QStringLiteral("One") )
+                            << Task( 3, QStringLiteral("Three"), 1 )
+                            << Task( 2, QStringLiteral("Two"), 1 )
+                            << Task( 4, QStringLiteral("Four"), 2 )
+                            << Task( 5, QStringLiteral("Five") ) );
+        model->setAllEvents( EventList()
+                             << makeEvent( 1, 4, Monday, 3600 )
+                             << makeEvent( 2, 4, Monday.addDays( 1 ), 1800 )
+                             << makeEvent( 3, 3, Monday.addDays( 1 ), 600 )
+                             << makeEvent( 4, 1, Monday.addDays( 2 ), 60 )
+                             << makeEvent( 5, 5, Monday.addDays( 6 ), 120 )
+                             << makeEvent( 6, 5, Monday.addDays( 7 ), 240 ) ); // next week
+    }
+
+    // the order of the rows below the root depends on the order the
+    // tasks come in, so they are compared sorted:
+    TaskIdList rowTasks( const TaskPivot& pivot )
+    {
+        TaskIdList tasks;
+        for ( int row = 0; row < pivot.rowCount(); ++row )
+            tasks << pivot.taskId( row );
+        std::sort( tasks.begin() + 1, tasks.end() );
+        return tasks;
+    }
+}
+
+void TaskPivotTests::testBuckets()
+{
+    const TaskPivot::Buckets days = TaskPivot::Buckets::days( Monday, Monday.addDays( 7 ) );
+    QCOMPARE( days.count(), 7 );
+    QCOMPARE( days.bucket( Monday ), 0 );
+    QCOMPARE( days.bucket( Monday.addDays( 6 ) ), 6 );
+    QCOMPARE( days.bucket( Monday.addDays( 7 ) ), -1 );
+    QCOMPARE( days.bucket( Monday.addDays( -1 ) ), -1 );
+
+    // May 2016 starts on a Sunday and has parts of 6 weeks:
+    const TaskPivot::Buckets weeks = TaskPivot::Buckets::weeks( QDate( 2016, 5, 1 ), QDate( 2016, 6, 1 ) );
+    QCOMPARE( weeks.count(), 6 );
+    QCOMPARE( weeks.bucket( QDate( 2016, 5, 1 ) ), 0 );
+    QCOMPARE( weeks.bucket( Monday ), 1 );
+    QCOMPARE( weeks.bucket( QDate( 2016, 5, 31 ) ), 5 );
+    QCOMPARE( weeks.firstDay( 1 ), Monday );
+
+    const TaskPivot::Buckets months = TaskPivot::Buckets::months( QDate( 2016, 1, 1 ), QDate( 2017, 1, 1 ) );
+    QCOMPARE( months.count(), 12 );
+    QCOMPARE( months.bucket( QDate( 2016, 2, 29 ) ), 1 );
+    QCOMPARE( months.bucket( QDate( 2016, 12, 31 ) ), 11 );
+    QCOMPARE( months.firstDay( 11 ), QDate( 2016, 12, 1 ) );
+
+    // only the working days:
+    const TaskPivot::Buckets workDays = TaskPivot::Buckets::custom( Monday, Monday.addDays( 7 ), 5, []( const QDate& day ) {
+        return day.dayOfWeek() <= 5 ? day.dayOfWeek() - 1 : -1;
+    } );
+    QCOMPARE( workDays.count(), 5 );
+    QCOMPARE( workDays.bucket( Monday.addDays( 4 ) ), 4 );
+    QCOMPARE( workDays.bucket( Monday.addDays( 5 ) ), -1 );
+}
+
+void TaskPivotTests::testRollup()
+{
+    CharmDataModel model;
+    setUpModel( &model );
+
+    TaskPivot pivot( TaskPivot::Buckets::days( Monday, Monday.addDays( 7 ) ) );
+    pivot.compute( &model );
+    QCOMPARE( rowTasks( pivot ), TaskIdList() << 0 << 1 << 2 << 3 << 4 << 5 );
+    // parents before their children, the root first:
+    QCOMPARE( pivot.taskId( 0 ), TaskId( 0 ) );
+    for ( int row = 1; row < pivot.rowCount(); ++row ) {
+        QVERIFY( pivot.parentRow( row ) < row );
+        QCOMPARE( pivot.taskId( pivot.parentRow( row ) ), model.getTask( pivot.taskId( row ) ).parent() );
+    }
+    QCOMPARE( pivot.parentRow( pivot.row( 4 ) ), pivot.row( 2 ) );
+    QCOMPARE( pivot.seconds( pivot.row( 4 ), 1 ), 1800 );
+    QCOMPARE( pivot.seconds( pivot.row( 2 ), 1 ), 0 );
+    QCOMPARE( pivot.subtreeSeconds( pivot.row( 1 ), 0 ), 3600 );
+    QCOMPARE( pivot.subtreeSeconds( pivot.row( 1 ), 1 ), 2400 );
+    QCOMPARE( pivot.subtreeTotal( pivot.row( 1 ) ), 6060 );
+    QCOMPARE( pivot.subtreeTotal( 0 ), 6180 );
+    QCOMPARE( pivot.row( 6 ), -1 );
+
+    // the own seconds of a task, without its subtasks:
+    QVector<int> seconds;
+    for ( int column = 0; column < pivot.columnCount(); ++column )
+        seconds << pivot.seconds( pivot.row( 4 ), column );
+    QCOMPARE( seconds, QVector<int>() << 3600 << 1800 << 0 << 0 << 0 << 0 << 0 );
+}
+
+void TaskPivotTests::testRootTask()
+{
+    CharmDataModel model;
+    setUpModel( &model );
+    const TaskPivot::Buckets days = TaskPivot::Buckets::days( Monday, Monday.addDays( 7 ) );
+
+    TaskPivot subtree( days );
+    subtree.setRootTask( 2 );
+    subtree.compute( &model );
+    QCOMPARE( rowTasks( subtree ), TaskIdList() << 2 << 4 );
+    QCOMPARE( subtree.subtreeTotal( 0 ), 5400 );
+    QCOMPARE( subtree.seconds( subtree.row( 2 ), 1 ), 0 );
+    QCOMPARE( subtree.seconds( subtree.row( 4 ), 1 ), 1800 );
+
+    TaskPivot leaf( days );
+    leaf.setRootTask( 5 );
+    leaf.compute( &model );
+    QCOMPARE( rowTasks( leaf ), TaskIdList() << 5 );
+    QCOMPARE( leaf.subtreeTotal( 0 ), 120 );
+}
+
+void TaskPivotTests::testSnapshot()
+{
+    CharmDataModel model;
+    setUpModel( &model );
+    const CharmDataModelSnapshot snapshot = model.snapshot();
+
+    // the snapshot gives the same results as the model:
+    const QList<TaskPivot::Buckets> buckets = QList<TaskPivot::Buckets>()
+        << TaskPivot::Buckets::days( Monday, Monday.addDays( 7 ) )
+        << TaskPivot::Buckets::weeks( QDate( 2016, 5, 1 ), QDate( 2016, 6, 1 ) )
+        << TaskPivot::Buckets::months( QDate( 2016, 4, 1 ), QDate( 2016, 7, 1 ) );
+    Q_FOREACH( const TaskPivot::Buckets& bucket, buckets ) {
+        Q_FOREACH( TaskId root, TaskIdList() << 0 << 1 << 2 << 5 ) {
+            TaskPivot expected( bucket );
+            expected.setRootTask( root );
+            expected.compute( &model );
+            TaskPivot pivot( bucket );
+            pivot.setRootTask( root );
+            pivot.compute( snapshot );
+            QCOMPARE( rowTasks( pivot ), rowTasks( expected ) );
+            for ( int row = 0; row < pivot.rowCount(); ++row ) {
+                const int expectedRow = expected.row( pivot.taskId( row ) );
+                for ( int column = 0; column < pivot.columnCount(); ++column )
+                    QCOMPARE( pivot.seconds( row, column ), expected.seconds( expectedRow, column ) );
+                QCOMPARE( pivot.subtreeTotal( row ), expected.subtreeTotal( expectedRow ) );
+            }
+        }
+    }
+}
+
+void TaskPivotTests::testRollUpMatrix()
+{
+    // 0 <- 1 <- 2, and 0 <- 3:
+    QVector<int> matrix = QVector<int>() << 1 << 2
+                                         << 10 << 20
+                                         << 100 << 200
+                                         << 1000 << 2000;
+    TaskPivot::rollUp( matrix, QVector<int>() << -1 << 0 << 1 << 0, 2 );
+    QCOMPARE( matrix, QVector<int>() << 1111 << 2222
+                                     << 110 << 220
+                                     << 100 << 200
+                                     << 1000 << 2000 );
+}
+
+QTEST_MAIN( TaskPivotTests )
+
+#include "moc_TaskPivotTests.cpp"
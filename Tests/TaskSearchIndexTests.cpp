@@ -0,0 +1,160 @@
+/*
+  TaskSearchIndexTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "TaskSearchIndexTests.h"
+#include "Core/TaskSearchIndex.h"
+
+#include <QtTest/QtTest>
+
+void TaskSearchIndexTests::testFind()
+{
+    TaskSearchIndex index;
+    index.setText( 1, QStringLiteral("0001 KDAB/Charm") );
+    index.setText( 2, QStringLiteral("0002 KDAB/Charm/Reports weekly") );
+    index.setText( 3, QStringLiteral("0003 Customer/Training") );
+
+    QCOMPARE( index.find( QString() ), TaskIdList() << 1 << 2 << 3 );
+    QCOMPARE( index.find( QStringLiteral("charm") ), TaskIdList() << 1 << 2 );
+    // case is ignored, words have to occur in order:
+    QCOMPARE( index.find( QStringLiteral("kdab REP") ), TaskIdList() << 2 );
+    QCOMPARE( index.find( QStringLiteral("rep kdab") ), TaskIdList() );
+    // wildcards separate words, like in the old filter:
+    QCOMPARE( index.find( QStringLiteral("cust*train") ), TaskIdList() << 3 );
+    // short words are checked without the index:
+    QCOMPARE( index.find( QStringLiteral("3") ), TaskIdList() << 3 );
+    QCOMPARE( index.find( QStringLiteral("xyz") ), TaskIdList() );
+}
+
+void TaskSearchIndexTests::testUpdates()
+{
+    TaskSearchIndex index;
+    index.setText( 1, QStringLiteral("0001 Alpha") );
+    index.setText( 2, QStringLiteral("0002 Beta") );
+    QCOMPARE( index.find( QStringLiteral("alp") ), TaskIdList() << 1 );
+
+    index.setText( 2, QStringLiteral("0002 Alphabet") );
+    QCOMPARE( index.find( QStringLiteral("alp") ), TaskIdList() << 1 << 2 );
+    QCOMPARE( index.find( QStringLiteral("beta") ), TaskIdList() );
+
+    index.removeTask( 1 );
+    QVERIFY( !index.contains( 1 ) );
+    QCOMPARE( index.find( QStringLiteral("alp") ), TaskIdList() << 2 );
+
+    index.clear();
+    QCOMPARE( index.find( QStringLiteral("alp") ), TaskIdList() );
+}
+
+void TaskSearchIndexTests::testIncrementalQueries()
+{
+    TaskSearchIndex index;
+    index.setText( 1, QStringLiteral("0001 Development") );
+    index.setText( 2, QStringLiteral("0002 Devops") );
+    index.setText( 3, QStringLiteral("0003 Design") );
+
+    // typing narrows the result down:
+    QCOMPARE( index.find( QStringLiteral("d") ), TaskIdList() << 1 << 2 << 3 );
+    QCOMPARE( index.find( QStringLiteral("de") ), TaskIdList() << 1 << 2 << 3 );
+    QCOMPARE( index.find( QStringLiteral("dev") ), TaskIdList() << 1 << 2 );
+    QCOMPARE( index.find( QStringLiteral("dev op") ), TaskIdList() << 1 << 2 );
+    QCOMPARE( index.find( QStringLiteral("dev ops") ), TaskIdList() << 2 );
+    // deleting characters widens it again:
+    QCOMPARE( index.find( QStringLiteral("de") ), TaskIdList() << 1 << 2 << 3 );
+    // changes invalidate the previous result:
+    index.setText( 4, QStringLiteral("0004 Deployment") );
+    QCOMPARE( index.find( QStringLiteral("dep") ), TaskIdList() << 4 );
+}
+
+void TaskSearchIndexTests::testWildcards()
+{
+    TaskSearchIndex index;
+    index.setText( 1, QStringLiteral("0001 KDAB/Charm") );
+    index.setText( 2, QStringLiteral("0002 KDAB/Charm/Reports weekly") );
+    index.setText( 3, QStringLiteral("0003 Customer/Training") );
+    index.setText( 4, QStringLiteral("0004 Customer/Travel [2026]") );
+
+    // ? and [...] work like in the wildcard filter used before:
+    QCOMPARE( index.find( QStringLiteral("000?") ), TaskIdList() << 1 << 2 << 3 << 4 );
+    QCOMPARE( index.find( QStringLiteral("c?arm") ), TaskIdList() << 1 << 2 );
+    QCOMPARE( index.find( QStringLiteral("000[13]") ), TaskIdList() << 1 << 3 );
+    QCOMPARE( index.find( QStringLiteral("000[^13]") ), TaskIdList() << 2 << 4 );
+    QCOMPARE( index.find( QStringLiteral("tra[a-i]") ), TaskIdList() << 3 );
+    QCOMPARE( index.find( QStringLiteral("cust*tra?el") ), TaskIdList() << 4 );
+    // the words still have to occur in order:
+    QCOMPARE( index.find( QStringLiteral("rep?rts kdab") ), TaskIdList() );
+    // an unmatched [ is a plain character:
+    QCOMPARE( index.find( QStringLiteral("[2026") ), TaskIdList() << 4 );
+
+    // a query with wildcards is not used to narrow down the next one:
+    QCOMPARE( index.find( QStringLiteral("000[1]") ), TaskIdList() << 1 );
+    QCOMPARE( index.find( QStringLiteral("000[1]2") ), TaskIdList() );
+    QCOMPARE( index.find( QStringLiteral("000[12]") ), TaskIdList() << 1 << 2 );
+
+    // the same as the wildcard filter used before:
+    const QStringList queries = QStringList()
+        << QStringLiteral("k?ab*rep") << QStringLiteral("[ck]*[^x]ain") << QStringLiteral("?");
+    Q_FOREACH( const QString& query, queries ) {
+        const QRegExp wildcard( query, Qt::CaseInsensitive, QRegExp::Wildcard );
+        TaskIdList expected;
+        for ( TaskId id = 1; id <= 4; ++id ) {
+            const QString text = id == 1 ? QStringLiteral("0001 KDAB/Charm")
+                : id == 2 ? QStringLiteral("0002 KDAB/Charm/Reports weekly")
+                : id == 3 ? QStringLiteral("0003 Customer/Training")
+                : QStringLiteral("0004 Customer/Travel [2026]");
+            if ( text.contains( wildcard ) )
+                expected << id;
+        }
+        QCOMPARE( index.find( query ), expected );
+    }
+}
+
+void TaskSearchIndexTests::testFindBenchmark()
+{
+    TaskSearchIndex index;
+    QStringList texts;
+    for ( int i = 1; i <= 50000; ++i ) {
+        texts << QStringLiteral("%1 Customer %2/Project %3/Task %4")
+                 .arg( i, 5, 10, QLatin1Char( '0' ) )
+                 .arg( i / 1000 ).arg( i / 100 ).arg( i );
+        index.setText( i, texts.last() );
+    }
+    const QStringList typing = QStringList()
+        << QStringLiteral("c") << QStringLiteral("cu") << QStringLiteral("cus")
+        << QStringLiteral("cust 4") << QStringLiteral("cust 42")
+        << QStringLiteral("cust 42 proj") << QStringLiteral("cust 42 proj 4217");
+    QBENCHMARK {
+        Q_FOREACH( const QString& text, typing )
+            index.find( text );
+    }
+    // the same as the wildcard filter used before:
+    const QRegExp wildcard( QStringLiteral("cust*42*proj*4217"), Qt::CaseInsensitive, QRegExp::Wildcard );
+    TaskIdList expected;
+    for ( int i = 0; i < texts.size(); ++i ) {
+        if ( texts[i].contains( wildcard ) )
+            expected << i + 1;
+    }
+    QVERIFY( !expected.isEmpty() );
+    QCOMPARE( index.find( QStringLiteral("cust 42 proj 4217") ), expected );
+}
+
+QTEST_MAIN( TaskSearchIndexTests )
+
+#include "moc_TaskSearchIndexTests.cpp"
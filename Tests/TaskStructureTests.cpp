@@ -88,6 +88,52 @@ void TaskStructureTests::checkForTreenessTest()
     QCOMPARE( Task::checkForTreeness( tasks ), directed );
 }
 
+void TaskStructureTests::checkTaskListTest()
+{
+    TaskList tasks;
+    tasks << Task( 1, QStringLiteral("Root") )
+          << Task( 2, QStringLiteral("Child"), 1 )
+          << Task( 3, QStringLiteral("Orphan"), 42 )
+          << Task( 4, QStringLiteral("Below orphan"), 3 )
+          << Task( 5, QStringLiteral("Cycle A"), 6 )
+          << Task( 6, QStringLiteral("Cycle B"), 7 )
+          << Task( 7, QStringLiteral("Cycle C"), 5 )
+          << Task( 8, QStringLiteral("Hangs off the cycle"), 6 )
+          << Task( 9, QStringLiteral("Own parent"), 9 )
+          << Task( 2, QStringLiteral("Duplicate"), 1 )
+          << Task();
+
+    const TaskListProblems problems = Task::checkTaskList( tasks );
+    QVERIFY( ! problems.isEmpty() );
+    QCOMPARE( problems.invalidTasks, 1 );
+    QCOMPARE( problems.duplicateIds, TaskIdList() << 2 );
+    QCOMPARE( problems.orphans, TaskIdList() << 3 );
+    QCOMPARE( problems.cycles.size(), 2 );
+    QCOMPARE( problems.cycles[0], TaskIdList() << 5 << 6 << 7 );
+    QCOMPARE( problems.cycles[1], TaskIdList() << 9 );
+    QCOMPARE( problems.toString(), QStringLiteral("1 invalid task(s); duplicate ids: 2; orphans: 3; cycle: 5 -> 6 -> 7; cycle: 9") );
+
+    tasks = tasks.mid( 0, 2 );
+    QVERIFY( Task::checkTaskList( tasks ).isEmpty() );
+    QVERIFY( Task::checkForTreeness( tasks ) );
+}
+
+void TaskStructureTests::checkTaskListBenchmark()
+{
+    // a wide tree, with the children listed before their parents:
+    const int count = 100000;
+    TaskList tasks;
+    tasks.reserve( count );
+    for ( TaskId id = count; id > 0; --id )
+        tasks << Task( id, QStringLiteral("Task"), id > 10 ? id / 10 : 0 );
+
+    bool isTree = false;
+    QBENCHMARK {
+        isTree = Task::checkForTreeness( tasks ) && Task::checkForUniqueTaskIds( tasks );
+    }
+    QVERIFY( isTree );
+}
+
 void TaskStructureTests::mergeTaskListsTest_data()
 {
     QTest::addColumn<TaskList>( "old" );
@@ -43,6 +43,9 @@ private Q_SLOTS:
     void checkForTreenessTest_data();
     void checkForTreenessTest();
 
+    void checkTaskListTest();
+    void checkTaskListBenchmark();
+
     void mergeTaskListsTest_data();
     void mergeTaskListsTest();
 };
@@ -0,0 +1,117 @@
+/*
+  TaskValidityScheduleTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "TaskValidityScheduleTests.h"
+#include "Core/TaskValiditySchedule.h"
+
+#include <QtTest/QtTest>
+
+#include <limits>
+
+namespace {
+    const QDateTime Base( QDate( 2016, 3, 1 ), QTime( 12, 0 ), Qt::UTC );
+
+    Task makeTask( TaskId id, int fromHours, int untilHours )
+    {
+        Task task;
+        task.setId( id );
+        task.setName( QStringLiteral("Task %1").arg( id ) );
+        // zero means no boundary:
+        if ( fromHours != 0 )
+            task.setValidFrom( Base.addSecs( fromHours * 3600 ) );
+        if ( untilHours != 0 )
+            task.setValidUntil( Base.addSecs( untilHours * 3600 ) );
+        return task;
+    }
+
+    qint64 at( int hours )
+    {
+        return Base.addSecs( hours * 3600 ).toMSecsSinceEpoch();
+    }
+}
+
+void TaskValidityScheduleTests::testValidity()
+{
+    TaskValiditySchedule schedule;
+    schedule.setAllTasks( TaskList()
+                          << makeTask( 1, 0, 0 )
+                          << makeTask( 2, -2, 0 )
+                          << makeTask( 3, 2, 0 )
+                          << makeTask( 4, 0, -1 )
+                          << makeTask( 5, -1, 3 ), at( 0 ) );
+
+    QVERIFY( schedule.isCurrentlyValid( 1 ) );
+    QVERIFY( schedule.isCurrentlyValid( 2 ) );
+    QVERIFY( ! schedule.isCurrentlyValid( 3 ) );
+    QVERIFY( ! schedule.isCurrentlyValid( 4 ) );
+    QVERIFY( schedule.isCurrentlyValid( 5 ) );
+    QVERIFY( ! schedule.isCurrentlyValid( 6 ) );
+    // validFrom itself is excluded, like in Task::isCurrentlyValid():
+    QCOMPARE( schedule.nextChange(), at( 2 ) + 1 );
+}
+
+void TaskValidityScheduleTests::testAdvance()
+{
+    TaskValiditySchedule schedule;
+    schedule.setAllTasks( TaskList()
+                          << makeTask( 1, 1, 0 )
+                          << makeTask( 2, 0, 1 )
+                          << makeTask( 3, 1, 2 ), at( 0 ) );
+    QCOMPARE( schedule.nextChange(), at( 1 ) );
+
+    QCOMPARE( schedule.advance( at( 0 ) ), TaskIdList() );
+    // task 2 expires, tasks 1 and 3 start one millisecond later:
+    QCOMPARE( schedule.advance( at( 1 ) ), TaskIdList() << 2 );
+    QCOMPARE( schedule.advance( at( 1 ) + 1 ), TaskIdList() << 1 << 3 );
+    QVERIFY( schedule.isCurrentlyValid( 1 ) );
+    QVERIFY( ! schedule.isCurrentlyValid( 2 ) );
+    QCOMPARE( schedule.nextChange(), at( 2 ) );
+
+    // a late timer still catches up with every boundary:
+    QCOMPARE( schedule.advance( at( 5 ) ), TaskIdList() << 3 );
+    QCOMPARE( schedule.nextChange(), std::numeric_limits<qint64>::max() );
+}
+
+void TaskValidityScheduleTests::testUpdates()
+{
+    TaskValiditySchedule schedule;
+    schedule.setTask( makeTask( 1, 0, 1 ), at( 0 ) );
+    QVERIFY( schedule.isCurrentlyValid( 1 ) );
+
+    // the old boundary is dropped with the old task:
+    schedule.setTask( makeTask( 1, 0, 3 ), at( 0 ) );
+    QCOMPARE( schedule.nextChange(), at( 3 ) );
+    QCOMPARE( schedule.advance( at( 2 ) ), TaskIdList() );
+
+    schedule.setTask( makeTask( 1, 0, -1 ), at( 2 ) );
+    QVERIFY( ! schedule.isCurrentlyValid( 1 ) );
+    QCOMPARE( schedule.nextChange(), std::numeric_limits<qint64>::max() );
+
+    schedule.setTask( makeTask( 2, 0, 4 ), at( 2 ) );
+    schedule.removeTask( 2 );
+    QVERIFY( ! schedule.isCurrentlyValid( 2 ) );
+    QCOMPARE( schedule.nextChange(), std::numeric_limits<qint64>::max() );
+}
+
+QTEST_MAIN( TaskValidityScheduleTests )
+
+#include "moc_TaskValidityScheduleTests.cpp"
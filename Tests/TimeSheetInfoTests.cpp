@@ -0,0 +1,203 @@
+/*
+  TimeSheetInfoTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "TimeSheetInfoTests.h"
+#include "Charm/Reports/TaskPivot.h"
+#include "Charm/Reports/TimesheetInfo.h"
+
+#include "Core/CharmDataModel.h"
+#include "Core/CharmDataModelSnapshot.h"
+
+#include <QtTest/QtTest>
+
+namespace {
+    //  1
+    //  +- 2
+    //  |  +- 4
+    //  +- 3
+    //  5
+    TaskList smallTree()
+    {
+        return TaskList()
+            << Task( 1, QStringLiteral("One") )
+            << Task( 3, QStringLiteral("Three"), 1 )
+            << Task( 2, QStringLiteral("Two"), 1 )
+            << Task( 4, QStringLiteral("Four"), 2 )
+            << Task( 5, QStringLiteral("Five") );
+    }
+
+    SecondsMap smallTreeSeconds()
+    {
+        SecondsMap seconds;
+        seconds[4] = QVector<int>() << 60 << 120;
+        seconds[3] = QVector<int>() << 0 << 0;
+        seconds[1] = QVector<int>() << 0 << 30;
+        return seconds;
+    }
+
+    Event makeEvent( EventId id, TaskId task, const QDate& day, int seconds )
+    {
+        Event event;
+        event.setId( id );
+        event.setTaskId( task );
+        const QDateTime start( day, QTime( 10, 0 ) );
+        event.setStartDateTime( start );
+        event.setEndDateTime( start.addSecs( seconds ) );
+        return event;
+    }
+
+    // the own seconds of the tasks in the rows of the pivot:
+    SecondsMap pivotSeconds( const TaskPivot& pivot )
+    {
+        SecondsMap seconds;
+        for ( int row = 0; row < pivot.rowCount(); ++row ) {
+            QVector<int>& cells = seconds[pivot.taskId( row )];
+            for ( int column = 0; column < pivot.columnCount(); ++column )
+                cells << pivot.seconds( row, column );
+        }
+        return seconds;
+    }
+
+    TaskIdList taskIds( const TimeSheetInfoList& infos )
+    {
+        TaskIdList ids;
+        Q_FOREACH( const TimeSheetInfo& info, infos )
+            ids << info.taskId;
+        return ids;
+    }
+}
+
+void TimeSheetInfoTests::testTaskWithSubTasks()
+{
+    CharmDataModel model;
+    model.setAllTasks( smallTree() );
+
+    const TimeSheetInfoList infos = TimeSheetInfo::taskWithSubTasks( model.snapshot(), 2, 0, smallTreeSeconds(), false );
+    // depth first, sorted by task id, the root item first:
+    QCOMPARE( taskIds( infos ), TaskIdList() << 0 << 1 << 2 << 4 << 3 << 5 );
+    QCOMPARE( infos[0].indentation, -1 );
+    QCOMPARE( infos[0].seconds, QVector<int>() << 60 << 150 );
+    QCOMPARE( infos[1].indentation, 0 );
+    QCOMPARE( infos[1].taskName, QStringLiteral("One") );
+    QCOMPARE( infos[1].seconds, QVector<int>() << 60 << 150 );
+    QVERIFY( infos[1].aggregated );
+    QCOMPARE( infos[2].seconds, QVector<int>() << 60 << 120 );
+    QCOMPARE( infos[3].indentation, 2 );
+    QVERIFY( ! infos[3].aggregated );
+    QCOMPARE( infos[5].seconds, QVector<int>() << 0 << 0 );
+
+    const TimeSheetInfoList subtree = TimeSheetInfo::taskWithSubTasks( model.snapshot(), 2, 2, smallTreeSeconds(), false );
+    QCOMPARE( taskIds( subtree ), TaskIdList() << 2 << 4 );
+    QCOMPARE( subtree[0].indentation, 0 );
+    QCOMPARE( subtree[0].taskName, QStringLiteral("Two") );
+}
+
+void TimeSheetInfoTests::testActiveTasksOnly()
+{
+    CharmDataModel model;
+    model.setAllTasks( smallTree() );
+
+    // tasks without time are left out, also when they are in the seconds map:
+    const TimeSheetInfoList infos = TimeSheetInfo::taskWithSubTasks( model.snapshot(), 2, 0, smallTreeSeconds(), true );
+    QCOMPARE( taskIds( infos ), TaskIdList() << 0 << 1 << 2 << 4 );
+    QCOMPARE( infos[1].seconds, QVector<int>() << 60 << 150 );
+    QVERIFY( infos[1].aggregated );
+    QCOMPARE( infos[3].indentation, 2 );
+
+    const TimeSheetInfoList subtree = TimeSheetInfo::taskWithSubTasks( model.snapshot(), 2, 5, smallTreeSeconds(), true );
+    QVERIFY( subtree.isEmpty() );
+    QVERIFY( TimeSheetInfo::taskWithSubTasks( model.snapshot(), 2, 0, SecondsMap(), true ).isEmpty() );
+}
+
+void TimeSheetInfoTests::testFromPivot()
+{
+    const QDate monday( 2016, 5, 2 );
+    CharmDataModel model;
+    model.setAllTasks( smallTree() );
+    model.setAllEvents( EventList()
+                        << makeEvent( 1, 4, monday, 60 )
+                        << makeEvent( 2, 4, monday.addDays( 1 ), 120 )
+                        << makeEvent( 3, 1, monday.addDays( 1 ), 30 )
+                        << makeEvent( 4, 5, monday.addDays( 2 ), 600 ) ); // after the two days
+    const CharmDataModelSnapshot snapshot = model.snapshot();
+
+    // the rows of the pivot give the same list as their seconds:
+    Q_FOREACH( TaskId root, TaskIdList() << 0 << 1 << 2 << 5 ) {
+        TaskPivot pivot( TaskPivot::Buckets::days( monday, monday.addDays( 2 ) ) );
+        pivot.setRootTask( root );
+        pivot.compute( snapshot );
+        Q_FOREACH( bool activeTasksOnly, QList<bool>() << false << true ) {
+            const TimeSheetInfoList expected = TimeSheetInfo::taskWithSubTasks( snapshot, 2, root, pivotSeconds( pivot ), activeTasksOnly );
+            const TimeSheetInfoList infos = TimeSheetInfo::fromPivot( snapshot, pivot, activeTasksOnly );
+            QCOMPARE( taskIds( infos ), taskIds( expected ) );
+            for ( int i = 0; i < infos.size(); ++i ) {
+                QCOMPARE( infos[i].seconds, expected[i].seconds );
+                QCOMPARE( infos[i].indentation, expected[i].indentation );
+                QCOMPARE( infos[i].taskName, expected[i].taskName );
+                QCOMPARE( infos[i].aggregated, expected[i].aggregated );
+            }
+        }
+    }
+}
+
+void TimeSheetInfoTests::testTaskWithSubTasksBenchmark()
+{
+    // 20 top level tasks with 10 subtasks of 100 tasks each:
+    TaskList tasks;
+    TaskId id = 0;
+    for ( int i = 0; i < 20; ++i ) {
+        const TaskId topLevel = ++id;
+        tasks << Task( topLevel, QStringLiteral("Top level") );
+        for ( int j = 0; j < 10; ++j ) {
+            const TaskId subTask = ++id;
+            tasks << Task( subTask, QStringLiteral("Subtask"), topLevel );
+            for ( int k = 0; k < 100; ++k )
+                tasks << Task( ++id, QStringLiteral("Leaf"), subTask );
+        }
+    }
+    CharmDataModel model;
+    model.setAllTasks( tasks );
+
+    // a week with an hour every day on 30 of them:
+    const QDate monday( 2016, 5, 2 );
+    EventList events;
+    for ( int i = 0; i < 30; ++i ) {
+        for ( int day = 0; day < 7; ++day )
+            events << makeEvent( events.size() + 1, tasks[i * 673 % tasks.size()].id(), monday.addDays( day ), 3600 );
+    }
+    model.setAllEvents( events );
+    const CharmDataModelSnapshot snapshot = model.snapshot();
+
+    // what the time sheets do on the worker thread:
+    TimeSheetInfoList infos;
+    QBENCHMARK {
+        TaskPivot pivot( TaskPivot::Buckets::days( monday, monday.addDays( 7 ) ) );
+        pivot.compute( snapshot );
+        infos = TimeSheetInfo::fromPivot( snapshot, pivot, true );
+    }
+    QVERIFY( ! infos.isEmpty() );
+    QCOMPARE( infos.first().total(), 30 * 7 * 3600 );
+}
+
+QTEST_MAIN( TimeSheetInfoTests )
+
+#include "moc_TimeSheetInfoTests.cpp"
@@ -0,0 +1,304 @@
+/*
+  TimesheetXmlTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "TimesheetXmlTests.h"
+#include "Charm/Reports/MonthlyTimesheetXmlWriter.h"
+#include "Charm/Reports/TimesheetXml.h"
+#include "Charm/Reports/WeeklyTimesheetXmlWriter.h"
+#include "CharmCMake.h"
+
+#include "Core/CharmConstants.h"
+#include "Core/CharmDataModel.h"
+#include "Core/XmlSerialization.h"
+
+#include <QDomDocument>
+#include <QXmlStreamWriter>
+#include <QtTest/QtTest>
+
+#include <algorithm>
+
+namespace {
+    //  1
+    //  +- 2
+    //  3
+    TaskList tasks()
+    {
+        return TaskList()
+            << Task( 1, QStringLiteral("One") )
+            << Task( 2, QStringLiteral("Two & <Three>"), 1 )
+            << Task( 3, QStringLiteral("Three") );
+    }
+
+    Event event( EventId id, TaskId task, const QDateTime& start, int seconds, const QString& comment = QString() )
+    {
+        Event event;
+        event.setId( id );
+        event.setTaskId( task );
+        event.setStartDateTime( start );
+        event.setEndDateTime( start.addSecs( seconds ) );
+        event.setComment( comment );
+        return event;
+    }
+
+    // the attribute order of QDom is not deterministic, so compare
+    // elements in a normalized form:
+    QString canonical( const QDomElement& element )
+    {
+        QStringList attributes;
+        const QDomNamedNodeMap attributeMap = element.attributes();
+        for ( int i = 0; i < attributeMap.count(); ++i ) {
+            const QDomAttr attribute = attributeMap.item( i ).toAttr();
+            attributes << attribute.name() + QLatin1Char('=') + attribute.value();
+        }
+        std::sort( attributes.begin(), attributes.end() );
+        return element.tagName() + QLatin1Char('[') + attributes.join( QLatin1Char(',') )
+            + QLatin1String("]") + element.text();
+    }
+
+    QStringList canonicalChildren( const QDomElement& element )
+    {
+        QStringList children;
+        for ( QDomElement child = element.firstChildElement(); ! child.isNull(); child = child.nextSiblingElement() )
+            children << canonical( child );
+        return children;
+    }
+
+    // the whole document, in document order, without the creation time (which differs between two runs):
+    QStringList canonicalTree( const QDomElement& element, const QString& indent = QString() )
+    {
+        if ( element.firstChildElement().isNull() ) {
+            if ( element.tagName() == QLatin1String("creation-time") )
+                return QStringList() << indent + element.tagName();
+            return QStringList() << indent + canonical( element );
+        }
+        QStringList lines = QStringList() << indent + canonical( element.cloneNode( false ).toElement() );
+        for ( QDomElement child = element.firstChildElement(); ! child.isNull(); child = child.nextSiblingElement() )
+            lines << canonicalTree( child, indent + QLatin1String("  ") );
+        return lines;
+    }
+
+    QStringList canonicalDocument( const QByteArray& data )
+    {
+        QDomDocument document;
+        if ( ! document.setContent( data ) )
+            return QStringList();
+        return QStringList() << QStringLiteral("DOCTYPE ") + document.doctype().name()
+                             << canonicalTree( document.documentElement() );
+    }
+
+    EventList events( const QDate& monday )
+    {
+        const QDate tuesday = monday.addDays( 1 );
+        return EventList()
+            << event( 10, 2, QDateTime( monday, QTime( 9, 0 ) ), 3600, QStringLiteral("first") )
+            << event( 11, 1, QDateTime( monday, QTime( 11, 0 ) ), 1800 )
+            << event( 12, 3, QDateTime( monday, QTime( 12, 0 ) ), 600, QStringLiteral("not in the subtree") )
+            << event( 13, 2, QDateTime( tuesday, QTime( 8, 0 ) ), 600 )
+            << event( 14, 2, QDateTime( monday, QTime( 14, 0 ) ), 900 )
+            << event( 15, 2, QDateTime( monday, QTime( 16, 0 ) ), 300, QStringLiteral("Fish & <Chips>") );
+    }
+
+    // what the QDom based weekly and monthly writers wrote before they were
+    // changed to stream the document, as the reference for the new writers:
+    QByteArray domTimesheet( const CharmDataModel& model, const QString& docClass, int year,
+                             const QString& semantics, int serialNumber, int segments,
+                             TaskId rootTask, const EventList& events )
+    {
+        QDomDocument document = XmlSerialization::createXmlTemplate( docClass, QStringLiteral("Jane Doe") );
+        QDomElement metadata = XmlSerialization::metadataElement( document );
+        QDomElement report = XmlSerialization::reportElement( document );
+        const auto appendTextElement = [&]( const QString& tagName, const QString& text ) {
+            QDomElement element = document.createElement( tagName );
+            element.appendChild( document.createTextNode( text ) );
+            metadata.appendChild( element );
+            return element;
+        };
+        appendTextElement( QStringLiteral("charmversion"), QStringLiteral(CHARM_VERSION) );
+        appendTextElement( QStringLiteral("year"), QString::number( year ) );
+        appendTextElement( QStringLiteral("serial-number"), QString::number( serialNumber ) )
+            .setAttribute( QStringLiteral("semantics"), semantics );
+
+        const TimeSheetInfoList timeSheetInfo = TimeSheetInfo::taskWithSubTasks( model.snapshot(), segments, rootTask, SecondsMap(), false );
+        QDomElement tasks = document.createElement( QStringLiteral("tasks") );
+        report.appendChild( tasks );
+        Q_FOREACH ( const TimeSheetInfo& info, timeSheetInfo ) {
+            if ( info.taskId == 0 ) // the root task
+                continue;
+            tasks.appendChild( model.getTask( info.taskId ).toXml( document ) );
+        }
+
+        QDomElement effort = document.createElement( QStringLiteral("effort") );
+        report.appendChild( effort );
+        typedef QPair<TaskId, QDate> Key;
+        QMap<Key, Event> aggregated;
+        Q_FOREACH ( const Event& event, events ) {
+            bool inTimeSheet = false;
+            Q_FOREACH ( const TimeSheetInfo& info, timeSheetInfo )
+                inTimeSheet = inTimeSheet || info.taskId == event.taskId();
+            if ( ! inTimeSheet )
+                continue;
+            const Key key( event.taskId(), event.startDateTime().date() );
+            if ( aggregated.contains( key ) ) {
+                Event& previous = aggregated[key];
+                previous.setEndDateTime( previous.startDateTime().addSecs( previous.duration() + event.duration() ) );
+                if ( ! event.comment().isEmpty() ) {
+                    if ( previous.comment().isEmpty() )
+                        previous.setComment( event.comment() );
+                    else
+                        previous.setComment( previous.comment() + QLatin1String(" / ") + event.comment() );
+                }
+            } else {
+                Event synthetic( event );
+                synthetic.setId( -event.id() );
+                const QDateTime start( key.second, QTime( 0, 0, 0, 0 ), Qt::UTC );
+                synthetic.setStartDateTime( start );
+                synthetic.setEndDateTime( start.addSecs( event.duration() ) );
+                aggregated.insert( key, synthetic );
+            }
+        }
+        Q_FOREACH ( const Event& event, aggregated )
+            effort.appendChild( event.toXml( document ) );
+
+        return document.toByteArray( 4 );
+    }
+
+    void verifyDocument( const QByteArray& data, const QByteArray& reference )
+    {
+        // no XML declaration, the DOCTYPE comes first:
+        QVERIFY( data.trimmed().startsWith( "<!DOCTYPE charmreport>" ) );
+        QVERIFY( reference.trimmed().startsWith( "<!DOCTYPE charmreport>" ) );
+
+        const QStringList expected = canonicalDocument( reference );
+        QVERIFY( expected.size() > 10 );
+        QCOMPARE( canonicalDocument( data ), expected );
+    }
+
+    template<typename Writer>
+    QDomElement writeAndParse( Writer write )
+    {
+        QByteArray data;
+        QXmlStreamWriter writer( &data );
+        writer.writeStartDocument();
+        writer.writeStartElement( QStringLiteral("report") );
+        write( writer );
+        writer.writeEndDocument();
+
+        QDomDocument document;
+        if ( ! document.setContent( data ) )
+            return QDomElement();
+        return document.documentElement().firstChildElement();
+    }
+}
+
+void TimesheetXmlTests::testWriteTasks()
+{
+    CharmDataModel model;
+    model.setAllTasks( tasks() );
+    const TimeSheetInfoList infos = TimeSheetInfo::taskWithSubTasks( model.snapshot(), 7, 0, SecondsMap(), false );
+
+    const QDomElement element = writeAndParse( [&]( QXmlStreamWriter& writer ) {
+        TimesheetXml::writeTasks( writer, model.snapshot(), infos );
+    } );
+    QCOMPARE( element.tagName(), QStringLiteral("tasks") );
+
+    // the same elements as written by Task::toXml( QDomDocument ), without the root item:
+    QDomDocument reference;
+    QStringList expected;
+    Q_FOREACH( TaskId id, TaskIdList() << 1 << 2 << 3 )
+        expected << canonical( model.getTask( id ).toXml( reference ) );
+    QCOMPARE( canonicalChildren( element ), expected );
+}
+
+void TimesheetXmlTests::testWriteEffort()
+{
+    CharmDataModel model;
+    model.setAllTasks( tasks() );
+    const TimeSheetInfoList infos = TimeSheetInfo::taskWithSubTasks( model.snapshot(), 7, 1, SecondsMap(), false );
+
+    const QDate monday( 2026, 3, 2 );
+    const QDate tuesday = monday.addDays( 1 );
+
+    const QDomElement element = writeAndParse( [&]( QXmlStreamWriter& writer ) {
+        TimesheetXml::writeEffort( writer, infos, events( monday ) );
+    } );
+    QCOMPARE( element.tagName(), QStringLiteral("effort") );
+
+    // one synthetic event per task and day, starting at midnight UTC, in the order of task and day:
+    const QDateTime mondayUtc( monday, QTime( 0, 0 ), Qt::UTC );
+    const QDateTime tuesdayUtc( tuesday, QTime( 0, 0 ), Qt::UTC );
+    QDomDocument reference;
+    const QStringList expected = QStringList()
+        << canonical( event( -11, 1, mondayUtc, 1800 ).toXml( reference ) )
+        << canonical( event( -10, 2, mondayUtc, 4800, QStringLiteral("first / Fish & <Chips>") ).toXml( reference ) )
+        << canonical( event( -13, 2, tuesdayUtc, 600 ).toXml( reference ) );
+    QCOMPARE( canonicalChildren( element ), expected );
+
+    const QDomElement empty = writeAndParse( [&]( QXmlStreamWriter& writer ) {
+        TimesheetXml::writeEffort( writer, infos, EventList() );
+    } );
+    QCOMPARE( empty.tagName(), QStringLiteral("effort") );
+    QVERIFY( empty.firstChildElement().isNull() );
+}
+
+void TimesheetXmlTests::testWeeklyDocument()
+{
+    CharmDataModel model;
+    model.setAllTasks( tasks() );
+    const EventList weekEvents = events( QDate( 2026, 3, 2 ) );
+
+    WeeklyTimesheetXmlWriter timesheet;
+    timesheet.setSnapshot( model.snapshot() );
+    timesheet.setUserName( QStringLiteral("Jane Doe") );
+    timesheet.setYear( 2026 );
+    timesheet.setWeekNumber( 10 );
+    timesheet.setRootTask( 1 );
+    timesheet.setEvents( weekEvents );
+
+    verifyDocument( timesheet.saveToXml(),
+                    domTimesheet( model, QStringLiteral("weekly-timesheet"), 2026, QStringLiteral("week-number"), 10,
+                                  7, 1, weekEvents ) );
+}
+
+void TimesheetXmlTests::testMonthlyDocument()
+{
+    CharmDataModel model;
+    model.setAllTasks( tasks() );
+    const EventList monthEvents = events( QDate( 2026, 3, 2 ) ) + events( QDate( 2026, 3, 23 ) );
+
+    MonthlyTimesheetXmlWriter timesheet;
+    timesheet.setSnapshot( model.snapshot() );
+    timesheet.setUserName( QStringLiteral("Jane Doe") );
+    timesheet.setYearOfMonth( 2026 );
+    timesheet.setMonthNumber( 3 );
+    timesheet.setNumberOfWeeks( 5 );
+    timesheet.setRootTask( 0 );
+    timesheet.setEvents( monthEvents );
+
+    verifyDocument( timesheet.saveToXml(),
+                    domTimesheet( model, QStringLiteral("monthly-timesheet"), 2026, QStringLiteral("month-number"), 3,
+                                  5, 0, monthEvents ) );
+}
+
+QTEST_MAIN( TimesheetXmlTests )
+
+#include "moc_TimesheetXmlTests.cpp"
@@ -0,0 +1,216 @@
+/*
+  UploadTimesheetJobTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "UploadTimesheetJobTests.h"
+#include "Charm/HttpClient/UploadTimesheetJob.h"
+
+#include <QPointer>
+#include <QRegularExpression>
+#include <QSet>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtTest/QtTest>
+
+#include <algorithm>
+
+namespace {
+    // A minimal stand-in for the portal: the login redirects, uploads are
+    // answered after a short delay so that they overlap.
+    class PortalServer : public QObject
+    {
+    public:
+        PortalServer()
+        {
+            m_server.listen( QHostAddress::LocalHost );
+            connect( &m_server, &QTcpServer::newConnection, this, [this]() {
+                while ( QTcpSocket* socket = m_server.nextPendingConnection() ) {
+                    connect( socket, &QTcpSocket::readyRead, this, [this, socket]() { read( socket ); } );
+                    connect( socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater );
+                }
+            } );
+        }
+
+        QUrl url( const QString& path ) const
+        {
+            return QUrl( QStringLiteral("http://127.0.0.1:%1%2").arg( m_server.serverPort() ).arg( path ) );
+        }
+
+        // answer the first attempt with 503:
+        QSet<QString> failOnce;
+        // answer with an error message:
+        QSet<QString> reject;
+        QHash<QString, int> attempts;
+        QStringList accepted;
+        int running = 0;
+        int maximumRunning = 0;
+
+    private:
+        void read( QTcpSocket* socket )
+        {
+            QByteArray& buffer = m_buffers[socket];
+            buffer += socket->readAll();
+            const int headerEnd = buffer.indexOf( "\r\n\r\n" );
+            if ( headerEnd < 0 )
+                return;
+            const QString header = QString::fromLatin1( buffer.left( headerEnd ) );
+            const QRegularExpression contentLength( QStringLiteral("content-length:\\s*(\\d+)"), QRegularExpression::CaseInsensitiveOption );
+            const QRegularExpressionMatch match = contentLength.match( header );
+            const int length = match.hasMatch() ? match.captured( 1 ).toInt() : 0;
+            if ( buffer.size() < headerEnd + 4 + length )
+                return;
+            const QByteArray body = buffer.mid( headerEnd + 4, length );
+            m_buffers.remove( socket );
+            const QString path = header.section( QLatin1Char('\r'), 0, 0 ).section( QLatin1Char(' '), 1, 1 );
+            respond( socket, path, body );
+        }
+
+        void respond( QTcpSocket* socket, const QString& path, const QByteArray& body )
+        {
+            if ( path == QLatin1String("/portal") ) {
+                write( socket, "200 OK", QByteArray() );
+            } else if ( path == QLatin1String("/login") ) {
+                write( socket, "302 Found", QByteArray(), "Location: " + url( QStringLiteral("/portal") ).toEncoded() + "\r\n" );
+            } else {
+                const QRegularExpression fileNameExpression( QStringLiteral("filename=\"([^\"]+)\"") );
+                const QString fileName = fileNameExpression.match( QString::fromUtf8( body ) ).captured( 1 );
+                const int attempt = ++attempts[fileName];
+                maximumRunning = qMax( maximumRunning, ++running );
+                const QPointer<QTcpSocket> connection( socket );
+                QTimer::singleShot( 50, this, [this, connection, fileName, attempt]() {
+                    --running;
+                    if ( ! connection )
+                        return;
+                    if ( failOnce.contains( fileName ) && attempt == 1 ) {
+                        write( connection, "503 Service Unavailable", "busy" );
+                    } else if ( reject.contains( fileName ) ) {
+                        write( connection, "200 OK", "<html><div class=\"ErrorResultMessage\">rejected</div></html>" );
+                    } else {
+                        accepted << fileName;
+                        write( connection, "200 OK", "<html><div class=\"SuccessResultMessage\">ok</div></html>" );
+                    }
+                } );
+            }
+        }
+
+        static void write( QTcpSocket* socket, const QByteArray& status, const QByteArray& body,
+                           const QByteArray& headers = QByteArray() )
+        {
+            socket->write( "HTTP/1.1 " + status + "\r\n"
+                           "Content-Length: " + QByteArray::number( body.size() ) + "\r\n"
+                           + headers + "Connection: close\r\n\r\n" + body );
+            socket->disconnectFromHost();
+        }
+
+        QTcpServer m_server;
+        QHash<QTcpSocket*, QByteArray> m_buffers;
+    };
+
+    struct Result {
+        int error = -1;
+        QString errorString;
+        QList<int> uploaded;
+    };
+
+    UploadTimesheetJob* createJob( const PortalServer& server, Result* result )
+    {
+        auto job = new UploadTimesheetJob;
+        job->setUsername( QStringLiteral("tester") );
+        // set on the job, so the keychain is not used:
+        job->setPassword( QStringLiteral("secret") );
+        job->setPortalUrl( server.url( QStringLiteral("/portal") ) );
+        job->setLoginUrl( server.url( QStringLiteral("/login") ) );
+        job->setUploadUrl( server.url( QStringLiteral("/upload") ) );
+        job->setRetryDelay( 10 );
+        QObject::connect( job, &UploadTimesheetJob::timesheetUploaded, [result]( int index ) {
+            result->uploaded << index;
+        } );
+        QObject::connect( job, &HttpJob::finished, [result]( HttpJob* finished ) {
+            result->error = finished->error();
+            result->errorString = finished->errorString();
+        } );
+        return job;
+    }
+
+    bool run( UploadTimesheetJob* job )
+    {
+        QSignalSpy finished( job, SIGNAL(finished(HttpJob*)) );
+        job->start();
+        return finished.wait( 10000 );
+    }
+}
+
+void UploadTimesheetJobTests::testSingleUpload()
+{
+    PortalServer server;
+    Result result;
+    UploadTimesheetJob* job = createJob( server, &result );
+    job->setFileName( QStringLiteral("WeeklyTimeSheet-2026-10") );
+    job->setPayload( "<weekly-timesheet/>" );
+    QVERIFY( run( job ) );
+
+    QCOMPARE( result.error, int( HttpJob::NoError ) );
+    QCOMPARE( result.uploaded, QList<int>() << 0 );
+    QCOMPARE( server.accepted, QStringList() << QStringLiteral("WeeklyTimeSheet-2026-10") );
+}
+
+void UploadTimesheetJobTests::testConcurrentUploadsWithRetry()
+{
+    PortalServer server;
+    server.failOnce << QStringLiteral("WeeklyTimeSheet-2026-02");
+    Result result;
+    UploadTimesheetJob* job = createJob( server, &result );
+    job->setMaximumConcurrentUploads( 2 );
+    for ( int week = 1; week <= 5; ++week )
+        QCOMPARE( job->addUpload( QStringLiteral("WeeklyTimeSheet-2026-%1").arg( week, 2, 10, QLatin1Char('0') ), "<weekly-timesheet/>" ), week - 1 );
+    QVERIFY( run( job ) );
+
+    QCOMPARE( result.error, int( HttpJob::NoError ) );
+    std::sort( result.uploaded.begin(), result.uploaded.end() );
+    QCOMPARE( result.uploaded, QList<int>() << 0 << 1 << 2 << 3 << 4 );
+    QCOMPARE( server.accepted.size(), 5 );
+    QCOMPARE( server.attempts.value( QStringLiteral("WeeklyTimeSheet-2026-02") ), 2 );
+    QCOMPARE( server.attempts.value( QStringLiteral("WeeklyTimeSheet-2026-03") ), 1 );
+    QCOMPARE( server.maximumRunning, 2 );
+}
+
+void UploadTimesheetJobTests::testRejectedUpload()
+{
+    PortalServer server;
+    server.reject << QStringLiteral("WeeklyTimeSheet-2026-02");
+    Result result;
+    UploadTimesheetJob* job = createJob( server, &result );
+    for ( int week = 1; week <= 3; ++week )
+        job->addUpload( QStringLiteral("WeeklyTimeSheet-2026-%1").arg( week, 2, 10, QLatin1Char('0') ), "<weekly-timesheet/>" );
+    QVERIFY( run( job ) );
+
+    // a rejected time sheet is not retried, the others are still uploaded:
+    QCOMPARE( result.error, int( HttpJob::SomethingWentWrong ) );
+    QVERIFY( result.errorString.contains( QStringLiteral("WeeklyTimeSheet-2026-02: rejected") ) );
+    QCOMPARE( server.attempts.value( QStringLiteral("WeeklyTimeSheet-2026-02") ), 1 );
+    std::sort( result.uploaded.begin(), result.uploaded.end() );
+    QCOMPARE( result.uploaded, QList<int>() << 0 << 2 );
+}
+
+QTEST_MAIN( UploadTimesheetJobTests )
+
+#include "moc_UploadTimesheetJobTests.cpp"
@@ -0,0 +1,136 @@
+/*
+  WeeklySummaryTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "WeeklySummaryTests.h"
+#include "Charm/WeeklySummary.h"
+
+#include "Core/CharmDataModel.h"
+
+#include <QtTest/QtTest>
+
+namespace {
+    const QDate Monday( 2016, 5, 2 );
+    const TimeSpan Week( Monday, Monday.addDays( 7 ) );
+
+    Event makeEvent( EventId id, TaskId task, const QDate& day, int seconds )
+    {
+        Event event;
+        event.setId( id );
+        event.setTaskId( task );
+        const QDateTime start( day, QTime( 10, 0 ) );
+        event.setStartDateTime( start );
+        event.setEndDateTime( start.addSecs( seconds ) );
+        return event;
+    }
+
+    // what TimeTrackingWindow does for every changed event:
+    void update( QVector<WeeklySummary>& summaries, CharmDataModel* model, const Event& event )
+    {
+        WeeklySummary::updateSummaries( summaries, model, Week, event.taskId(), event.startDateTime().date() );
+    }
+
+    bool sameSummaries( const QVector<WeeklySummary>& actual, const QVector<WeeklySummary>& expected )
+    {
+        if ( actual.size() != expected.size() ) {
+            qWarning() << "Got" << actual.size() << "summaries, expected" << expected.size();
+            return false;
+        }
+        for ( int i = 0; i < actual.size(); ++i ) {
+            if ( actual[i].task != expected[i].task
+                 || actual[i].taskname != expected[i].taskname
+                 || actual[i].durations != expected[i].durations ) {
+                qWarning() << "Summary" << i << ": task" << actual[i].task << actual[i].durations
+                           << "expected task" << expected[i].task << expected[i].durations;
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void WeeklySummaryTests::testIncrementalUpdates()
+{
+    CharmDataModel model;
+    model.setAllTasks( TaskList() << Task( 1, QStringLiteral("One") )
+                                  << Task( 2, QStringLiteral("Two"), 1 )
+                                  << Task( 3, QStringLiteral("Three") ) );
+    model.setAllEvents( EventList() << makeEvent( 1, 2, Monday, 3600 )
+                                    << makeEvent( 2, 3, Monday.addDays( 2 ), 600 ) );
+    QVector<WeeklySummary> summaries = WeeklySummary::summariesForTimespan( &model, Week );
+    QCOMPARE( summaries.size(), 2 );
+
+    // adding an event to a task without events adds a summary:
+    const Event added = makeEvent( 3, 1, Monday.addDays( 1 ), 1800 );
+    model.addEvent( added );
+    QCOMPARE( WeeklySummary::updateSummaries( summaries, &model, Week, added.taskId(), added.startDateTime().date() ),
+              WeeklySummary::RowsChanged );
+    QVERIFY( sameSummaries( summaries, WeeklySummary::summariesForTimespan( &model, Week ) ) );
+
+    // adding one to a task with events changes only that summary:
+    const Event second = makeEvent( 4, 2, Monday, 60 );
+    model.addEvent( second );
+    QCOMPARE( WeeklySummary::updateSummaries( summaries, &model, Week, second.taskId(), second.startDateTime().date() ), 1 );
+    QVERIFY( sameSummaries( summaries, WeeklySummary::summariesForTimespan( &model, Week ) ) );
+
+    // events outside of the week are ignored:
+    const Event nextWeek = makeEvent( 5, 3, Monday.addDays( 7 ), 60 );
+    model.addEvent( nextWeek );
+    QCOMPARE( WeeklySummary::updateSummaries( summaries, &model, Week, nextWeek.taskId(), nextWeek.startDateTime().date() ),
+              WeeklySummary::NoChange );
+    QVERIFY( sameSummaries( summaries, WeeklySummary::summariesForTimespan( &model, Week ) ) );
+
+    // a modified event updates the old and the new cell, here
+    // it moves to another day and another task:
+    Event modified = model.eventForId( 1 );
+    const Event old = modified;
+    modified.setTaskId( 3 );
+    modified.setStartDateTime( QDateTime( Monday.addDays( 4 ), QTime( 9, 0 ) ) );
+    modified.setEndDateTime( QDateTime( Monday.addDays( 4 ), QTime( 11, 0 ) ) );
+    model.modifyEvent( modified );
+    update( summaries, &model, old );
+    update( summaries, &model, modified );
+    QVERIFY( sameSummaries( summaries, WeeklySummary::summariesForTimespan( &model, Week ) ) );
+
+    // only the duration changes:
+    Event longer = model.eventForId( 2 );
+    longer.setEndDateTime( longer.endDateTime().addSecs( 900 ) );
+    model.modifyEvent( longer );
+    update( summaries, &model, longer );
+    QVERIFY( sameSummaries( summaries, WeeklySummary::summariesForTimespan( &model, Week ) ) );
+
+    // deleting the last event of a task removes its summary:
+    const Event deleted = model.eventForId( 3 );
+    model.deleteEvent( deleted );
+    QCOMPARE( WeeklySummary::updateSummaries( summaries, &model, Week, deleted.taskId(), deleted.startDateTime().date() ),
+              WeeklySummary::RowsChanged );
+    QVERIFY( sameSummaries( summaries, WeeklySummary::summariesForTimespan( &model, Week ) ) );
+
+    // and deleting one of several keeps it:
+    const Event deletedSecond = model.eventForId( 2 );
+    model.deleteEvent( deletedSecond );
+    update( summaries, &model, deletedSecond );
+    QVERIFY( sameSummaries( summaries, WeeklySummary::summariesForTimespan( &model, Week ) ) );
+    QCOMPARE( summaries.size(), 2 );
+}
+
+QTEST_MAIN( WeeklySummaryTests )
+
+#include "moc_WeeklySummaryTests.cpp"
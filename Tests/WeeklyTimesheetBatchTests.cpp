@@ -0,0 +1,105 @@
+/*
+  WeeklyTimesheetBatchTests.cpp
+
+  This file is part of Charm, a task-based time tracking application.
+
+  Copyright (C) 2026 Klarälvdalens Datakonsult AB, a KDAB Group company, info@kdab.com
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "WeeklyTimesheetBatchTests.h"
+#include "Charm/Reports/WeeklyTimesheetBatch.h"
+
+#include "Core/CharmDataModel.h"
+
+#include <QDomDocument>
+#include <QtTest/QtTest>
+
+namespace {
+    Event event( EventId id, TaskId task, const QDateTime& start, int seconds )
+    {
+        Event event;
+        event.setId( id );
+        event.setTaskId( task );
+        event.setStartDateTime( start );
+        event.setEndDateTime( start.addSecs( seconds ) );
+        return event;
+    }
+
+    QDomDocument parse( const QByteArray& data )
+    {
+        QDomDocument document;
+        document.setContent( data );
+        return document;
+    }
+
+    int effortEvents( const QDomDocument& document )
+    {
+        const QDomElement effort = document.elementsByTagName( QStringLiteral("effort") ).item( 0 ).toElement();
+        return effort.elementsByTagName( QStringLiteral("event") ).count();
+    }
+}
+
+void WeeklyTimesheetBatchTests::testFileName()
+{
+    QCOMPARE( WeeklyTimesheetBatch::fileName( 2026, 3 ), QStringLiteral("WeeklyTimeSheet-2026-03") );
+    QCOMPARE( WeeklyTimesheetBatch::fileName( 2025, 52 ), QStringLiteral("WeeklyTimeSheet-2025-52") );
+}
+
+void WeeklyTimesheetBatchTests::testGenerate()
+{
+    CharmDataModel model;
+    model.setAllTasks( TaskList()
+                       << Task( 1, QStringLiteral("One") )
+                       << Task( 2, QStringLiteral("Two"), 1 ) );
+    const QDate week10( 2026, 3, 2 ); // Monday of week 10
+    const QDate week11 = week10.addDays( 7 );
+    const QDate week12 = week10.addDays( 14 );
+    model.setAllEvents( EventList()
+                        << event( 1, 1, QDateTime( week10, QTime( 9, 0 ) ), 3600 )
+                        << event( 2, 2, QDateTime( week10.addDays( 1 ), QTime( 9, 0 ) ), 3600 )
+                        << event( 3, 2, QDateTime( week11, QTime( 9, 0 ) ), 3600 )
+                        << event( 4, 1, QDateTime( week12.addDays( 6 ), QTime( 9, 0 ) ), 3600 ) );
+
+    WeeksByYear weeks;
+    weeks[2026] << 12 << 10;
+    weeks[2025] << 52;
+    const WeeklyTimesheetUploadList uploads = WeeklyTimesheetBatch::generate( model.snapshot(), QStringLiteral("Jane Doe"), 0, weeks );
+
+    // sorted by year and week, week 11 is not requested:
+    QCOMPARE( uploads.size(), 3 );
+    QCOMPARE( uploads[0].fileName, QStringLiteral("WeeklyTimeSheet-2025-52") );
+    QCOMPARE( uploads[1].fileName, QStringLiteral("WeeklyTimeSheet-2026-10") );
+    QCOMPARE( uploads[2].fileName, QStringLiteral("WeeklyTimeSheet-2026-12") );
+    QCOMPARE( uploads[1].year, 2026 );
+    QCOMPARE( uploads[1].week, 10 );
+
+    // every time sheet only contains the effort of its week:
+    const QDomDocument week52Document = parse( uploads[0].payload );
+    const QDomDocument week10Document = parse( uploads[1].payload );
+    const QDomDocument week12Document = parse( uploads[2].payload );
+    QCOMPARE( effortEvents( week52Document ), 0 );
+    QCOMPARE( effortEvents( week10Document ), 2 );
+    QCOMPARE( effortEvents( week12Document ), 1 );
+    QCOMPARE( week10Document.elementsByTagName( QStringLiteral("year") ).item( 0 ).toElement().text(), QStringLiteral("2026") );
+    QCOMPARE( week10Document.elementsByTagName( QStringLiteral("serial-number") ).item( 0 ).toElement().text(), QStringLiteral("10") );
+    // the user name is passed in, the workers do not read the configuration:
+    QCOMPARE( week10Document.elementsByTagName( QStringLiteral("username") ).item( 0 ).toElement().text(), QStringLiteral("Jane Doe") );
+}
+
+QTEST_MAIN( WeeklyTimesheetBatchTests )
+
+#include "moc_WeeklyTimesheetBatchTests.cpp"
@@ -30,6 +30,7 @@
 
 #include "Core/Event.h"
 #include "Core/CharmExceptions.h"
+#include "Core/Configuration.h"
 #include <Core/XmlSerialization.h>
 
 #include "Exceptions.h"
@@ -88,7 +89,7 @@ int main( int argc, char** argv ) {
                 }
             }
             // now create the time sheet:
-            QDomDocument document = XmlSerialization::createXmlTemplate( "weekly-timesheet" );
+            QDomDocument document = XmlSerialization::createXmlTemplate( "weekly-timesheet", Configuration::instance().user.name() );
 
             // find metadata and report element:
             QDomElement root = document.documentElement();